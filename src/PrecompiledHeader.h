@@ -1,6 +1,9 @@
 #pragma once
 
+// Only the windowed build needs the platform and DirectX headers, headless builds compile without them
+#ifdef _WIN32
 #define NOMINMAX // Gets rid of the min max macros in windows.h that was conflicting with chrono::milliseconds::max() in GraphicsSystem.h
 
 #include <windows.h>
-#include <directx\d3dx12.h>
\ No newline at end of file
+#include <directx\d3dx12.h>
+#endif
\ No newline at end of file
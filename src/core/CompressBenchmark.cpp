@@ -0,0 +1,296 @@
+#include "PrecompiledHeader.h"
+#include "core/CompressBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Compress.h"
+#include "helper/OBJ_Optimize.h"
+#include "helper/OBJ_Quantize.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+
+namespace
+{
+  // The generic coder to beat, LZ4 style: a token with literal and match length nibbles,
+  // the literals, then a 16 bit offset back into the output. Greedy with one hash table
+  // probe per position, what fast general purpose compressors do
+  const size_t lzMinMatch = 4;
+  const size_t lzHashBits = 16;
+
+  void lzLength(std::vector<uint8_t>& out, size_t length)
+  {
+    for (; length >= 255; length -= 255)
+      out.push_back(255);
+    out.push_back((uint8_t)length);
+  }
+
+  std::vector<uint8_t> lzCompress(const uint8_t* data, size_t size)
+  {
+    std::vector<uint8_t> out;
+    std::vector<uint32_t> table((size_t)1 << lzHashBits, UINT32_MAX);
+    size_t position = 0, literalStart = 0;
+
+    auto emit = [&](size_t matchLength, size_t offset)
+    {
+      size_t literals = position - literalStart;
+      size_t matchCode = matchLength > 0 ? matchLength - lzMinMatch : 0;
+      out.push_back((uint8_t)(std::min<size_t>(literals, 15) << 4 | std::min<size_t>(matchCode, 15)));
+      if (literals >= 15)
+        lzLength(out, literals - 15);
+      out.insert(out.end(), data + literalStart, data + position);
+      if (matchLength > 0)
+      {
+        out.push_back((uint8_t)offset);
+        out.push_back((uint8_t)(offset >> 8));
+        if (matchCode >= 15)
+          lzLength(out, matchCode - 15);
+      }
+    };
+
+    while (position + lzMinMatch <= size)
+    {
+      uint32_t word;
+      std::memcpy(&word, data + position, 4);
+      uint32_t hash = (word * 2654435761u) >> (32 - lzHashBits);
+      uint32_t candidate = table[hash];
+      table[hash] = (uint32_t)position;
+      if (candidate != UINT32_MAX && position - candidate <= 65535 && std::memcmp(data + candidate, data + position, 4) == 0)
+      {
+        size_t length = lzMinMatch;
+        while (position + length < size && data[candidate + length] == data[position + length])
+          ++length;
+        emit(length, position - candidate);
+        position += length;
+        literalStart = position;
+      }
+      else
+      {
+        ++position;
+      }
+    }
+    // Whatever is left goes out as literals with no match after them
+    position = size;
+    emit(0, 0);
+    return out;
+  }
+
+  bool lzDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t outSize)
+  {
+    const uint8_t* end = data + size;
+    uint8_t* write = out;
+    uint8_t* outEnd = out + outSize;
+    auto length = [&](size_t& value) -> bool
+    {
+      uint8_t byte;
+      do
+      {
+        if (data == end)
+          return false;
+        byte = *data++;
+        value += byte;
+      } while (byte == 255);
+      return true;
+    };
+
+    while (data < end)
+    {
+      uint8_t token = *data++;
+      size_t literals = token >> 4;
+      if (literals == 15 && !length(literals))
+        return false;
+      if ((size_t)(end - data) < literals || (size_t)(outEnd - write) < literals)
+        return false;
+      std::memcpy(write, data, literals);
+      write += literals;
+      data += literals;
+      if (data == end)
+        break;
+
+      if (end - data < 2)
+        return false;
+      size_t offset = data[0] | (size_t)data[1] << 8;
+      data += 2;
+      size_t match = token & 15;
+      if (match == 15 && !length(match))
+        return false;
+      match += lzMinMatch;
+      if (offset == 0 || offset > (size_t)(write - out) || (size_t)(outEnd - write) < match)
+        return false;
+      const uint8_t* from = write - offset;
+      if (offset >= 8 && (size_t)(outEnd - write) >= match + 8)
+      {
+        // Eight bytes at a time, running a little past the match is fine with room after it
+        for (size_t i = 0; i < match; i += 8)
+          std::memcpy(write + i, from + i, 8);
+        write += match;
+      }
+      else
+      {
+        for (size_t i = 0; i < match; ++i)
+          *write++ = from[i];
+      }
+    }
+    return write == outEnd;
+  }
+
+  template <class Function>
+  double bestOf(unsigned int repeats, Function&& function)
+  {
+    double best = 0.0;
+    for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+    {
+      auto start = std::chrono::steady_clock::now();
+      function();
+      double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      if (repeat == 0 || milliseconds < best)
+        best = milliseconds;
+    }
+    return best;
+  }
+
+  // One buffer of one mesh and how objl::compress codes it
+  struct Stream
+  {
+    const void* data;
+    size_t count;
+    size_t elementSize;
+    bool indices;
+  };
+
+  void measure(const Stream& stream, unsigned int repeats, Core::CompressResult& result)
+  {
+    size_t rawBytes = stream.count * stream.elementSize;
+    if (rawBytes == 0)
+      return;
+    const uint8_t* raw = (const uint8_t*)stream.data;
+
+    std::vector<uint8_t> encoded;
+    result.encodeMilliseconds += bestOf(repeats, [&]
+    {
+      encoded = stream.indices ? objl::compress::EncodeIndexBuffer((const unsigned int*)stream.data, stream.count)
+        : objl::compress::EncodeVertexBuffer(stream.data, stream.count, stream.elementSize);
+    });
+
+    std::vector<uint8_t> decoded(rawBytes);
+    bool decodedOk = false;
+    result.decodeMilliseconds += bestOf(repeats, [&]
+    {
+      decodedOk = stream.indices
+        ? objl::compress::DecodeIndexBuffer((unsigned int*)decoded.data(), stream.count, encoded.data(), encoded.size())
+        : objl::compress::DecodeVertexBuffer(decoded.data(), stream.count, stream.elementSize, encoded.data(), encoded.size());
+    });
+    if (!decodedOk || std::memcmp(decoded.data(), raw, rawBytes) != 0)
+      ++result.wrongMeshes;
+    if (!stream.indices)
+    {
+      // The scalar vertex decoder has to agree with the SIMD one
+      std::fill(decoded.begin(), decoded.end(), (uint8_t)0);
+      decodedOk = objl::compress::DecodeVertexBuffer(decoded.data(), stream.count, stream.elementSize, encoded.data(), encoded.size(),
+        objl::scan::Level::Scalar);
+      if (!decodedOk || std::memcmp(decoded.data(), raw, rawBytes) != 0)
+        ++result.wrongMeshes;
+    }
+
+    std::vector<uint8_t> lz = lzCompress(raw, rawBytes);
+    std::fill(decoded.begin(), decoded.end(), (uint8_t)0);
+    bool lzOk = false;
+    result.lzDecodeMilliseconds += bestOf(repeats, [&] { lzOk = lzDecompress(lz.data(), lz.size(), decoded.data(), decoded.size()); });
+    if (!lzOk || std::memcmp(decoded.data(), raw, rawBytes) != 0)
+      ++result.wrongMeshes;
+
+    result.rawBytes += rawBytes;
+    result.codecBytes += encoded.size();
+    result.lzBytes += lz.size();
+    result.codecLzBytes += lzCompress(encoded.data(), encoded.size()).size();
+  }
+}
+
+namespace Core
+{
+  std::vector<CompressResult> RunCompressBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<CompressResult> results;
+
+    objl::Loader loader;
+    if (!LoadObjQuietly(loader, path, out))
+      return results;
+    if (repeats == 0)
+      repeats = 1;
+
+    size_t triangleCount = 0, vertexCount = 0;
+    std::vector<objl::Mesh> optimized;
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+    {
+      objl::Mesh copy = mesh;
+      copy.Indices.resize(copy.Indices.size() - copy.Indices.size() % 3);
+      triangleCount += copy.Indices.size() / 3;
+      vertexCount += copy.Vertices.size();
+      optimized.push_back(copy);
+      objl::optimize::OptimizeMesh(optimized.back());
+    }
+
+    const char* orderNames[] = { "file order", "optimized" };
+    for (int order = 0; order < 2; ++order)
+    {
+      CompressResult indices, vertices, packed;
+      indices.stream = std::string("indices, ") + orderNames[order];
+      vertices.stream = std::string("vertices, ") + orderNames[order];
+      packed.stream = std::string("packed, ") + orderNames[order];
+
+      for (size_t m = 0; m < optimized.size(); ++m)
+      {
+        const objl::Mesh& mesh = order == 0 ? loader.LoadedMeshes[m] : optimized[m];
+        size_t indexCount = mesh.Indices.size() - mesh.Indices.size() % 3;
+        measure({ mesh.Indices.data(), indexCount, sizeof(unsigned int), true }, repeats, indices);
+        measure({ mesh.Vertices.data(), mesh.Vertices.size(), sizeof(objl::Vertex), false }, repeats, vertices);
+        objl::quantize::PackedMesh quantized = objl::quantize::EncodeMesh(mesh);
+        measure({ quantized.Vertices.data(), quantized.Vertices.size(), sizeof(objl::quantize::PackedVertex), false }, repeats, packed);
+      }
+      results.push_back(indices);
+      results.push_back(vertices);
+      results.push_back(packed);
+    }
+
+    for (CompressResult& result : results)
+    {
+      double seconds = result.decodeMilliseconds / 1000.0;
+      result.underDecodeTarget = seconds > 0.0 && result.rawBytes / seconds < objl::compress::DecodeTargetBytesPerSecond;
+    }
+
+    if (out)
+    {
+      *out << path << ": " << loader.LoadedMeshes.size() << " meshes, " << triangleCount << " triangles, " << vertexCount
+        << " welded vertices, packed vertices are " << sizeof(objl::quantize::PackedVertex) << " bytes" << std::endl;
+      *out << "stream\t\t\tMB\tcodec\tlz\tcodec+lz\tencode MB/s\tdecode GB/s\tlz GB/s\twrong" << std::endl;
+      for (const CompressResult& result : results)
+      {
+        auto ratio = [&](size_t bytes) { return bytes > 0 ? (double)result.rawBytes / bytes : 0.0; };
+        auto speed = [&](double milliseconds, double unit) { return milliseconds > 0.0 ? result.rawBytes / (milliseconds / 1000.0) / unit : 0.0; };
+        *out << std::left << std::setw(24) << result.stream << std::right << std::fixed << std::setprecision(2)
+          << result.rawBytes / 1e6 << "\t" << ratio(result.codecBytes) << "x\t" << ratio(result.lzBytes) << "x\t"
+          << ratio(result.codecLzBytes) << "x\t\t" << std::setprecision(0) << speed(result.encodeMilliseconds, 1e6) << "\t\t"
+          << std::setprecision(2) << speed(result.decodeMilliseconds, 1e9) << (result.underDecodeTarget ? " !" : "") << "\t\t"
+          << speed(result.lzDecodeMilliseconds, 1e9) << "\t" << result.wrongMeshes << std::endl;
+      }
+      for (const CompressResult& result : results)
+      {
+        if (result.underDecodeTarget)
+        {
+          *out << "! " << result.stream << " decodes under the " << std::setprecision(2)
+            << objl::compress::DecodeTargetBytesPerSecond / 1e9 << " GB/s target" << std::endl;
+        }
+      }
+      if (triangleCount > 0)
+      {
+        *out << "optimized indices: " << std::setprecision(2) << results[3].codecBytes * 8.0 / triangleCount << " bits/tri, "
+          << results[3].codecLzBytes * 8.0 / triangleCount << " with lz" << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct CompressResult
+  {
+    std::string stream;             // Which buffer in which order the row is
+    size_t rawBytes = 0;            // The buffers as the loader gives them
+    size_t codecBytes = 0;          // Encoded with objl::compress
+    size_t lzBytes = 0;             // The raw buffers through the generic LZ77 coder
+    size_t codecLzBytes = 0;        // The encoded buffers through the LZ77 coder as well
+    double encodeMilliseconds = 0.0; // objl::compress encoding, best of the repeats
+    double decodeMilliseconds = 0.0; // objl::compress decoding, best of the repeats
+    double lzDecodeMilliseconds = 0.0; // LZ77 decoding of the raw buffers, best of the repeats
+    size_t wrongMeshes = 0;         // Meshes that didn't decode to exactly their bytes
+    bool underDecodeTarget = false; // objl::compress decoded slower than DecodeTargetBytesPerSecond
+  };
+
+  // Loads the .obj at path with welded vertices and encodes the index buffer, float vertex buffer and
+  // objl::quantize packed vertex buffer of every mesh with objl::compress, in the file's order and after
+  // objl::optimize, against a generic byte oriented LZ77 coder. Decode speeds are of the raw bytes out,
+  // rows decoding under objl::compress::DecodeTargetBytesPerSecond are flagged.
+  std::vector<CompressResult> RunCompressBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
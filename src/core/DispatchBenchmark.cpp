@@ -0,0 +1,103 @@
+#include "PrecompiledHeader.h"
+#include "core/DispatchBenchmark.h"
+#include "core/EngineSystem.h"
+#include "core/StaticEngine.h"
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <utility>
+
+namespace
+{
+  // Distinct types so the static engine really has 128 different systems
+  template<int Id>
+  class CounterSystem : public Systems::EngineSystem
+  {
+  public:
+    virtual void Initialize() {}
+    virtual void Update(float dt) { total += dt * (Id + 1); }
+    virtual void FixedUpdate(float /*dt*/) { ++fixedSteps; }
+    virtual void Cleanup() {}
+
+    float total = 0.0f;
+    unsigned int fixedSteps = 0;
+  };
+
+  template<typename... SystemTypes>
+  struct SystemSet
+  {
+    std::tuple<SystemTypes...> systems;
+
+    Core::StaticEngine<SystemTypes...> MakeEngine()
+    {
+      return std::apply([](auto&... system) { return Core::StaticEngine<SystemTypes...>(system...); }, systems);
+    }
+
+    void AddTo(std::list<Systems::EngineSystem*>& list)
+    {
+      std::apply([&list](auto&... system) { (list.push_back(&system), ...); }, systems);
+    }
+  };
+
+  template<int... Ids>
+  SystemSet<CounterSystem<Ids>...> makeSystemSet(std::integer_sequence<int, Ids...>);
+
+  using BenchmarkSystems = decltype(makeSystemSet(std::make_integer_sequence<int, 128>()));
+}
+
+namespace Core
+{
+  DispatchBenchmarkResult RunDispatchBenchmark(unsigned int frameCount, std::ostream* out)
+  {
+    // Heap allocated, 128 systems are a bit much for the stack in debug builds
+    auto virtualSystems = std::make_unique<BenchmarkSystems>();
+    auto staticSystems = std::make_unique<BenchmarkSystems>();
+
+    std::list<Systems::EngineSystem*> systemList;
+    virtualSystems->AddTo(systemList);
+    auto engine = staticSystems->MakeEngine();
+
+    const float dt = 1.0f / 120.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < frameCount; ++frame)
+    {
+      auto itEnd = systemList.end();
+      for (auto it = systemList.begin(); it != itEnd; ++it)
+      {
+        (*it)->FixedUpdate(dt);
+      }
+      for (auto it = systemList.begin(); it != itEnd; ++it)
+      {
+        (*it)->Update(dt);
+      }
+    }
+    double virtualSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < frameCount; ++frame)
+    {
+      engine.FixedUpdate(dt);
+      engine.Update(dt);
+    }
+    double staticSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    DispatchBenchmarkResult result;
+    result.systemCount = (unsigned int)systemList.size();
+    result.virtualNanosecondsPerFrame = frameCount ? virtualSeconds * 1000000000.0 / frameCount : 0.0;
+    result.staticNanosecondsPerFrame = frameCount ? staticSeconds * 1000000000.0 / frameCount : 0.0;
+
+    // Read the results back so neither loop can be thrown away
+    float checksum = std::get<0>(virtualSystems->systems).total + std::get<127>(staticSystems->systems).total;
+
+    if (out)
+    {
+      *out << result.systemCount << " systems, ns per frame: virtual " << result.virtualNanosecondsPerFrame
+        << ", static " << result.staticNanosecondsPerFrame
+        << " (checksum " << checksum << ")" << std::endl;
+    }
+
+    return result;
+  }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <ostream>
+
+namespace Core
+{
+  struct DispatchBenchmarkResult
+  {
+    unsigned int systemCount = 0;
+    double virtualNanosecondsPerFrame = 0.0; // std::list<EngineSystem*> and virtual calls, like Engine
+    double staticNanosecondsPerFrame = 0.0;  // StaticEngine tuple dispatch
+  };
+
+  // Times Update + FixedUpdate over 128 trivial systems through both dispatch paths.
+  DispatchBenchmarkResult RunDispatchBenchmark(unsigned int frameCount, std::ostream* out = nullptr);
+}
@@ -1,7 +1,29 @@
 #pragma once
 
+#include "core/FrameSnapshot.h"
+
+#include <string>
+#include <vector>
+
 namespace Systems
 {
+  enum class SystemPhase
+  {
+    Update,
+    FixedUpdate
+  };
+
+  // Resources a system reads and writes during one phase, used by the scheduler
+  // to decide which systems may run at the same time.
+  struct SystemAccess
+  {
+    SystemAccess& Read(const std::string& resource) { reads.push_back(resource); return *this; }
+    SystemAccess& Write(const std::string& resource) { writes.push_back(resource); return *this; }
+
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+  };
+
   class EngineSystem
   {
   public:
@@ -9,5 +31,19 @@ namespace Systems
     virtual void Update(float dt) = 0;
     virtual void FixedUpdate(float dt) = 0;
     virtual void Cleanup() = 0;
+
+    virtual const char* GetName() { return "EngineSystem"; }
+
+    // Systems that touch thread affine state (windows, message pumps, graphics queues)
+    // keep this, anything else can return false and gets run on the job system.
+    virtual bool RequiresMainThread() { return true; }
+
+    // Fill in what the system touches in the given phase and return true. Systems
+    // that don't declare anything are treated as touching everything and run alone.
+    virtual bool DeclareAccess(SystemPhase /*phase*/, SystemAccess& /*access*/) { return false; }
+
+    // Copy whatever the renderer needs into the frame's snapshot, called on the main
+    // thread after Update when the engine has a render consumer.
+    virtual void WriteSnapshot(Core::FrameSnapshot& /*snapshot*/) {}
   };
 }
\ No newline at end of file
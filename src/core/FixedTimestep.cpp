@@ -0,0 +1,36 @@
+#include "PrecompiledHeader.h"
+#include "core/FixedTimestep.h"
+
+namespace Core
+{
+  FixedTimestep::FixedTimestep(double stepSeconds, unsigned int maxSubsteps)
+  {
+    SetStepSeconds(stepSeconds);
+    SetMaxSubsteps(maxSubsteps);
+  }
+
+  void FixedTimestep::SetStepSeconds(double stepSeconds)
+  {
+    step = std::chrono::duration_cast<Duration>(std::chrono::duration<double>(stepSeconds));
+    if (step <= Duration::zero())
+      step = Duration(1);
+  }
+
+  unsigned int FixedTimestep::Advance(Duration elapsed)
+  {
+    if (elapsed > Duration::zero())
+      accumulator += elapsed;
+
+    auto steps = accumulator / step;
+    accumulator -= steps * step;
+
+    if (steps > (decltype(steps))maxSubsteps)
+    {
+      // Spiral of death guard, the simulation slows down instead of falling further behind
+      droppedSteps += steps - maxSubsteps;
+      steps = maxSubsteps;
+    }
+
+    return (unsigned int)steps;
+  }
+}
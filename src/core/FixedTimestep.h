@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Core
+{
+  // Accumulates frame time and hands out whole fixed steps. Works in clock ticks
+  // rather than floating point seconds so the same clock sequence always produces
+  // the same steps.
+  class FixedTimestep
+  {
+  public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    FixedTimestep(double stepSeconds, unsigned int maxSubsteps);
+
+    // Adds the frame's elapsed time and returns how many fixed steps to run for it.
+    // Anything past maxSubsteps is dropped so a long hitch can't snowball.
+    unsigned int Advance(Duration elapsed);
+
+    // How far we are between the last fixed step and the next one, in [0, 1).
+    double GetAlpha() { return (double)accumulator.count() / (double)step.count(); }
+    float GetStepSeconds() { return (float)std::chrono::duration<double>(step).count(); }
+    Duration GetStep() { return step; }
+    Duration GetAccumulator() { return accumulator; }
+    uint64_t GetDroppedSteps() { return droppedSteps; }
+
+    void SetStepSeconds(double stepSeconds);
+    void SetMaxSubsteps(unsigned int maxSubsteps) { this->maxSubsteps = maxSubsteps > 0 ? maxSubsteps : 1; }
+    void Reset() { accumulator = Duration::zero(); }
+  private:
+    Duration step;
+    Duration accumulator = Duration::zero();
+    unsigned int maxSubsteps;
+    uint64_t droppedSteps = 0;
+  };
+}
@@ -0,0 +1,164 @@
+#include "PrecompiledHeader.h"
+#include "core/FixedTimestepCheck.h"
+#include "core/GameEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+  using Duration = std::chrono::steady_clock::duration;
+
+  Duration milliseconds(long long count)
+  {
+    return std::chrono::duration_cast<Duration>(std::chrono::milliseconds(count));
+  }
+
+  // One frame of a script, what the clock moves on by and what the frame has to see
+  struct ScriptedFrame
+  {
+    long long elapsedMilliseconds;
+    unsigned int steps;
+    double alpha;
+  };
+
+  // At 60 Hz the step is 16666666 ns, the alphas follow from the ns left over
+  static_assert(FIXED_FPS == 60 && MAX_FIXED_SUBSTEPS == 5, "the scripted frames expect 60 Hz fixed steps and at most 5 per frame");
+  const ScriptedFrame hitchScript[] = {
+    { 16, 0, 16000000.0 / 16666666.0 },
+    { 17, 1, 16333334.0 / 16666666.0 },
+    { 1, 1, 666668.0 / 16666666.0 },
+    { 266, 5, 12.0 / 16666666.0 },         // 16 due, 11 dropped
+    { 16, 0, 16000012.0 / 16666666.0 },
+    { 1684, 5, 80.0 / 16666666.0 },        // 102 due, 97 dropped
+    { 0, 0, 80.0 / 16666666.0 },
+  };
+  const unsigned long long hitchScriptDropped = 108;
+
+  class Checker
+  {
+  public:
+    explicit Checker(std::ostream* out) : out(out) {}
+
+    void Expect(bool passed, const char* what, size_t frame, double got, double expected)
+    {
+      if (passed)
+        return;
+      ++failures;
+      if (out)
+        *out << "FAIL " << what << " at frame " << frame << ": got " << got << ", expected " << expected << std::endl;
+    }
+
+    unsigned int failures = 0;
+  private:
+    std::ostream* out;
+  };
+
+  bool nearlyEqual(double a, double b)
+  {
+    return std::fabs(a - b) < 1e-9;
+  }
+
+  // Counts the FixedUpdates run before each Update and the alpha Update sees
+  class RecordingSystem : public Systems::EngineSystem
+  {
+  public:
+    explicit RecordingSystem(Core::Engine* engine) : engine(engine) {}
+
+    virtual void Initialize() {}
+    virtual void Update(float /*dt*/)
+    {
+      steps.push_back(pendingSteps);
+      alphas.push_back(engine->GetInterpolationAlpha());
+      pendingSteps = 0;
+    }
+    virtual void FixedUpdate(float /*dt*/) { ++pendingSteps; }
+    virtual void Cleanup() {}
+    virtual const char* GetName() { return "RecordingSystem"; }
+
+    std::vector<unsigned int> steps;
+    std::vector<double> alphas;
+  private:
+    Core::Engine* engine;
+    unsigned int pendingSteps = 0;
+  };
+
+  void checkAdvance(Checker& checker)
+  {
+    Core::FixedTimestep timestep(1.0 / FIXED_FPS, MAX_FIXED_SUBSTEPS);
+    checker.Expect(timestep.GetStep() == Duration(std::chrono::nanoseconds(16666666)), "step", 0,
+      (double)timestep.GetStep().count(), 16666666.0);
+
+    size_t frame = 0;
+    for (const ScriptedFrame& scripted : hitchScript)
+    {
+      unsigned int steps = timestep.Advance(milliseconds(scripted.elapsedMilliseconds));
+      checker.Expect(steps == scripted.steps, "Advance steps", frame, steps, scripted.steps);
+      checker.Expect(nearlyEqual(timestep.GetAlpha(), scripted.alpha), "Advance alpha", frame, timestep.GetAlpha(), scripted.alpha);
+      ++frame;
+    }
+    checker.Expect(timestep.GetDroppedSteps() == hitchScriptDropped, "Advance dropped steps", frame,
+      (double)timestep.GetDroppedSteps(), (double)hitchScriptDropped);
+
+    // A clock going backwards adds nothing
+    timestep.Advance(-milliseconds(100));
+    checker.Expect(nearlyEqual(timestep.GetAlpha(), 80.0 / 16666666.0), "negative elapsed alpha", frame, timestep.GetAlpha(), 80.0 / 16666666.0);
+
+    // A cap of 0 still runs one step per frame
+    timestep.Reset();
+    timestep.SetMaxSubsteps(0);
+    unsigned int steps = timestep.Advance(milliseconds(50));
+    checker.Expect(steps == 1, "substep cap of 0", frame, steps, 1.0);
+  }
+
+  void checkEngineLoop(Checker& checker)
+  {
+    // The loop reads the clock once before the first frame and once every frame after
+    std::vector<Duration> clock(1, Duration::zero());
+    for (const ScriptedFrame& scripted : hitchScript)
+      clock.push_back(clock.back() + milliseconds(scripted.elapsedMilliseconds));
+
+    Core::Engine engine;
+    auto next = std::make_shared<size_t>(0);
+    engine.SetTimeSource([clock, next]() {
+      size_t read = std::min(*next, clock.size() - 1);
+      ++*next;
+      return std::chrono::steady_clock::time_point(clock[read]);
+    });
+    engine.SetWorkerCount(1);
+
+    RecordingSystem recorder(&engine);
+    engine.AddSystem(&recorder);
+
+    const size_t frameCount = sizeof(hitchScript) / sizeof(hitchScript[0]);
+    Core::HeadlessOptions options;
+    options.frameCount = (unsigned int)frameCount;
+    engine.RunHeadless(options);
+
+    checker.Expect(recorder.steps.size() == frameCount, "engine frames", 0, (double)recorder.steps.size(), (double)frameCount);
+    for (size_t frame = 0; frame < frameCount && frame < recorder.steps.size(); ++frame)
+    {
+      checker.Expect(recorder.steps[frame] == hitchScript[frame].steps, "engine FixedUpdates", frame, recorder.steps[frame], hitchScript[frame].steps);
+      checker.Expect(nearlyEqual(recorder.alphas[frame], hitchScript[frame].alpha), "engine alpha", frame, recorder.alphas[frame], hitchScript[frame].alpha);
+    }
+    checker.Expect(engine.GetFixedTimestep()->GetDroppedSteps() == hitchScriptDropped, "engine dropped steps", frameCount,
+      (double)engine.GetFixedTimestep()->GetDroppedSteps(), (double)hitchScriptDropped);
+  }
+}
+
+namespace Core
+{
+  unsigned int RunFixedTimestepChecks(std::ostream* out)
+  {
+    Checker checker(out);
+    checkAdvance(checker);
+    checkEngineLoop(checker);
+
+    if (out)
+      *out << "fixed timestep checks: " << (checker.failures == 0 ? "passed" : "FAILED") << ", " << checker.failures << " failures" << std::endl;
+    return checker.failures;
+  }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <ostream>
+
+namespace Core
+{
+  // Feeds scripted clock sequences to FixedTimestep::Advance and, through Engine::SetTimeSource,
+  // to a headless Engine loop, and compares the substeps per frame, the steps dropped at the
+  // substep cap and the interpolation alpha against the expected values. Returns the number of
+  // checks that failed, every failure is written to out.
+  unsigned int RunFixedTimestepChecks(std::ostream* out = nullptr);
+}
@@ -0,0 +1,204 @@
+#include "PrecompiledHeader.h"
+#include "core/FrameAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+namespace Core
+{
+  static size_t alignUp(size_t value, size_t alignment)
+  {
+    return (value + alignment - 1) & ~(alignment - 1);
+  }
+
+  // Buffers are aligned to a cache line so any alignment up to that only needs the offset rounded
+  static constexpr size_t bufferAlignment = 64;
+
+  static std::byte* allocateBuffer(size_t capacity)
+  {
+    return static_cast<std::byte*>(::operator new(capacity, std::align_val_t(bufferAlignment)));
+  }
+
+  static void freeBuffer(std::byte* buffer)
+  {
+    ::operator delete(buffer, std::align_val_t(bufferAlignment));
+  }
+
+  LinearArena::LinearArena(size_t capacity) : buffer(allocateBuffer(capacity)), capacity(capacity)
+  {
+  }
+
+  LinearArena::~LinearArena()
+  {
+    Reset();
+    freeBuffer(buffer);
+  }
+
+  void* LinearArena::Allocate(size_t size, size_t alignment)
+  {
+    if (alignment > bufferAlignment)
+      return allocateOverflow(size, alignment);
+
+    size_t current = offset.load(std::memory_order_relaxed);
+    size_t aligned;
+    do
+    {
+      aligned = alignUp(current, alignment);
+      if (aligned + size > capacity)
+        return allocateOverflow(size, alignment);
+    } while (!offset.compare_exchange_weak(current, aligned + size, std::memory_order_relaxed));
+
+    return buffer + aligned;
+  }
+
+  void* LinearArena::allocateOverflow(size_t size, size_t alignment)
+  {
+    alignment = std::max(alignment, bufferAlignment);
+    void* block = ::operator new(size, std::align_val_t(alignment));
+    overflowBytes.fetch_add(size, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    overflowBlocks.push_back({ block, alignment });
+    return block;
+  }
+
+  size_t LinearArena::GetUsed()
+  {
+    return std::min(offset.load(std::memory_order_relaxed), capacity) + overflowBytes.load(std::memory_order_relaxed);
+  }
+
+  void LinearArena::Reset()
+  {
+    lastUsed = GetUsed();
+    highWaterMark = std::max(highWaterMark, lastUsed);
+
+    if (!overflowBlocks.empty())
+    {
+      ++overflowCount;
+      for (auto& block : overflowBlocks)
+      {
+        ::operator delete(block.first, std::align_val_t(block.second));
+      }
+      overflowBlocks.clear();
+    }
+
+    offset.store(0, std::memory_order_relaxed);
+    overflowBytes.store(0, std::memory_order_relaxed);
+  }
+
+  ScratchStack::ScratchStack(size_t capacity) : buffer(allocateBuffer(capacity)), capacity(capacity)
+  {
+  }
+
+  ScratchStack::~ScratchStack()
+  {
+    FreeToMarker({ 0, 0, 0 });
+    freeBuffer(buffer);
+  }
+
+  void* ScratchStack::Allocate(size_t size, size_t alignment)
+  {
+    void* memory;
+    size_t aligned = alignUp(offset, alignment);
+    if (alignment <= bufferAlignment && aligned + size <= capacity)
+    {
+      memory = buffer + aligned;
+      offset = aligned + size;
+    }
+    else
+    {
+      alignment = std::max(alignment, bufferAlignment);
+      memory = ::operator new(size, std::align_val_t(alignment));
+      overflowBlocks.push_back({ memory, alignment });
+      overflowBytes += size;
+    }
+
+    size_t used = GetUsed();
+    if (used > highWaterMark.load(std::memory_order_relaxed))
+      highWaterMark.store(used, std::memory_order_relaxed);
+    return memory;
+  }
+
+  void ScratchStack::FreeToMarker(Marker marker)
+  {
+    offset = marker.offset;
+    while (overflowBlocks.size() > marker.overflowBlocks)
+    {
+      ::operator delete(overflowBlocks.back().first, std::align_val_t(overflowBlocks.back().second));
+      overflowBlocks.pop_back();
+    }
+    overflowBytes = marker.overflowBytes;
+  }
+
+  // Every live thread scratch stack, so the frame stats can see the workers' ones
+  static std::mutex& scratchRegistryMutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<ScratchStack*>& scratchRegistry()
+  {
+    static std::vector<ScratchStack*> stacks;
+    return stacks;
+  }
+
+  struct RegisteredScratchStack
+  {
+    RegisteredScratchStack()
+    {
+      // Touch the registry first so it outlives the main thread's stack
+      std::lock_guard<std::mutex> lock(scratchRegistryMutex());
+      scratchRegistry().push_back(&stack);
+    }
+
+    ~RegisteredScratchStack()
+    {
+      std::lock_guard<std::mutex> lock(scratchRegistryMutex());
+      auto& stacks = scratchRegistry();
+      stacks.erase(std::find(stacks.begin(), stacks.end(), &stack));
+    }
+
+    ScratchStack stack;
+  };
+
+  ScratchStack& GetThreadScratch()
+  {
+    static thread_local RegisteredScratchStack threadScratch;
+    return threadScratch.stack;
+  }
+
+  void FrameMemory::BeginFrame()
+  {
+    frameArena.Reset();
+    stats.frameUsed = frameArena.GetLastUsed();
+    stats.framePeak = frameArena.GetHighWaterMark();
+
+    // The arena we switch to was last used two frames ago, nobody can still be reading it
+    current ^= 1;
+    doubleBufferedArenas[current].Reset();
+    stats.doubleBufferedUsed = doubleBufferedArenas[current].GetLastUsed();
+    stats.doubleBufferedPeak = std::max(doubleBufferedArenas[0].GetHighWaterMark(), doubleBufferedArenas[1].GetHighWaterMark());
+
+    stats.scratchUsed = 0;
+    {
+      std::lock_guard<std::mutex> lock(scratchRegistryMutex());
+      for (ScratchStack* stack : scratchRegistry())
+      {
+        stats.scratchUsed = std::max(stats.scratchUsed, stack->ResetHighWaterMark());
+      }
+    }
+    stats.scratchPeak = std::max(stats.scratchPeak, stats.scratchUsed);
+
+    stats.overflows = frameArena.GetOverflowCount() + doubleBufferedArenas[0].GetOverflowCount() + doubleBufferedArenas[1].GetOverflowCount();
+  }
+
+  void FrameMemoryStats::Print(std::ostream& out)
+  {
+    out << "frame memory KB: frame " << frameUsed / 1024.0 << " (peak " << framePeak / 1024.0 << ")"
+      << ", double buffered " << doubleBufferedUsed / 1024.0 << " (peak " << doubleBufferedPeak / 1024.0 << ")"
+      << ", scratch " << scratchUsed / 1024.0 << " (peak " << scratchPeak / 1024.0 << ")"
+      << ", overflowed frames " << overflows << std::endl;
+  }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#define FRAME_ARENA_SIZE (8 * 1024 * 1024) // Bytes per frame arena, past this allocations spill to the heap until the reset
+#define SCRATCH_STACK_SIZE (1024 * 1024)  // Bytes per thread scratch stack
+
+namespace Core
+{
+  // Bump allocator that is emptied all at once. Allocate is lock free so systems
+  // running on job workers can share one, Reset must not race with it.
+  class LinearArena
+  {
+  public:
+    LinearArena(size_t capacity = FRAME_ARENA_SIZE);
+    ~LinearArena();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void Reset();
+
+    size_t GetCapacity() { return capacity; }
+    // Bytes handed out since the last Reset, including heap spill
+    size_t GetUsed();
+    // Most bytes used between two resets, ever
+    size_t GetHighWaterMark() { return highWaterMark; }
+    // Bytes used in the frame before the last Reset
+    size_t GetLastUsed() { return lastUsed; }
+    uint64_t GetOverflowCount() { return overflowCount; }
+  protected:
+    LinearArena(LinearArena const&) = delete;
+    void operator=(LinearArena const&) = delete;
+  private:
+    void* allocateOverflow(size_t size, size_t alignment);
+
+    std::byte* buffer;
+    size_t capacity;
+    std::atomic<size_t> offset{ 0 };
+
+    std::mutex overflowMutex;
+    std::vector<std::pair<void*, size_t>> overflowBlocks;
+    std::atomic<size_t> overflowBytes{ 0 };
+    uint64_t overflowCount = 0;
+
+    size_t highWaterMark = 0;
+    size_t lastUsed = 0;
+  };
+
+  // Single thread LIFO allocator, take a ScratchScope and everything allocated
+  // inside it is released when the scope ends.
+  class ScratchStack
+  {
+  public:
+    struct Marker
+    {
+      size_t offset;
+      size_t overflowBlocks;
+      size_t overflowBytes;
+    };
+
+    ScratchStack(size_t capacity = SCRATCH_STACK_SIZE);
+    ~ScratchStack();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    Marker GetMarker() { return { offset, overflowBlocks.size(), overflowBytes }; }
+    void FreeToMarker(Marker marker);
+
+    size_t GetCapacity() { return capacity; }
+    size_t GetUsed() { return offset + overflowBytes; }
+    // Most bytes held at once since the last ResetHighWaterMark
+    size_t GetHighWaterMark() { return highWaterMark.load(std::memory_order_relaxed); }
+    size_t ResetHighWaterMark() { return highWaterMark.exchange(GetUsed(), std::memory_order_relaxed); }
+  protected:
+    ScratchStack(ScratchStack const&) = delete;
+    void operator=(ScratchStack const&) = delete;
+  private:
+    std::byte* buffer;
+    size_t capacity;
+    size_t offset = 0;
+    std::vector<std::pair<void*, size_t>> overflowBlocks;
+    size_t overflowBytes = 0;
+    std::atomic<size_t> highWaterMark{ 0 };
+  };
+
+  // The calling thread's scratch stack, made on first use.
+  ScratchStack& GetThreadScratch();
+
+  class ScratchScope
+  {
+  public:
+    ScratchScope(ScratchStack& stack = GetThreadScratch()) : stack(stack), marker(stack.GetMarker()) {}
+    ~ScratchScope() { stack.FreeToMarker(marker); }
+
+    ScratchStack& GetStack() { return stack; }
+  protected:
+    ScratchScope(ScratchScope const&) = delete;
+    void operator=(ScratchScope const&) = delete;
+  private:
+    ScratchStack& stack;
+    ScratchStack::Marker marker;
+  };
+
+  // STL allocator over any of the arenas above, deallocate is a no-op and the
+  // memory comes back when the arena is reset or the scratch scope ends.
+  //   std::vector<int, ArenaAllocator<int, LinearArena>> values(ArenaAllocator<int, LinearArena>(arena));
+  template<typename T, typename Arena>
+  class ArenaAllocator
+  {
+  public:
+    using value_type = T;
+
+    ArenaAllocator(Arena& arena) : arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U, Arena>& other) : arena(other.GetArena()) {}
+
+    T* allocate(size_t count)
+    {
+      if (count > SIZE_MAX / sizeof(T))
+        throw std::bad_array_new_length();
+      return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+
+    Arena* GetArena() const { return arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U, Arena>& other) const { return arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U, Arena>& other) const { return arena != other.GetArena(); }
+  private:
+    Arena* arena;
+  };
+
+  template<typename T>
+  using FrameAllocator = ArenaAllocator<T, LinearArena>;
+  template<typename T>
+  using ScratchAllocator = ArenaAllocator<T, ScratchStack>;
+
+  struct FrameMemoryStats
+  {
+    // Bytes used last frame and the most used in any frame
+    size_t frameUsed = 0;
+    size_t framePeak = 0;
+    size_t doubleBufferedUsed = 0;
+    size_t doubleBufferedPeak = 0;
+    // Most any one thread held on its scratch stack last frame, and ever
+    size_t scratchUsed = 0;
+    size_t scratchPeak = 0;
+    // Frames that spilled past an arena and went to the heap
+    uint64_t overflows = 0;
+
+    void Print(std::ostream& out);
+  };
+
+  // The engine's frame lifetime memory. GetFrameArena is emptied at the top of every
+  // frame, GetDoubleBufferedArena allocations stay valid through the next frame as well.
+  class FrameMemory
+  {
+  public:
+    FrameMemory(size_t arenaSize = FRAME_ARENA_SIZE) : frameArena(arenaSize), doubleBufferedArenas{ arenaSize, arenaSize } {}
+
+    // Nothing may be allocating while this runs
+    void BeginFrame();
+
+    LinearArena& GetFrameArena() { return frameArena; }
+    LinearArena& GetDoubleBufferedArena() { return doubleBufferedArenas[current]; }
+    // The double buffered arena of the previous frame, still valid this frame
+    LinearArena& GetPreviousDoubleBufferedArena() { return doubleBufferedArenas[current ^ 1]; }
+
+    FrameMemoryStats GetStats() { return stats; }
+  private:
+    LinearArena frameArena;
+    LinearArena doubleBufferedArenas[2];
+    unsigned int current = 0;
+    FrameMemoryStats stats;
+  };
+}
@@ -0,0 +1,243 @@
+#include "PrecompiledHeader.h"
+#include "core/FramePacer.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace Core
+{
+  FramePacer::~FramePacer()
+  {
+#ifdef _WIN32
+    if (waitableTimer)
+      CloseHandle(waitableTimer);
+    if (timerPeriodRaised)
+      timeEndPeriod(1);
+#endif
+  }
+
+  void FramePacer::SetTargetFrameTime(double seconds)
+  {
+    targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    Reset();
+  }
+
+  void FramePacer::SetStrategy(PacingStrategy newStrategy)
+  {
+    strategy = newStrategy;
+
+#ifdef _WIN32
+    // Sleep(1) is ~15.6ms at the default timer resolution
+    if ((strategy == PacingStrategy::Sleep || strategy == PacingStrategy::Hybrid) && !timerPeriodRaised)
+    {
+      timerPeriodRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+
+    if (strategy == PacingStrategy::Timer && !waitableTimer)
+    {
+      waitableTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+      // Pre 1803 Windows doesn't know the flag, a regular timer still beats Sleep
+      if (!waitableTimer)
+        waitableTimer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+    }
+#endif
+
+    Reset();
+  }
+
+  void FramePacer::Reset()
+  {
+    started = false;
+  }
+
+  void FramePacer::WaitForNextFrame()
+  {
+    if (!started)
+    {
+#ifdef _WIN32
+      // Make sure the platform setup for the default strategy happened
+      if (strategy == PacingStrategy::Hybrid && !timerPeriodRaised)
+        SetStrategy(strategy);
+#endif
+      started = true;
+      lastWake = Clock::now();
+      deadline = lastWake + targetFrameTime;
+      return;
+    }
+
+    PROFILE_ZONE("FramePacer::Wait");
+    auto waitStart = Clock::now();
+    switch (strategy)
+    {
+    case PacingStrategy::Spin:
+      spinUntil(deadline);
+      break;
+    case PacingStrategy::Sleep:
+      if (waitStart < deadline)
+        std::this_thread::sleep_until(deadline);
+      break;
+    case PacingStrategy::Hybrid:
+      sleepAhead(deadline);
+      spinUntil(deadline);
+      break;
+    case PacingStrategy::Timer:
+      timerWait(deadline);
+      spinUntil(deadline);
+      break;
+    }
+
+    auto wake = Clock::now();
+    waitTime += std::chrono::duration<double>(wake - waitStart).count();
+    recordFrame(wake);
+
+    deadline += targetFrameTime;
+    // Fell more than a frame behind, don't try to make it up with a burst of short frames
+    if (wake > deadline)
+      deadline = wake + targetFrameTime;
+  }
+
+  void FramePacer::sleepAhead(Clock::time_point until)
+  {
+    // Wake up early by what an unlucky sleep overshoots, so the spin after it is only that long
+    auto margin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(estimate(sleepMean, sleepM2, sleepCount)));
+    auto wakeAt = until - margin;
+    if (Clock::now() >= wakeAt)
+      return;
+
+    std::this_thread::sleep_until(wakeAt);
+    recordOvershoot(sleepMean, sleepM2, sleepCount, std::chrono::duration<double>(Clock::now() - wakeAt).count());
+  }
+
+  void FramePacer::timerWait(Clock::time_point until)
+  {
+    auto now = Clock::now();
+    double remaining = std::chrono::duration<double>(until - now).count();
+    double margin = estimate(timerMean, timerM2, timerCount);
+    if (remaining <= margin)
+      return;
+
+    double requested = remaining - margin;
+#ifdef _WIN32
+    if (waitableTimer)
+    {
+      // Negative means relative, in 100ns units
+      LARGE_INTEGER dueTime;
+      dueTime.QuadPart = -(LONGLONG)(requested * 10000000.0);
+      if (SetWaitableTimer(waitableTimer, &dueTime, 0, NULL, NULL, FALSE))
+        WaitForSingleObject(waitableTimer, INFINITE);
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::duration<double>(requested));
+    }
+#else
+    std::this_thread::sleep_until(now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(requested)));
+#endif
+
+    double waited = std::chrono::duration<double>(Clock::now() - now).count();
+    recordOvershoot(timerMean, timerM2, timerCount, waited - requested);
+  }
+
+  void FramePacer::spinUntil(Clock::time_point until)
+  {
+    auto start = Clock::now();
+    auto now = start;
+    while (now < until)
+    {
+      std::this_thread::yield();
+      now = Clock::now();
+    }
+    spinTime += std::chrono::duration<double>(now - start).count();
+  }
+
+  // Welford's running variance, the estimate is mean plus one standard deviation
+  void FramePacer::recordOvershoot(double& mean, double& m2, uint64_t& count, double overshoot)
+  {
+    overshoot = std::max(overshoot, 0.0);
+    ++count;
+    double delta = overshoot - mean;
+    mean += delta / count;
+    m2 += delta * (overshoot - mean);
+
+    // Keep adapting to the current machine load instead of averaging forever
+    if (count > 1000)
+    {
+      count = 500;
+      m2 *= 0.5;
+    }
+  }
+
+  double FramePacer::estimate(double mean, double m2, uint64_t count)
+  {
+    double variance = count > 1 ? m2 / (count - 1) : 0.0;
+    return mean + std::sqrt(variance);
+  }
+
+  void FramePacer::recordFrame(Clock::time_point wake)
+  {
+    double error = std::chrono::duration<double>(wake - deadline).count();
+    double errorMicroseconds = std::max(error, 0.0) * 1000000.0;
+    size_t bucket = std::min((size_t)(errorMicroseconds / PACING_HISTOGRAM_BUCKET_MICROSECONDS), (size_t)PACING_HISTOGRAM_BUCKETS - 1);
+    ++errorHistogram[bucket];
+    ++frameCount;
+    errorSum += error;
+    maxError = std::max(maxError, error);
+
+    double interval = std::chrono::duration<double>(wake - lastWake).count();
+    lastWake = wake;
+    ++intervalCount;
+    double delta = interval - intervalMean;
+    intervalMean += delta / intervalCount;
+    intervalM2 += delta * (interval - intervalMean);
+  }
+
+  double FramePacer::GetJitter()
+  {
+    return intervalCount > 1 ? std::sqrt(intervalM2 / (intervalCount - 1)) : 0.0;
+  }
+
+  void FramePacer::ClearStatistics()
+  {
+    std::fill(errorHistogram, errorHistogram + PACING_HISTOGRAM_BUCKETS, 0);
+    frameCount = 0;
+    errorSum = 0.0;
+    maxError = 0.0;
+    intervalMean = 0.0;
+    intervalM2 = 0.0;
+    intervalCount = 0;
+    spinTime = 0.0;
+    waitTime = 0.0;
+  }
+
+  void FramePacer::DumpStatistics(std::ostream& out)
+  {
+    const char* names[] = { "spin", "sleep", "hybrid", "timer" };
+    out << "Frame pacing (" << names[(int)strategy] << "): " << frameCount << " frames"
+      << ", mean error " << GetMeanError() * 1000000.0 << " us"
+      << ", max error " << maxError * 1000000.0 << " us"
+      << ", jitter " << GetJitter() * 1000000.0 << " us"
+      << ", spinning " << GetSpinFraction() * 100.0 << "% of the wait" << std::endl;
+
+    for (int i = 0; i < PACING_HISTOGRAM_BUCKETS; ++i)
+    {
+      if (errorHistogram[i] == 0)
+        continue;
+
+      out << "  " << i * PACING_HISTOGRAM_BUCKET_MICROSECONDS << "us";
+      if (i == PACING_HISTOGRAM_BUCKETS - 1)
+        out << "+";
+      out << "\t" << errorHistogram[i] << std::endl;
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#define PACING_HISTOGRAM_BUCKETS 40
+#define PACING_HISTOGRAM_BUCKET_MICROSECONDS 25 // 40 x 25us covers 1ms of lateness, the last bucket takes the rest
+
+namespace Core
+{
+  enum class PacingStrategy
+  {
+    Spin,   // busy wait the whole time, most accurate and burns a core
+    Sleep,  // sleep until the deadline, cheapest and at the mercy of the scheduler
+    Hybrid, // sleep until a measured margin before the deadline, spin the rest
+    Timer   // one high resolution timer wait for the coarse part, spin the rest
+  };
+
+  // Holds each frame until its deadline on the steady clock and keeps track
+  // of how far off the wake ups were.
+  class FramePacer
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer() {}
+    ~FramePacer();
+
+    void SetTargetFrameTime(double seconds);
+    void SetStrategy(PacingStrategy strategy);
+    PacingStrategy GetStrategy() { return strategy; }
+
+    // Blocks until the current frame's deadline and schedules the next one.
+    void WaitForNextFrame();
+    // Starts pacing over from now, e.g. after a hitch or a strategy change.
+    void Reset();
+
+    // Wake up lateness in microseconds, bucketed by PACING_HISTOGRAM_BUCKET_MICROSECONDS.
+    const uint64_t* GetErrorHistogram() { return errorHistogram; }
+    double GetMeanError() { return frameCount ? errorSum / frameCount : 0.0; }
+    double GetMaxError() { return maxError; }
+    // Standard deviation of the time between frames, in seconds.
+    double GetJitter();
+    // Fraction of the paced time spent busy waiting, a stand in for the CPU the pacer costs.
+    double GetSpinFraction() { return waitTime > 0.0 ? spinTime / waitTime : 0.0; }
+    void ClearStatistics();
+    void DumpStatistics(std::ostream& out);
+  private:
+    FramePacer(FramePacer const&) = delete;
+    void operator=(FramePacer const&) = delete;
+
+    void sleepAhead(Clock::time_point deadline);
+    void timerWait(Clock::time_point deadline);
+    void spinUntil(Clock::time_point deadline);
+    void recordOvershoot(double& mean, double& m2, uint64_t& count, double overshoot);
+    double estimate(double mean, double m2, uint64_t count);
+    void recordFrame(Clock::time_point wake);
+
+    PacingStrategy strategy = PacingStrategy::Hybrid;
+    Clock::duration targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    Clock::time_point deadline{};
+    Clock::time_point lastWake{};
+    bool started = false;
+    bool timerPeriodRaised = false;
+
+    // Running mean / variance of how much a sleep or timer wait overshoots, in seconds
+    double sleepMean = 0.001;
+    double sleepM2 = 0.0;
+    uint64_t sleepCount = 1;
+    double timerMean = 0.0005;
+    double timerM2 = 0.0;
+    uint64_t timerCount = 1;
+
+#ifdef _WIN32
+    void* waitableTimer = nullptr;
+#endif
+
+    uint64_t errorHistogram[PACING_HISTOGRAM_BUCKETS] = {};
+    uint64_t frameCount = 0;
+    double errorSum = 0.0;
+    double maxError = 0.0;
+    double intervalMean = 0.0;
+    double intervalM2 = 0.0;
+    uint64_t intervalCount = 0;
+    double spinTime = 0.0;
+    double waitTime = 0.0;
+  };
+}
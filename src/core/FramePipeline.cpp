@@ -0,0 +1,165 @@
+#include "PrecompiledHeader.h"
+#include "core/FramePipeline.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+
+namespace Core
+{
+  void StandInRenderer::Consume(const FrameSnapshot& snapshot)
+  {
+    PROFILE_ZONE("StandInRenderer::Consume");
+    auto until = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(renderSeconds));
+    while (std::chrono::steady_clock::now() < until)
+    {
+    }
+    lastFrameIndex = snapshot.frameIndex;
+  }
+
+  void FramePipeline::Start(RenderConsumer* renderConsumer, PipelineMode pipelineMode)
+  {
+    Stop();
+
+    consumer = renderConsumer;
+    mode = pipelineMode;
+    stopping = false;
+    writing = pending = rendering = -1;
+    stats = PipelineStats();
+    latencySum = renderTimeSum = 0.0;
+
+    if (consumer && mode != PipelineMode::Synchronous)
+      renderThread = std::thread(&FramePipeline::renderLoop, this);
+  }
+
+  void FramePipeline::Stop()
+  {
+    if (renderThread.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      pendingCondition.notify_all();
+      renderThread.join();
+    }
+    consumer = nullptr;
+  }
+
+  FrameSnapshot& FramePipeline::BeginFrame()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (mode == PipelineMode::DoubleBuffered)
+    {
+      // Only one frame may wait for the renderer, block until it takes it
+      PROFILE_ZONE("FramePipeline::WaitForRender");
+      auto waitStart = std::chrono::steady_clock::now();
+      takenCondition.wait(lock, [this]() { return pending < 0 || stopping; });
+      stats.producerWaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+    }
+
+    for (int slot = 0; slot < slotCount; ++slot)
+    {
+      if (slot != pending && slot != rendering)
+      {
+        writing = slot;
+        break;
+      }
+    }
+
+    FrameSnapshot& snapshot = slots[writing];
+    snapshot.frameIndex = nextFrameIndex++;
+    snapshot.simulationTime = 0.0;
+    snapshot.interpolationAlpha = 0.0;
+    snapshot.draws.clear();
+    return snapshot;
+  }
+
+  void FramePipeline::Publish()
+  {
+    int published;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      published = writing;
+      writing = -1;
+      slots[published].publishTime = std::chrono::steady_clock::now();
+      ++stats.published;
+
+      if (mode != PipelineMode::Synchronous)
+      {
+        // Triple buffering lands here with a frame still pending, it's stale now
+        if (pending >= 0)
+          ++stats.dropped;
+        pending = published;
+      }
+    }
+
+    if (mode == PipelineMode::Synchronous)
+      consume(published);
+    else
+      pendingCondition.notify_one();
+  }
+
+  void FramePipeline::renderLoop()
+  {
+    PROFILE_THREAD_NAME("Render");
+
+    while (true)
+    {
+      int slot;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        pendingCondition.wait(lock, [this]() { return pending >= 0 || stopping; });
+        if (pending < 0)
+          return;
+
+        slot = rendering = pending;
+        pending = -1;
+      }
+      takenCondition.notify_one();
+
+      consume(slot);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        rendering = -1;
+      }
+    }
+  }
+
+  void FramePipeline::consume(int slot)
+  {
+    const FrameSnapshot& snapshot = slots[slot];
+    auto start = std::chrono::steady_clock::now();
+    double latency = std::chrono::duration<double>(start - snapshot.publishTime).count();
+
+    consumer->Consume(snapshot);
+
+    double renderTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    ++stats.rendered;
+    latencySum += latency;
+    renderTimeSum += renderTime;
+    stats.maxLatency = std::max(stats.maxLatency, latency);
+  }
+
+  PipelineStats FramePipeline::GetStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    PipelineStats result = stats;
+    if (result.rendered > 0)
+    {
+      result.meanLatency = latencySum / result.rendered;
+      result.meanRenderTime = renderTimeSum / result.rendered;
+    }
+    return result;
+  }
+
+  void PipelineStats::Print(std::ostream& out)
+  {
+    out << "pipeline: " << published << " published, " << rendered << " rendered, " << dropped << " dropped" << std::endl
+      << "latency ms: mean " << meanLatency * 1000.0 << ", max " << maxLatency * 1000.0
+      << ", render mean " << meanRenderTime * 1000.0
+      << ", simulation blocked " << producerWaitTime * 1000.0 << std::endl;
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/FrameSnapshot.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+namespace Core
+{
+  enum class PipelineMode
+  {
+    Synchronous,    // render each snapshot on the main thread as soon as it's published
+    DoubleBuffered, // render frame N while frame N+1 simulates, simulation waits if it gets further ahead
+    TripleBuffered  // simulation never waits, the renderer always takes the newest frame and skips stale ones
+  };
+
+  struct PipelineStats
+  {
+    uint64_t published = 0;
+    uint64_t rendered = 0;
+    uint64_t dropped = 0;
+    double meanLatency = 0.0;   // publish to render start, seconds
+    double maxLatency = 0.0;
+    double meanRenderTime = 0.0;
+    double producerWaitTime = 0.0; // total time simulation spent blocked on the renderer
+
+    void Print(std::ostream& out);
+  };
+
+  // Stand in for a real renderer, burns renderSeconds of CPU per snapshot so the
+  // pipeline modes can be compared without a GPU.
+  class StandInRenderer : public RenderConsumer
+  {
+  public:
+    StandInRenderer(double renderSeconds) : renderSeconds(renderSeconds) {}
+    virtual void Consume(const FrameSnapshot& snapshot);
+    uint64_t GetLastFrameIndex() { return lastFrameIndex; }
+  private:
+    double renderSeconds;
+    uint64_t lastFrameIndex = 0;
+  };
+
+  // Hands snapshots from the simulation to a render consumer running on its own thread.
+  class FramePipeline
+  {
+  public:
+    FramePipeline() {}
+    ~FramePipeline() { Stop(); }
+
+    void Start(RenderConsumer* consumer, PipelineMode mode);
+    // Renders anything still pending and joins the render thread.
+    void Stop();
+    bool IsRunning() { return consumer != nullptr; }
+
+    // Snapshot to fill in for the next frame, cleared but keeping its allocations.
+    FrameSnapshot& BeginFrame();
+    void Publish();
+
+    PipelineStats GetStats();
+  protected:
+    FramePipeline(FramePipeline const&) = delete;
+    void operator=(FramePipeline const&) = delete;
+  private:
+    static const int slotCount = 3;
+
+    void renderLoop();
+    void consume(int slot);
+
+    RenderConsumer* consumer = nullptr;
+    PipelineMode mode = PipelineMode::Synchronous;
+    FrameSnapshot slots[slotCount];
+
+    std::mutex mutex;
+    std::condition_variable pendingCondition;
+    std::condition_variable takenCondition;
+    std::thread renderThread;
+    bool stopping = false;
+    int writing = -1;
+    int pending = -1;
+    int rendering = -1;
+    uint64_t nextFrameIndex = 0;
+
+    PipelineStats stats;
+    double latencySum = 0.0;
+    double renderTimeSum = 0.0;
+  };
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Core
+{
+  struct DrawItem
+  {
+    uint32_t mesh = 0;
+    uint32_t material = 0;
+    float transform[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+  };
+
+  // Everything the renderer needs from one simulated frame. Systems fill it in on
+  // the main thread, after publishing it is only ever read.
+  struct FrameSnapshot
+  {
+    uint64_t frameIndex = 0;
+    double simulationTime = 0.0;
+    double interpolationAlpha = 0.0;
+    std::chrono::steady_clock::time_point publishTime{};
+    std::vector<DrawItem> draws;
+  };
+
+  class RenderConsumer
+  {
+  public:
+    virtual void Consume(const FrameSnapshot& snapshot) = 0;
+  };
+}
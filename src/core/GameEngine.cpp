@@ -1,8 +1,12 @@
 #include "PrecompiledHeader.h"
-#include "core\GameEngine.h"
+#include "core/GameEngine.h"
+#include "core/Profiler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <memory>
+#include <thread>
 
 #include <iostream>
 
@@ -11,74 +15,122 @@ namespace Core
   void Engine::AddSystem(Systems::EngineSystem* system)
   {
     _systems.push_back(system);
+    _scheduleDirty = true;
   }
 
   void Engine::Start()
   {
+    PROFILE_THREAD_NAME("Main");
+
+    unsigned int workerCount = _workerCount;
+    if (workerCount == 0)
+    {
+      unsigned int hardwareThreads = std::thread::hardware_concurrency();
+      workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    _jobSystem.Initialize(workerCount);
+    _scheduler.SetTelemetry(&_telemetry);
+
     auto itEnd = _systems.end();
     for (auto it = _systems.begin(); it != itEnd; ++it)
     {
+      PROFILE_ZONE_CATEGORY((*it)->GetName(), "Initialize");
+      auto start = std::chrono::steady_clock::now();
       (*it)->Initialize();
+      _telemetry.GetTimings(*it)->Record(SystemCall::Initialize, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     }
 
+    if (_renderConsumer)
+      _pipeline.Start(_renderConsumer, _pipelineMode);
+
     Loop();
   }
 
   void Engine::Loop()
   {
-    auto previousFrameTime = std::chrono::system_clock::now();
-    auto fixedDuration = std::chrono::duration<double>(0.0);
-    auto targetDuration = std::chrono::duration<double>(0.0);
+    auto previousFrameTime = _timeSource();
     auto fpsDuration = std::chrono::duration<double>(0.0);
-    double fixedFrameTime = 1.0 / FIXED_FPS;
-    double targetFrameTime = 1.0 / TARGET_FPS;
+    double simulationTime = 0.0;
     unsigned int frameCount = 0;
+    _fixedTimestep.Reset();
+
+    if (_throttle)
+    {
+      _framePacer.SetStrategy(_pacingStrategy);
+      _framePacer.SetTargetFrameTime(_targetFrameTime);
+    }
 
     while (_interruptLoop == false)
     {
-      auto currentFrameTime = std::chrono::system_clock::now();
-      auto elapsedFrameTime = std::chrono::duration_cast<std::chrono::duration<double>>(currentFrameTime - previousFrameTime);
-      fixedDuration += elapsedFrameTime;
+      PROFILE_ZONE("Frame");
+      auto frameWorkStart = std::chrono::steady_clock::now();
+
+      // Last frame's transient allocations are dead, every job of it has finished
+      _frameMemory.BeginFrame();
+
+      auto currentFrameTime = _timeSource();
+      auto frameDelta = currentFrameTime - previousFrameTime;
+      auto elapsedFrameTime = std::chrono::duration_cast<std::chrono::duration<double>>(frameDelta);
       fpsDuration += elapsedFrameTime;
+      simulationTime += elapsedFrameTime.count();
       previousFrameTime = currentFrameTime;
 
-      auto itEnd = _systems.end();
-#ifdef THROTTLE_FPS
-      targetDuration += elapsedFrameTime;
-      if (targetDuration.count() >= targetFrameTime)
+      _telemetry.RecordFrame(elapsedFrameTime.count());
+      _telemetry.Tick(elapsedFrameTime.count());
+
+      if (_scheduleDirty)
       {
-        for (auto it = _systems.begin(); it != itEnd; ++it)
-        {
-          (*it)->Update(targetDuration.count()); //conversion from '_Rep' to 'float', possible loss of data <- figure this out
-        }
-        targetDuration = std::chrono::duration<double>(0.0);
-      }
+        _scheduler.Build(_systems);
+        _scheduleDirty = false;
+#ifdef DEBUG_SCHEDULE
+        _scheduler.DumpSchedule(std::cout);
 #endif
-#ifndef THROTTLE_FPS
-      for (auto it = _systems.begin(); it != itEnd; ++it)
+      }
+
+      // Fixed steps first so Update (and rendering) sees this frame's interpolation alpha
+      unsigned int fixedSteps = _fixedTimestep.Advance(frameDelta);
+      for (unsigned int step = 0; step < fixedSteps; ++step)
       {
-        (*it)->Update(elapsedFrameTime.count());
+        _scheduler.Run(Systems::SystemPhase::FixedUpdate, _fixedTimestep.GetStepSeconds(), _jobSystem);
       }
-#endif
 
-      if (fixedDuration.count() >= fixedFrameTime)
+      _scheduler.Run(Systems::SystemPhase::Update, (float)elapsedFrameTime.count(), _jobSystem);
+
+      // The renderer works on this snapshot while the next frame simulates
+      if (_pipeline.IsRunning())
       {
-        auto itEnd = _systems.end();
-        for (auto it = _systems.begin(); it != itEnd; ++it)
+        FrameSnapshot& snapshot = _pipeline.BeginFrame();
+        snapshot.simulationTime = simulationTime;
+        snapshot.interpolationAlpha = _fixedTimestep.GetAlpha();
+        for (auto system : _systems)
         {
-          (*it)->FixedUpdate((float)fixedFrameTime);
+          system->WriteSnapshot(snapshot);
         }
-        fixedDuration -= std::chrono::duration<double>(fixedFrameTime);
+        _pipeline.Publish();
       }
 
       ++frameCount;
       if (fpsDuration.count() >= 1.0)
       {
         framesPerSecond = frameCount;
+        PROFILE_COUNTER("FPS", framesPerSecond);
 
         frameCount = 0;
         fpsDuration = std::chrono::duration<double>(0.0);
       }
+
+      if (_frameLimit > 0)
+      {
+        _frameTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameWorkStart).count());
+        if (_frameTimes.size() >= _frameLimit)
+          _interruptLoop = true;
+      }
+
+      if (_throttle)
+      {
+        // Sleeps off the rest of the frame instead of spinning on the clock
+        _framePacer.WaitForNextFrame();
+      }
     }
 
     Cleanup();
@@ -86,15 +138,95 @@ namespace Core
 
   void Engine::Cleanup()
   {
+    // The renderer has to be done before the systems it reads from go away
+    _pipeline.Stop();
+
     auto itEnd = _systems.end();
     for (auto it = _systems.begin(); it != itEnd; ++it)
     {
+      PROFILE_ZONE_CATEGORY((*it)->GetName(), "Cleanup");
+      auto start = std::chrono::steady_clock::now();
       (*it)->Cleanup();
+      _telemetry.GetTimings(*it)->Record(SystemCall::Cleanup, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     }
+
+    _jobSystem.Shutdown();
+
+    PROFILE_WRITE_TRACE(PROFILER_TRACE_PATH);
   }
 
   void Engine::Stop()
   {
     _interruptLoop = true;
   }
+
+  HeadlessReport Engine::RunHeadless(const HeadlessOptions& options)
+  {
+    _interruptLoop = false;
+    _throttle = options.pacedFps > 0.0;
+    if (_throttle)
+    {
+      _targetFrameTime = 1.0 / options.pacedFps;
+      _pacingStrategy = options.pacing;
+      _framePacer.ClearStatistics();
+    }
+    _frameLimit = options.frameCount > 0 ? options.frameCount : 1;
+    _frameTimes.clear();
+    _frameTimes.reserve(_frameLimit);
+
+    if (options.simulatedDt > 0.0)
+    {
+      // Every read of the clock moves it on by exactly one dt
+      auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.simulatedDt));
+      auto simulatedTime = std::make_shared<std::chrono::steady_clock::time_point>();
+      _timeSource = [simulatedTime, step]() {
+        auto now = *simulatedTime;
+        *simulatedTime += step;
+        return now;
+      };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::clock_t cpuStart = std::clock();
+    Start();
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    HeadlessReport report;
+    report.frames = (unsigned int)_frameTimes.size();
+    report.wallSeconds = wallSeconds;
+    report.framesPerSecond = wallSeconds > 0.0 ? report.frames / wallSeconds : 0.0;
+    report.cpuSeconds = cpuSeconds;
+    report.memory = _frameMemory.GetStats();
+
+    if (!_frameTimes.empty())
+    {
+      std::vector<double> sorted = _frameTimes;
+      std::sort(sorted.begin(), sorted.end());
+
+      double total = 0.0;
+      for (double frameTime : sorted)
+      {
+        total += frameTime;
+      }
+      report.meanFrameTime = total / sorted.size();
+      report.p50FrameTime = sorted[(sorted.size() - 1) / 2];
+      report.p99FrameTime = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+      report.maxFrameTime = sorted.back();
+    }
+
+    _frameLimit = 0;
+    return report;
+  }
+
+  void HeadlessReport::Print(std::ostream& out)
+  {
+    out << frames << " frames in " << wallSeconds << " s, " << framesPerSecond << " frames/s" << std::endl
+      << "frame time ms: mean " << meanFrameTime * 1000.0
+      << ", p50 " << p50FrameTime * 1000.0
+      << ", p99 " << p99FrameTime * 1000.0
+      << ", max " << maxFrameTime * 1000.0 << std::endl
+      << "cpu " << cpuSeconds << " s, " << (wallSeconds > 0.0 ? cpuSeconds / wallSeconds * 100.0 : 0.0) << "% of a core" << std::endl;
+    memory.Print(out);
+  }
 }
\ No newline at end of file
@@ -1,19 +1,63 @@
 #pragma once
 
-#include "core\EngineSystem.h"
+#include "core/EngineSystem.h"
+#include "core/FixedTimestep.h"
+#include "core/FrameAllocator.h"
+#include "core/FramePipeline.h"
+#include "core/FramePacer.h"
+#include "core/JobSystem.h"
+#include "core/SystemScheduler.h"
+#include "core/SystemTelemetry.h"
 
+#include <chrono>
+#include <functional>
 #include <list>
+#include <ostream>
+#include <vector>
 
 #define FIXED_FPS 60
+#define MAX_FIXED_SUBSTEPS 5 // Most FixedUpdates per frame when catching up, the rest of the backlog is dropped
+
+#define JOB_WORKER_COUNT 0 // 0 uses one worker per hardware thread besides the main thread
+
+//#define DEBUG_SCHEDULE // Prints the system schedule every time it gets rebuilt
 
 #define THROTTLE_FPS
 #define TARGET_FPS 120
+#define FRAME_PACING_STRATEGY Core::PacingStrategy::Hybrid
 
 namespace Core
 {
+  struct HeadlessOptions
+  {
+    unsigned int frameCount = 1000;
+    double simulatedDt = 0.0; // Above 0 the loop sees this dt every frame instead of the real clock
+    double pacedFps = 0.0; // Above 0 the frame pacer holds each frame to this rate, otherwise frames run back to back
+    PacingStrategy pacing = FRAME_PACING_STRATEGY;
+  };
+
+  struct HeadlessReport
+  {
+    unsigned int frames = 0;
+    double wallSeconds = 0.0;
+    double framesPerSecond = 0.0;
+    // Wall time spent per frame, in seconds
+    double meanFrameTime = 0.0;
+    double p50FrameTime = 0.0;
+    double p99FrameTime = 0.0;
+    double maxFrameTime = 0.0;
+    // CPU time of the whole process over the run, all threads, in seconds
+    double cpuSeconds = 0.0;
+    FrameMemoryStats memory;
+
+    void Print(std::ostream& out);
+  };
+
   class Engine
   {
   public:
+    using TimeSource = std::function<std::chrono::steady_clock::time_point()>;
+
     Engine() {}
     static Engine* GetInstance()
     {
@@ -24,7 +68,27 @@ namespace Core
     void AddSystem(Systems::EngineSystem* system);
     void Start();
     void Stop();
+    // Runs frameCount frames as fast as possible without pacing, for servers and benchmarks.
+    // Only add systems that don't need a window or a GPU.
+    HeadlessReport RunHeadless(const HeadlessOptions& options);
     unsigned int GetFPS() { return framesPerSecond; }
+    // Blend factor between the last two fixed states for rendering, in [0, 1).
+    double GetInterpolationAlpha() { return _fixedTimestep.GetAlpha(); }
+    FixedTimestep* GetFixedTimestep() { return &_fixedTimestep; }
+    // Replaces the steady clock the loop reads, e.g. to feed it a synthetic clock.
+    void SetTimeSource(TimeSource timeSource) { _timeSource = timeSource; }
+    JobSystem* GetJobSystem() { return &_jobSystem; }
+    // Takes effect on Start, 0 uses one worker per spare hardware thread.
+    void SetWorkerCount(unsigned int workerCount) { _workerCount = workerCount; }
+    void SetThrottle(bool throttle) { _throttle = throttle; }
+    SystemScheduler* GetScheduler() { return &_scheduler; }
+    FramePacer* GetFramePacer() { return &_framePacer; }
+    SystemTelemetry* GetTelemetry() { return &_telemetry; }
+    // Every frame gets published as a snapshot to the consumer, takes effect on Start.
+    void SetRenderConsumer(RenderConsumer* consumer, PipelineMode mode) { _renderConsumer = consumer; _pipelineMode = mode; }
+    FramePipeline* GetPipeline() { return &_pipeline; }
+    // Frame lifetime allocations, see FrameMemory. Worker scratch is GetThreadScratch().
+    FrameMemory* GetFrameMemory() { return &_frameMemory; }
   protected:
     Engine(Engine const&) = delete;
     void operator=(Engine const&) = delete;
@@ -33,7 +97,30 @@ namespace Core
     void Cleanup();
   private:
     std::list<Systems::EngineSystem*> _systems;
+    JobSystem _jobSystem;
+    SystemScheduler _scheduler;
+    FramePacer _framePacer;
+    SystemTelemetry _telemetry;
+    FramePipeline _pipeline;
+    FrameMemory _frameMemory;
+    RenderConsumer* _renderConsumer = nullptr;
+    PipelineMode _pipelineMode = PipelineMode::DoubleBuffered;
+    FixedTimestep _fixedTimestep{ 1.0 / FIXED_FPS, MAX_FIXED_SUBSTEPS };
+    TimeSource _timeSource = []() { return std::chrono::steady_clock::now(); };
+    bool _scheduleDirty = true;
     bool _interruptLoop = false;
     unsigned int framesPerSecond = 0;
+    unsigned int _workerCount = JOB_WORKER_COUNT;
+    double _targetFrameTime = 1.0 / TARGET_FPS;
+    PacingStrategy _pacingStrategy = FRAME_PACING_STRATEGY;
+#ifdef THROTTLE_FPS
+    bool _throttle = true;
+#else
+    bool _throttle = false;
+#endif
+
+    // Frame limit and per frame wall times, only used by RunHeadless
+    unsigned int _frameLimit = 0;
+    std::vector<double> _frameTimes;
   };
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "PrecompiledHeader.h"
+#include "core/IndexWidthBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Loader.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+  // Loads path into loader, best is the quickest load so far or 0
+  bool timeLoad(objl::Loader& loader, const std::string& path, double& best)
+  {
+    auto start = std::chrono::steady_clock::now();
+    bool loaded = Core::LoadObjQuietly(loader, path);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (best == 0.0 || milliseconds < best)
+      best = milliseconds;
+    return loaded;
+  }
+
+  template <typename T>
+  size_t capacityBytes(const std::vector<T>& list)
+  {
+    return list.capacity() * sizeof(T);
+  }
+
+  // Geometry the loader holds on to after a load, every copy of it
+  size_t heldBytes(const objl::Loader& loader)
+  {
+    size_t bytes = capacityBytes(loader.LoadedVertices) + capacityBytes(loader.LoadedIndices);
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+      bytes += capacityBytes(mesh.Vertices) + capacityBytes(mesh.Indices);
+    for (const objl::CompactMesh& mesh : loader.LoadedCompactMeshes)
+      bytes += capacityBytes(mesh.Vertices) + capacityBytes(mesh.Indices16) + capacityBytes(mesh.Indices32);
+    return bytes;
+  }
+
+  bool sameVertex(const objl::Vertex& a, const objl::Vertex& b)
+  {
+    return std::memcmp(&a, &b, sizeof(objl::Vertex)) == 0;
+  }
+
+  bool sameParts(const objl::CompactMesh& a, const objl::CompactMesh& b)
+  {
+    return a.MeshName == b.MeshName && a.MaterialIndex == b.MaterialIndex && a.SourceMesh == b.SourceMesh
+      && a.Indices16 == b.Indices16 && a.Indices32 == b.Indices32 && a.Vertices.size() == b.Vertices.size()
+      && (a.Vertices.empty() || std::memcmp(a.Vertices.data(), b.Vertices.data(), a.Vertices.size() * sizeof(objl::Vertex)) == 0);
+  }
+
+  std::string megabytes(size_t bytes)
+  {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0);
+    return text.str();
+  }
+}
+
+namespace Core
+{
+  std::vector<IndexWidthResult> RunIndexWidthBenchmark(const std::vector<std::string>& paths, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<IndexWidthResult> results;
+    if (repeats == 0)
+      repeats = 1;
+
+    for (const std::string& path : paths)
+    {
+      IndexWidthResult result;
+      result.path = path;
+
+      objl::Loader plain;
+      plain.CompactIndices = false;
+      objl::Loader compact;
+      compact.CompactMeshesOnly = true;
+      // Take turns so neither load always finds the heap the other left
+      bool loaded = true;
+      for (unsigned int repeat = 0; repeat < repeats && loaded; ++repeat)
+        loaded = timeLoad(plain, path, result.loadMilliseconds) && timeLoad(compact, path, result.compactMilliseconds);
+      if (!loaded)
+      {
+        if (out)
+          *out << "can't load " << path << std::endl;
+        continue;
+      }
+      result.heldBytes = heldBytes(plain);
+      result.compactHeldBytes = heldBytes(compact);
+
+      // The compaction on its own, over the plain meshes
+      for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+      {
+        std::vector<objl::CompactMesh> parts;
+        parts.reserve(plain.LoadedMeshes.size());
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < plain.LoadedMeshes.size(); ++i)
+          objl::algorithm::ToCompactMeshes(plain.LoadedMeshes[i], i, true, parts);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (repeat == 0 || milliseconds < result.compactionMilliseconds)
+          result.compactionMilliseconds = milliseconds;
+      }
+
+      result.meshes = plain.LoadedMeshes.size();
+      for (const objl::Mesh& mesh : plain.LoadedMeshes)
+      {
+        result.vertices += mesh.Vertices.size();
+        result.indexBytes += mesh.Indices.size() * sizeof(unsigned int);
+        result.largeMeshes += mesh.Vertices.size() > objl::CompactMesh::Max16BitVertices;
+      }
+
+      // Parts of a mesh are next to each other, their triangles in the mesh's order
+      result.parts = compact.LoadedCompactMeshes.size();
+      size_t source = SIZE_MAX;
+      size_t triangle = 0;
+      for (const objl::CompactMesh& part : compact.LoadedCompactMeshes)
+      {
+        result.splitVertices += part.Vertices.size();
+        result.compactBytes += part.IndexBytes();
+        if (part.SourceMesh != source)
+        {
+          source = part.SourceMesh;
+          triangle = 0;
+        }
+        const objl::Mesh& mesh = plain.LoadedMeshes[source];
+        result.mismatches += part.MeshName != mesh.MeshName || part.MaterialIndex != mesh.MaterialIndex;
+        for (size_t i = 0; i + 2 < part.IndexCount(); i += 3, ++triangle)
+        {
+          bool same = triangle * 3 + 2 < mesh.Indices.size();
+          for (size_t corner = 0; corner < 3 && same; ++corner)
+            same = sameVertex(part.Vertices[part.Index(i + corner)], mesh.Vertices[mesh.Indices[triangle * 3 + corner]]);
+          result.mismatches += !same;
+        }
+      }
+
+      objl::Loader unsplit;
+      unsplit.SplitLargeMeshes = false;
+      double unsplitMilliseconds = 0.0;
+      if (timeLoad(unsplit, path, unsplitMilliseconds))
+      {
+        for (const objl::CompactMesh& mesh : unsplit.LoadedCompactMeshes)
+          result.unsplitBytes += mesh.IndexBytes();
+      }
+
+      // A pooled load compacts its ranges to the same parts
+      objl::Loader pooled;
+      pooled.PoolMeshes = true;
+      double pooledMilliseconds = 0.0;
+      if (!timeLoad(pooled, path, pooledMilliseconds) || pooled.LoadedCompactMeshes.size() != compact.LoadedCompactMeshes.size())
+        ++result.mismatches;
+      else
+      {
+        for (size_t i = 0; i < pooled.LoadedCompactMeshes.size(); ++i)
+          result.mismatches += !sameParts(pooled.LoadedCompactMeshes[i], compact.LoadedCompactMeshes[i]);
+      }
+
+      results.push_back(result);
+    }
+
+    if (out)
+    {
+      IndexWidthResult total;
+      total.path = "total";
+      *out << "file\t\t\tmeshes\tlarge\tparts\tvertices\tsplit\t32 bit MB\tunsplit MB\tsplit MB\tsaved\theld MB\tcompact held MB\t"
+        << "load ms\tcompact ms\tcompaction ms\tmismatch" << std::endl;
+      auto row = [&](const IndexWidthResult& result)
+      {
+        double saved = result.indexBytes ? 100.0 * (1.0 - (double)result.compactBytes / result.indexBytes) : 0.0;
+        *out << std::left << std::setw(24) << result.path << std::right << result.meshes << "\t" << result.largeMeshes << "\t"
+          << result.parts << "\t" << result.vertices << "\t\t" << result.splitVertices << "\t" << megabytes(result.indexBytes) << "\t\t"
+          << megabytes(result.unsplitBytes) << "\t\t" << megabytes(result.compactBytes) << "\t\t" << std::fixed << std::setprecision(1)
+          << saved << "%\t" << megabytes(result.heldBytes) << "\t" << megabytes(result.compactHeldBytes) << "\t\t" << std::setprecision(2)
+          << result.loadMilliseconds << "\t" << result.compactMilliseconds << "\t\t" << result.compactionMilliseconds << "\t\t"
+          << result.mismatches << std::endl;
+        out->unsetf(std::ios::floatfield);
+        *out << std::setprecision(6);
+      };
+      for (const IndexWidthResult& result : results)
+      {
+        row(result);
+        total.meshes += result.meshes;
+        total.largeMeshes += result.largeMeshes;
+        total.parts += result.parts;
+        total.vertices += result.vertices;
+        total.splitVertices += result.splitVertices;
+        total.indexBytes += result.indexBytes;
+        total.compactBytes += result.compactBytes;
+        total.unsplitBytes += result.unsplitBytes;
+        total.heldBytes += result.heldBytes;
+        total.compactHeldBytes += result.compactHeldBytes;
+        total.loadMilliseconds += result.loadMilliseconds;
+        total.compactMilliseconds += result.compactMilliseconds;
+        total.compactionMilliseconds += result.compactionMilliseconds;
+        total.mismatches += result.mismatches;
+      }
+      if (results.size() > 1)
+        row(total);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct IndexWidthResult
+  {
+    std::string path;
+    size_t meshes = 0;              // LoadedMeshes of a plain load
+    size_t largeMeshes = 0;         // Meshes with more vertices than 16 bit indices reach
+    size_t parts = 0;               // LoadedCompactMeshes with SplitLargeMeshes
+    size_t vertices = 0;            // Welded vertices of a plain load
+    size_t splitVertices = 0;       // Vertices of the parts, the ones on a cut are in more than one
+    size_t indexBytes = 0;          // Every index as 32 bits
+    size_t compactBytes = 0;        // LoadedCompactMeshes with SplitLargeMeshes
+    size_t unsplitBytes = 0;        // LoadedCompactMeshes without SplitLargeMeshes
+    size_t heldBytes = 0;           // Vertices and indices a plain load keeps, LoadedVertices and LoadedIndices too
+    size_t compactHeldBytes = 0;    // Vertices and indices a load with CompactMeshesOnly keeps
+    double loadMilliseconds = 0.0;  // Plain load, best of the repeats
+    double compactMilliseconds = 0.0; // Load with CompactIndices, best of the repeats
+    double compactionMilliseconds = 0.0; // Just turning the plain meshes into compact ones, best of the repeats
+    size_t mismatches = 0;          // Triangles of the parts that aren't the mesh's in order, and pooled parts that differ
+  };
+
+  // Loads every .obj in paths with welded vertices as they are and with Loader::CompactMeshesOnly, with
+  // and without splitting the meshes too big for 16 bit indices, checks the parts put back together
+  // are the meshes and that a pooled load gives the same parts, and reports the index memory each way,
+  // what each load holds on to in all and how long the compaction takes, with a total over all of them.
+  std::vector<IndexWidthResult> RunIndexWidthBenchmark(const std::vector<std::string>& paths, unsigned int repeats, std::ostream* out = nullptr);
+}
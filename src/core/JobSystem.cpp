@@ -0,0 +1,249 @@
+#include "PrecompiledHeader.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+
+#include <string>
+
+namespace Core
+{
+  // Which job system (if any) owns a queue for the current thread, and which one.
+  static thread_local JobSystem* threadJobSystem = nullptr;
+  static thread_local unsigned int threadQueueIndex = 0;
+
+  bool WorkStealingQueue::Push(Job* job)
+  {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t > mask)
+      return false;
+
+    jobs[b & mask].store(job, std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  Job* WorkStealingQueue::Pop()
+  {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+      // Empty
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Job* job = jobs[b & mask].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+      // Last job, race the thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        job = nullptr;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  Job* WorkStealingQueue::Steal()
+  {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+      return nullptr;
+
+    Job* job = jobs[t & mask].load(std::memory_order_acquire);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return nullptr;
+    return job;
+  }
+
+  void JobSystem::Initialize(unsigned int workerCount)
+  {
+    if (_running)
+      return;
+
+    _running = true;
+    for (unsigned int i = 0; i <= workerCount; ++i)
+    {
+      _queues.push_back(std::make_unique<WorkStealingQueue>());
+    }
+
+    threadJobSystem = this;
+    threadQueueIndex = 0;
+
+    for (unsigned int i = 1; i <= workerCount; ++i)
+    {
+      _workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+  }
+
+  void JobSystem::Shutdown()
+  {
+    if (!_running)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(_wakeMutex);
+      _running = false;
+    }
+    _wakeCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+      worker.join();
+    }
+    _workers.clear();
+
+    // Run anything still queued so its counters reach zero and nobody
+    // waiting on them hangs, there are no workers left to submit to now
+    while (Job* job = getJob())
+    {
+      execute(job);
+    }
+    _queues.clear();
+
+    if (threadJobSystem == this)
+      threadJobSystem = nullptr;
+  }
+
+  void JobSystem::Submit(std::function<void()> function, JobCounter* counter)
+  {
+    Job* job = new Job{ std::move(function), counter };
+    if (counter)
+      counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    // Without workers there is nobody to hand it to
+    if (!_running || _workers.empty())
+    {
+      execute(job);
+      return;
+    }
+
+    _pendingJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (threadJobSystem != this || !_queues[threadQueueIndex]->Push(job))
+    {
+      std::lock_guard<std::mutex> lock(_sharedMutex);
+      _sharedJobs.push_back(job);
+      _sharedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    // Pairs with the sleeping worker re-checking _pendingJobs under the wake mutex
+    if (_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+      { std::lock_guard<std::mutex> lock(_wakeMutex); }
+      _wakeCondition.notify_one();
+    }
+  }
+
+  void JobSystem::Wait(JobCounter& counter)
+  {
+    while (counter.pending.load(std::memory_order_acquire) > 0)
+    {
+      // Help out instead of blocking
+      if (Job* job = getJob())
+        execute(job);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  bool JobSystem::TryRunJob()
+  {
+    Job* job = getJob();
+    if (!job)
+      return false;
+
+    execute(job);
+    return true;
+  }
+
+  void JobSystem::workerLoop(unsigned int queueIndex)
+  {
+    threadJobSystem = this;
+    threadQueueIndex = queueIndex;
+    PROFILE_THREAD_NAME("Worker " + std::to_string(queueIndex));
+
+    const int spinsBeforeSleep = 64;
+    int idleSpins = 0;
+
+    while (_running.load(std::memory_order_relaxed))
+    {
+      if (Job* job = getJob())
+      {
+        execute(job);
+        idleSpins = 0;
+        continue;
+      }
+
+      if (++idleSpins < spinsBeforeSleep)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(_wakeMutex);
+      _sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+      _wakeCondition.wait(lock, [this]() {
+        return _pendingJobs.load(std::memory_order_seq_cst) > 0 || !_running.load(std::memory_order_relaxed);
+      });
+      _sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+      idleSpins = 0;
+    }
+  }
+
+  Job* JobSystem::getJob()
+  {
+    if (_queues.empty())
+      return nullptr;
+
+    Job* job = nullptr;
+    unsigned int queueCount = (unsigned int)_queues.size();
+    bool ownsQueue = threadJobSystem == this;
+
+    if (ownsQueue)
+      job = _queues[threadQueueIndex]->Pop();
+
+    if (!job && _sharedCount.load(std::memory_order_acquire) > 0)
+    {
+      std::lock_guard<std::mutex> lock(_sharedMutex);
+      if (!_sharedJobs.empty())
+      {
+        job = _sharedJobs.front();
+        _sharedJobs.pop_front();
+        _sharedCount.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    if (!job)
+    {
+      // Start stealing at a different victim per thread so thieves spread out
+      unsigned int start = ownsQueue ? threadQueueIndex + 1 : 0;
+      for (unsigned int i = 0; i < queueCount && !job; ++i)
+      {
+        unsigned int victim = (start + i) % queueCount;
+        if (ownsQueue && victim == threadQueueIndex)
+          continue;
+        job = _queues[victim]->Steal();
+        if (job)
+          _stealCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    if (job)
+      _pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+  }
+
+  void JobSystem::execute(Job* job)
+  {
+    job->function();
+    if (job->counter)
+      job->counter->pending.fetch_sub(1, std::memory_order_release);
+    delete job;
+  }
+}
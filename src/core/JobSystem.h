@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define JOB_QUEUE_CAPACITY 4096 // Must be a power of two, jobs past this spill into the shared queue.
+
+namespace Core
+{
+  // Counts the outstanding jobs of a batch, Wait() on it until it hits zero.
+  struct JobCounter
+  {
+    std::atomic<int> pending{ 0 };
+  };
+
+  struct Job
+  {
+    std::function<void()> function;
+    JobCounter* counter = nullptr;
+  };
+
+  // Chase-Lev deque, the owning thread pushes and pops from the bottom
+  // while every other thread steals from the top.
+  class WorkStealingQueue
+  {
+  public:
+    bool Push(Job* job);
+    Job* Pop();
+    Job* Steal();
+  private:
+    static constexpr int64_t mask = JOB_QUEUE_CAPACITY - 1;
+
+    alignas(64) std::atomic<int64_t> top{ 0 };
+    alignas(64) std::atomic<int64_t> bottom{ 0 };
+    std::atomic<Job*> jobs[JOB_QUEUE_CAPACITY] = {};
+  };
+
+  class JobSystem
+  {
+  public:
+    JobSystem() {}
+    ~JobSystem() { Shutdown(); }
+
+    // The calling thread becomes the main thread and takes part in the work while waiting.
+    void Initialize(unsigned int workerCount);
+    void Shutdown();
+
+    void Submit(std::function<void()> function, JobCounter* counter = nullptr);
+    void Wait(JobCounter& counter);
+    // Runs one queued job on the calling thread, false if there was nothing to run.
+    bool TryRunJob();
+
+    // Splits [0, count) into batches of batchSize and calls function(begin, end) for each batch.
+    template<typename Function>
+    void ParallelFor(size_t count, size_t batchSize, Function&& function)
+    {
+      if (count == 0)
+        return;
+      if (batchSize == 0)
+        batchSize = 1;
+
+      JobCounter counter;
+      for (size_t begin = 0; begin < count; begin += batchSize)
+      {
+        size_t end = begin + batchSize < count ? begin + batchSize : count;
+        Submit([&function, begin, end]() { function(begin, end); }, &counter);
+      }
+      Wait(counter);
+    }
+
+    unsigned int GetWorkerCount() { return (unsigned int)_workers.size(); }
+    // Number of jobs that were taken from another thread's queue.
+    uint64_t GetStealCount() { return _stealCount.load(std::memory_order_relaxed); }
+  protected:
+    JobSystem(JobSystem const&) = delete;
+    void operator=(JobSystem const&) = delete;
+  private:
+    void workerLoop(unsigned int queueIndex);
+    Job* getJob();
+    void execute(Job* job);
+
+    // Index 0 belongs to the main thread, the rest to the workers.
+    std::vector<std::unique_ptr<WorkStealingQueue>> _queues;
+    std::vector<std::thread> _workers;
+    std::atomic<bool> _running{ false };
+
+    // Jobs submitted from threads that do not own a queue.
+    std::mutex _sharedMutex;
+    std::deque<Job*> _sharedJobs;
+    std::atomic<int> _sharedCount{ 0 };
+
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    std::atomic<int> _pendingJobs{ 0 };
+    std::atomic<int> _sleepingWorkers{ 0 };
+
+    std::atomic<uint64_t> _stealCount{ 0 };
+  };
+}
@@ -0,0 +1,102 @@
+#include "PrecompiledHeader.h"
+#include "core/JobSystemBenchmark.h"
+#include "core/FrameAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace Systems
+{
+  unsigned int SyntheticLoad::instanceCount = 0;
+
+  void SyntheticLoad::Update(float /*dt*/)
+  {
+    unsigned int iterations = iterationsPerItem;
+    double* out = results.data();
+    jobSystem->ParallelFor(results.size(), 16, [out, iterations](size_t begin, size_t end) {
+      // Work on a scratch copy of the batch like a real system building temporaries would
+      Core::ScratchScope scratch;
+      std::vector<double, Core::ScratchAllocator<double>> values(end - begin, 0.0, Core::ScratchAllocator<double>(scratch.GetStack()));
+      for (size_t i = begin; i < end; ++i)
+      {
+        double value = (double)i;
+        for (unsigned int j = 0; j < iterations; ++j)
+        {
+          value = std::sin(value) * 0.5 + std::sqrt(value * value + 1.0);
+        }
+        values[i - begin] = value;
+      }
+      std::copy(values.begin(), values.end(), out + begin);
+    });
+  }
+
+  bool SyntheticLoad::DeclareAccess(SystemPhase /*phase*/, SystemAccess& access)
+  {
+    // Only ever touches its own results
+    access.Write(resultsName);
+    return true;
+  }
+
+  double SyntheticLoad::GetChecksum()
+  {
+    double sum = 0.0;
+    for (double value : results)
+    {
+      sum += value;
+    }
+    return sum;
+  }
+}
+
+namespace Core
+{
+  std::vector<JobScalingResult> RunJobScalingBenchmark(unsigned int maxWorkers, unsigned int frameCount, std::ostream* out)
+  {
+    const size_t workItems = 4096;
+    const unsigned int iterationsPerItem = 256;
+
+    std::vector<JobScalingResult> results;
+    if (out)
+    {
+      *out << "workers\tframes/s\titems/s\tspeedup\tsteals" << std::endl;
+    }
+
+    for (unsigned int workers = 0; workers <= maxWorkers; ++workers)
+    {
+      JobSystem jobSystem;
+      jobSystem.Initialize(workers);
+      Systems::SyntheticLoad load(&jobSystem, workItems, iterationsPerItem);
+
+      // One untimed frame so thread start up doesn't count
+      load.Update(0.0f);
+
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned int frame = 0; frame < frameCount; ++frame)
+      {
+        load.Update(0.0f);
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      JobScalingResult result;
+      result.workerCount = workers;
+      result.framesPerSecond = seconds > 0.0 ? frameCount / seconds : 0.0;
+      result.itemsPerSecond = result.framesPerSecond * workItems;
+      result.speedup = results.empty() || results[0].framesPerSecond == 0.0 ? 1.0 : result.framesPerSecond / results[0].framesPerSecond;
+      result.steals = jobSystem.GetStealCount();
+      results.push_back(result);
+
+      jobSystem.Shutdown();
+
+      if (out)
+      {
+        *out << std::fixed << std::setprecision(2)
+          << result.workerCount << "\t" << result.framesPerSecond << "\t" << result.itemsPerSecond
+          << "\t" << result.speedup << "\t" << result.steals << std::endl;
+      }
+    }
+
+    return results;
+  }
+}
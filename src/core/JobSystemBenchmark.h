@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/EngineSystem.h"
+#include "core/JobSystem.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Systems
+{
+  // Burns a fixed amount of floating point work every Update, split across the job system.
+  class SyntheticLoad : public EngineSystem
+  {
+  public:
+    SyntheticLoad(Core::JobSystem* jobSystem, size_t workItems, unsigned int iterationsPerItem)
+      : jobSystem(jobSystem), results(workItems), iterationsPerItem(iterationsPerItem),
+        resultsName("SyntheticLoad " + std::to_string(instanceCount++)) {}
+
+    virtual void Initialize() {}
+    virtual void Update(float dt);
+    virtual void FixedUpdate(float /*dt*/) {}
+    virtual void Cleanup() {}
+    virtual const char* GetName() { return "SyntheticLoad"; }
+    virtual bool RequiresMainThread() { return false; }
+    virtual bool DeclareAccess(SystemPhase phase, SystemAccess& access);
+
+    size_t GetWorkItems() { return results.size(); }
+    double GetChecksum();
+  private:
+    Core::JobSystem* jobSystem;
+    std::vector<double> results;
+    unsigned int iterationsPerItem;
+    // The resource its results are to the scheduler, one per instance so loads don't conflict
+    std::string resultsName;
+    static unsigned int instanceCount;
+  };
+}
+
+namespace Core
+{
+  struct JobScalingResult
+  {
+    unsigned int workerCount = 0;
+    double framesPerSecond = 0.0;
+    double itemsPerSecond = 0.0;
+    double speedup = 1.0; // relative to zero workers (main thread only)
+    uint64_t steals = 0;
+  };
+
+  // Runs the synthetic load for frameCount frames with 0..maxWorkers workers and
+  // reports the throughput of each, optionally printing a table to out.
+  std::vector<JobScalingResult> RunJobScalingBenchmark(unsigned int maxWorkers, unsigned int frameCount, std::ostream* out = nullptr);
+}
@@ -0,0 +1,250 @@
+#include "PrecompiledHeader.h"
+#include "core/MeshletBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Meshlet.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+  std::vector<std::array<unsigned int, 3>> sortedTriangles(const std::vector<unsigned int>& indices)
+  {
+    std::vector<std::array<unsigned int, 3>> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); ++t)
+      triangles[t] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  }
+
+  // The mesh's triangles back out of its meshlets
+  std::vector<unsigned int> meshletIndices(const objl::meshlet::MeshletMesh& meshlets)
+  {
+    std::vector<unsigned int> indices;
+    for (const objl::meshlet::Meshlet& meshlet : meshlets.Meshlets)
+    {
+      for (uint32_t t = 0; t < meshlet.PrimitiveCount; ++t)
+      {
+        uint32_t corners[3];
+        objl::meshlet::UnpackPrimitive(meshlets.Primitives[meshlet.PrimitiveOffset + t], corners);
+        for (uint32_t corner : corners)
+          indices.push_back(corner < meshlet.VertexCount ? meshlets.Vertices[meshlet.VertexOffset + corner] : UINT32_MAX);
+      }
+    }
+    return indices;
+  }
+
+  struct Build
+  {
+    const char* name;
+    float coneWeight;
+    bool optimizeOrder;
+  };
+
+  // Fibonacci spiral of directions over the sphere
+  objl::Vector3 viewDirection(unsigned int view, unsigned int views)
+  {
+    float y = 1.0f - 2.0f * (view + 0.5f) / views;
+    float ring = std::sqrt(std::max(0.0f, 1.0f - y * y));
+    float angle = view * 2.39996323f;
+    return objl::Vector3(std::cos(angle) * ring, y, std::sin(angle) * ring);
+  }
+
+  // Whether a triangle on its own would be drawn: facing the camera and not wholly outside one plane
+  bool triangleVisible(const objl::meshlet::Frustum& frustum, const objl::Vector3& a, const objl::Vector3& b, const objl::Vector3& c)
+  {
+    using objl::math::DotV3;
+    objl::Vector3 normal = objl::math::CrossV3(b - a, c - a);
+    float length = objl::math::MagnitudeV3(normal);
+    objl::Vector3 view = frustum.Position - a;
+    // Edge on triangles count as facing away, they draw nothing
+    if (length == 0.0f || DotV3(view, normal) <= 1e-4f * length * objl::math::MagnitudeV3(view))
+      return false;
+    for (int plane = 0; plane < 6; ++plane)
+    {
+      const objl::Vector3& n = frustum.Normals[plane];
+      float d = frustum.Distances[plane];
+      if (DotV3(n, a) + d < 0.0f && DotV3(n, b) + d < 0.0f && DotV3(n, c) + d < 0.0f)
+        return false;
+    }
+    return true;
+  }
+
+  struct Culled
+  {
+    double culled = 0.0;
+    double ideal = 0.0;
+    size_t unsafe = 0;
+  };
+
+  // Culls every meshlet from each view, fractions are of the mesh's triangles summed over the views
+  void cullViews(const objl::Mesh& mesh, const objl::meshlet::MeshletMesh& meshlets, const objl::Vector3& center, float radius,
+    bool close, unsigned int views, Culled& culled)
+  {
+    size_t triangleCount = meshlets.Primitives.size();
+    if (triangleCount == 0)
+      return;
+    for (unsigned int view = 0; view < views; ++view)
+    {
+      objl::Vector3 direction = viewDirection(view, views);
+      objl::Vector3 up = std::abs(direction.Y) > 0.9f ? objl::Vector3(1.0f, 0.0f, 0.0f) : objl::Vector3(0.0f, 1.0f, 0.0f);
+      // Orbit views see all of the mesh, near views a part of it a little over a third of its size across
+      objl::meshlet::Frustum frustum = close
+        ? objl::meshlet::MakeFrustum(center + direction * (radius * 1.2f), center, up, 0.7f, 1.0f, radius * 0.01f, radius * 4.0f)
+        : objl::meshlet::MakeFrustum(center + direction * (radius * 3.0f), center, up, 1.0f, 1.0f, radius * 0.1f, radius * 6.0f);
+
+      size_t culledTriangles = 0, drawnTriangles = 0;
+      for (size_t m = 0; m < meshlets.Meshlets.size(); ++m)
+      {
+        const objl::meshlet::Meshlet& meshlet = meshlets.Meshlets[m];
+        bool cull = objl::meshlet::Cull(meshlets.MeshletBounds[m], frustum) != objl::meshlet::CullResult::Visible;
+        bool unsafe = false;
+        for (uint32_t t = 0; t < meshlet.PrimitiveCount; ++t)
+        {
+          uint32_t corners[3];
+          objl::meshlet::UnpackPrimitive(meshlets.Primitives[meshlet.PrimitiveOffset + t], corners);
+          const uint32_t* vertices = meshlets.Vertices.data() + meshlet.VertexOffset;
+          bool visible = triangleVisible(frustum, mesh.Vertices[vertices[corners[0]]].Position,
+            mesh.Vertices[vertices[corners[1]]].Position, mesh.Vertices[vertices[corners[2]]].Position);
+          drawnTriangles += visible;
+          unsafe = unsafe || (cull && visible);
+        }
+        if (cull)
+          culledTriangles += meshlet.PrimitiveCount;
+        culled.unsafe += unsafe;
+      }
+      culled.culled += (double)culledTriangles / triangleCount;
+      culled.ideal += 1.0 - (double)drawnTriangles / triangleCount;
+    }
+  }
+}
+
+namespace Core
+{
+  std::vector<MeshletResult> RunMeshletBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<MeshletResult> results;
+
+    objl::Loader loader;
+    if (!LoadObjQuietly(loader, path, out))
+      return results;
+    if (repeats == 0)
+      repeats = 1;
+
+    const Build builds[] = {
+      { "file order", 0.25f, false },
+      { "cone 0", 0.0f, true },
+      { "cone 0.25", 0.25f, true },
+      { "cone 0.5", 0.5f, true },
+      { "cone 1", 1.0f, true },
+    };
+    const unsigned int views = 32;
+
+    size_t triangleCount = 0, vertexCount = 0;
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+    {
+      triangleCount += mesh.Indices.size() / 3;
+      vertexCount += mesh.Vertices.size();
+    }
+
+    for (const Build& build : builds)
+    {
+      MeshletResult result;
+      result.build = build.name;
+      objl::meshlet::Options options;
+      options.ConeWeight = build.coneWeight;
+      options.OptimizeOrder = build.optimizeOrder;
+      size_t meshletVertices = 0;
+      Culled orbit, close;
+      size_t meshesCulled = 0;
+
+      for (const objl::Mesh& mesh : loader.LoadedMeshes)
+      {
+        size_t indexCount = mesh.Indices.size() - mesh.Indices.size() % 3;
+        if (indexCount == 0)
+          continue;
+
+        objl::meshlet::MeshletMesh meshlets;
+        double best = 0.0;
+        for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+        {
+          auto start = std::chrono::steady_clock::now();
+          objl::meshlet::BuildMeshlets(meshlets, mesh.Indices.data(), indexCount, mesh.Vertices.data(), mesh.Vertices.size(), options);
+          double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+          if (repeat == 0 || milliseconds < best)
+            best = milliseconds;
+        }
+        result.milliseconds += best;
+
+        bool wrong = false;
+        for (const objl::meshlet::Meshlet& meshlet : meshlets.Meshlets)
+          wrong = wrong || meshlet.VertexCount > options.MaxVertices || meshlet.PrimitiveCount > options.MaxTriangles;
+        std::vector<unsigned int> original(mesh.Indices.begin(), mesh.Indices.begin() + indexCount);
+        if (wrong || sortedTriangles(meshletIndices(meshlets)) != sortedTriangles(original))
+          ++result.wrongMeshes;
+
+        result.meshlets += meshlets.Meshlets.size();
+        meshletVertices += meshlets.Vertices.size();
+        result.packedBytes += meshlets.Meshlets.size() * (sizeof(objl::meshlet::Meshlet) + sizeof(objl::meshlet::Bounds))
+          + meshlets.Vertices.size() * sizeof(uint32_t) + meshlets.Primitives.size() * sizeof(uint32_t);
+        result.indexBytes += indexCount * sizeof(unsigned int);
+
+        // Views are framed on the mesh's own bounding sphere
+        std::vector<uint32_t> everyVertex(mesh.Vertices.size());
+        for (size_t v = 0; v < everyVertex.size(); ++v)
+          everyVertex[v] = (uint32_t)v;
+        objl::Vector3 center;
+        float radius = 0.0f;
+        objl::meshlet::boundingSphere(mesh.Vertices.data(), everyVertex.data(), everyVertex.size(), center, radius);
+        if (radius <= 0.0f)
+          continue;
+        cullViews(mesh, meshlets, center, radius, false, views, orbit);
+        cullViews(mesh, meshlets, center, radius, true, views, close);
+        ++meshesCulled;
+      }
+
+      if (result.meshlets > 0)
+      {
+        result.verticesPerMeshlet = (float)meshletVertices / result.meshlets;
+        result.trianglesPerMeshlet = (float)triangleCount / result.meshlets;
+      }
+      result.vertexDuplication = vertexCount > 0 ? (float)meshletVertices / vertexCount : 0.0f;
+      if (result.milliseconds > 0.0)
+        result.trianglesPerSecond = triangleCount / (result.milliseconds / 1000.0);
+      if (meshesCulled > 0)
+      {
+        double samples = (double)meshesCulled * views;
+        result.orbitCulled = (float)(orbit.culled / samples);
+        result.closeCulled = (float)(close.culled / samples);
+        result.orbitIdeal = (float)(orbit.ideal / samples);
+        result.closeIdeal = (float)(close.ideal / samples);
+      }
+      result.unsafeCulls = orbit.unsafe + close.unsafe;
+      results.push_back(result);
+    }
+
+    if (out)
+    {
+      *out << path << ": " << loader.LoadedMeshes.size() << " meshes, " << triangleCount << " triangles, " << vertexCount
+        << " welded vertices, culled from " << views << " orbit and " << views << " near views per mesh" << std::endl;
+      *out << "build\t\tmeshlets\tverts\ttris\tdup\tms\tM tri/s\tbytes/tri\torbit\tideal\tnear\tideal\tunsafe\twrong" << std::endl;
+      for (const MeshletResult& result : results)
+      {
+        *out << std::left << std::setw(16) << result.build << std::right << result.meshlets << "\t\t" << std::fixed << std::setprecision(1)
+          << result.verticesPerMeshlet << "\t" << result.trianglesPerMeshlet << "\t" << std::setprecision(3) << result.vertexDuplication
+          << "\t" << std::setprecision(1) << result.milliseconds << "\t" << std::setprecision(2) << result.trianglesPerSecond / 1000000.0
+          << "\t" << (triangleCount > 0 ? (double)result.packedBytes / triangleCount : 0.0) << "\t\t" << std::setprecision(3)
+          << result.orbitCulled << "\t" << result.orbitIdeal << "\t" << result.closeCulled << "\t" << result.closeIdeal << "\t"
+          << result.unsafeCulls << "\t" << result.wrongMeshes << std::endl;
+      }
+      *out << "plain 32 bit indices: " << std::setprecision(2) << 3.0 * sizeof(unsigned int) << " bytes/tri" << std::endl;
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
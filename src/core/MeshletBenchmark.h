@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct MeshletResult
+  {
+    std::string build;                // Which objl::meshlet::Options the row is
+    size_t meshlets = 0;              // Of every mesh
+    float verticesPerMeshlet = 0.0f;  // Mean, out of 64
+    float trianglesPerMeshlet = 0.0f; // Mean, out of 124
+    float vertexDuplication = 0.0f;   // Meshlet vertices over mesh vertices, 1 if no vertex is in two meshlets
+    double milliseconds = 0.0;        // Building every mesh's meshlets, best of the repeats
+    double trianglesPerSecond = 0.0;  // Triangles going in over the time
+    size_t packedBytes = 0;           // Meshlets, bounds, vertex indices and primitives
+    size_t indexBytes = 0;            // The plain 32 bit index buffer, for comparison
+    float orbitCulled = 0.0f;         // Triangles in culled meshlets, mean over views of the whole mesh
+    float closeCulled = 0.0f;         // The same over views of part of the mesh from near it
+    float orbitIdeal = 0.0f;          // Triangles culled one at a time for facing away or being outside, orbit views
+    float closeIdeal = 0.0f;          // The same for the near views
+    size_t unsafeCulls = 0;           // Culled meshlets holding a triangle that should have been drawn
+    size_t wrongMeshes = 0;           // Meshes whose meshlets don't make exactly their triangles
+  };
+
+  // Loads the .obj at path with welded vertices, builds every mesh's meshlets with objl::meshlet
+  // at a few cone weights and in the file's own triangle order, and culls them with
+  // objl::meshlet::Cull from 32 views around the whole mesh and 32 views of part of it from near
+  // it, against what culling each triangle on its own would have removed.
+  std::vector<MeshletResult> RunMeshletBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
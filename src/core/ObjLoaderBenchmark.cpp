@@ -0,0 +1,684 @@
+#include "PrecompiledHeader.h"
+#include "core/ObjLoaderBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _WIN32
+#include <psapi.h>
+#endif
+
+namespace Core
+{
+  QuietConsole::QuietConsole()
+    : console(std::cout.rdbuf(&nullBuffer))
+  {
+  }
+
+  QuietConsole::~QuietConsole()
+  {
+    std::cout.rdbuf(console);
+  }
+
+  bool LoadObjQuietly(objl::Loader& loader, const std::string& path, std::ostream* out)
+  {
+    loader.WeldVertices = true;
+    bool loaded;
+    {
+      QuietConsole quiet;
+      loaded = loader.LoadFile(path, objl::LoadMode::Mapped);
+    }
+    if (!loaded && out)
+      *out << "can't load " << path << std::endl;
+    return loaded;
+  }
+
+  // Start counting the peak resident memory again from what is resident now, false if the
+  // platform can't, then the peak is the highest since the process started
+  static bool resetPeakResident()
+  {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return !clearRefs.fail();
+#else
+    return false;
+#endif
+  }
+
+  static size_t peakResidentBytes()
+  {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+      if (line.compare(0, 6, "VmHWM:") == 0)
+        return std::stoull(line.substr(6)) * 1024;
+    }
+#endif
+    return 0;
+  }
+
+  bool WriteSyntheticObj(const std::string& path, size_t targetBytes)
+  {
+    std::string materialPath = path.substr(0, path.size() - 4) + ".mtl";
+    std::string materialFile = materialPath.substr(materialPath.find_last_of('/') + 1);
+
+    std::FILE* material = std::fopen(materialPath.c_str(), "wb");
+    if (!material)
+      return false;
+    const int materialCount = 4;
+    for (int i = 0; i < materialCount; ++i)
+    {
+      std::fprintf(material, "newmtl material%d\nKa 0.1 0.1 0.1\nKd %.3f 0.5 0.5\nKs 1 1 1\nNs 32\nd 1\nillum 2\nmap_Kd diffuse%d.png\n\n", i, i / (float)materialCount, i);
+    }
+    std::fclose(material);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+      return false;
+
+    // Comes out at around 170 bytes of v/vt/vn and faces per grid vertex
+    int side = 2;
+    while ((size_t)side * side * 170 < targetBytes)
+      ++side;
+
+    std::fprintf(file, "# synthetic benchmark grid %dx%d\nmtllib %s\n", side, side, materialFile.c_str());
+    for (int y = 0; y < side; ++y)
+    {
+      for (int x = 0; x < side; ++x)
+      {
+        float height = (float)((x * 7 + y * 13) % 17) * 0.01f;
+        std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+          x * 0.1f, height, y * 0.1f, x / (float)side, y / (float)side, 0.0f, 1.0f, 0.0f);
+      }
+    }
+
+    // A new group and material every band of rows, quads and triangle pairs alternating
+    const int rowsPerGroup = side / 8 > 0 ? side / 8 : 1;
+    for (int y = 0; y + 1 < side; ++y)
+    {
+      if (y % rowsPerGroup == 0)
+        std::fprintf(file, "o band%d\nusemtl material%d\n", y / rowsPerGroup, (y / rowsPerGroup) % materialCount);
+
+      for (int x = 0; x + 1 < side; ++x)
+      {
+        int a = y * side + x + 1;
+        int b = a + 1;
+        int c = a + side + 1;
+        int d = a + side;
+        if ((x + y) % 2 == 0)
+          std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+        else
+          std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\nf %d//%d %d//%d %d//%d\n", a, a, a, b, b, b, c, c, c, a, a, c, c, d, d);
+      }
+    }
+
+    std::fclose(file);
+    return true;
+  }
+
+  bool WriteSharedMaterialObjs(const std::string& directory, unsigned int objCount, unsigned int materialCount)
+  {
+    std::FILE* material = std::fopen((directory + "/shared.mtl").c_str(), "wb");
+    if (!material)
+      return false;
+    for (unsigned int i = 0; i < materialCount; ++i)
+    {
+      std::fprintf(material, "newmtl shared_material_%04u\nKa 0.1 0.1 0.1\nKd %.3f 0.5 0.5\nKs 1 1 1\nNs 32\nd 1\nillum 2\n"
+        "map_Kd textures/shared_diffuse_%04u.png\nmap_bump textures/shared_normal_%04u.png\n\n", i, i / (float)materialCount, i, i);
+    }
+    std::fclose(material);
+
+    // Every file is a strip of quads, one mesh and material per quad
+    const unsigned int meshCount = 64;
+    for (unsigned int i = 0; i < objCount; ++i)
+    {
+      char name[64];
+      std::snprintf(name, sizeof(name), "/shared%04u.obj", i);
+      std::FILE* file = std::fopen((directory + name).c_str(), "wb");
+      if (!file)
+        return false;
+      std::fprintf(file, "mtllib shared.mtl\n");
+      for (unsigned int v = 0; v <= meshCount; ++v)
+        std::fprintf(file, "v %u 0 0\nv %u 1 0\n", v, v);
+      for (unsigned int m = 0; m < meshCount; ++m)
+      {
+        std::fprintf(file, "o part%u\nusemtl shared_material_%04u\nf %u %u %u %u\n", m, (i * 7 + m * 13) % materialCount,
+          m * 2 + 1, m * 2 + 3, m * 2 + 4, m * 2 + 2);
+      }
+      std::fclose(file);
+    }
+    return true;
+  }
+
+  static bool sameMaterial(const objl::Material& a, const objl::Material& b)
+  {
+    return a.name == b.name && a.Ka == b.Ka && a.Kd == b.Kd && a.Ks == b.Ks && a.Ns == b.Ns && a.Ni == b.Ni && a.d == b.d
+      && a.illum == b.illum && a.map_Ka == b.map_Ka && a.map_Kd == b.map_Kd && a.map_Ks == b.map_Ks && a.map_Ns == b.map_Ns
+      && a.map_d == b.map_d && a.map_bump == b.map_bump;
+  }
+
+  template<typename T>
+  static bool sameBytes(const std::vector<T>& a, const std::vector<T>& b)
+  {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+  }
+
+  // A mesh's material through its index, whether or not it was copied into the mesh too
+  static const objl::Material& materialOf(const objl::Loader& loader, int materialIndex)
+  {
+    static const objl::Material none;
+    return materialIndex >= 0 && materialIndex < (int)loader.LoadedMaterials.size() ? loader.LoadedMaterials[materialIndex] : none;
+  }
+
+  bool SameObjData(const objl::Loader& a, const objl::Loader& b)
+  {
+    if (!sameBytes(a.LoadedVertices, b.LoadedVertices) || !sameBytes(a.LoadedIndices, b.LoadedIndices))
+      return false;
+    if (a.LoadedMeshes.size() != b.LoadedMeshes.size() || a.LoadedMaterials.size() != b.LoadedMaterials.size())
+      return false;
+
+    for (size_t i = 0; i < a.LoadedMeshes.size(); ++i)
+    {
+      const objl::Mesh& meshA = a.LoadedMeshes[i];
+      const objl::Mesh& meshB = b.LoadedMeshes[i];
+      if (meshA.MeshName != meshB.MeshName || !sameBytes(meshA.Vertices, meshB.Vertices) || !sameBytes(meshA.Indices, meshB.Indices)
+        || meshA.MaterialIndex != meshB.MaterialIndex || !sameMaterial(meshA.MeshMaterial, meshB.MeshMaterial)
+        || !sameMaterial(materialOf(a, meshA.MaterialIndex), materialOf(b, meshB.MaterialIndex)))
+        return false;
+    }
+    for (size_t i = 0; i < a.LoadedMaterials.size(); ++i)
+    {
+      if (!sameMaterial(a.LoadedMaterials[i], b.LoadedMaterials[i]))
+        return false;
+    }
+    return true;
+  }
+
+  static bool sameVertex(const objl::Vertex& a, const objl::Vertex& b)
+  {
+    return std::memcmp(&a, &b, sizeof(objl::Vertex)) == 0;
+  }
+
+  bool SameObjTriangles(const objl::Loader& a, const objl::Loader& b)
+  {
+    if (a.LoadedIndices.size() != b.LoadedIndices.size() || a.LoadedMeshes.size() != b.LoadedMeshes.size())
+      return false;
+    for (size_t i = 0; i < a.LoadedIndices.size(); ++i)
+    {
+      if (!sameVertex(a.LoadedVertices[a.LoadedIndices[i]], b.LoadedVertices[b.LoadedIndices[i]]))
+        return false;
+    }
+
+    for (size_t i = 0; i < a.LoadedMeshes.size(); ++i)
+    {
+      const objl::Mesh& meshA = a.LoadedMeshes[i];
+      const objl::Mesh& meshB = b.LoadedMeshes[i];
+      if (meshA.MeshName != meshB.MeshName || meshA.Indices.size() != meshB.Indices.size()
+        || !sameMaterial(materialOf(a, meshA.MaterialIndex), materialOf(b, meshB.MaterialIndex)))
+        return false;
+      for (size_t j = 0; j < meshA.Indices.size(); ++j)
+      {
+        if (!sameVertex(meshA.Vertices[meshA.Indices[j]], meshB.Vertices[meshB.Indices[j]]))
+          return false;
+      }
+    }
+    return a.LoadedMaterials.size() == b.LoadedMaterials.size();
+  }
+
+  bool SameObjPool(const objl::Loader& reference, const objl::Loader& pooled)
+  {
+    if (!sameBytes(reference.LoadedVertices, pooled.LoadedVertices) || !sameBytes(reference.LoadedIndices, pooled.LoadedIndices))
+      return false;
+    if (!pooled.LoadedMeshes.empty() || reference.LoadedMeshes.size() != pooled.LoadedMeshRanges.size()
+      || reference.LoadedMaterials.size() != pooled.LoadedMaterials.size())
+      return false;
+
+    for (size_t i = 0; i < pooled.LoadedMeshRanges.size(); ++i)
+    {
+      const objl::Mesh& mesh = reference.LoadedMeshes[i];
+      const objl::MeshRange& range = pooled.LoadedMeshRanges[i];
+      const objl::Material& material = materialOf(pooled, range.MaterialIndex);
+      if (mesh.MeshName != range.MeshName || mesh.Vertices.size() != range.VertexCount || mesh.Indices.size() != range.IndexCount
+        || range.VertexOffset + range.VertexCount > pooled.LoadedVertices.size() || range.IndexOffset + range.IndexCount > pooled.LoadedIndices.size()
+        || !sameMaterial(materialOf(reference, mesh.MaterialIndex), material))
+        return false;
+      if (range.VertexCount && std::memcmp(mesh.Vertices.data(), &pooled.LoadedVertices[range.VertexOffset], range.VertexCount * sizeof(objl::Vertex)) != 0)
+        return false;
+      for (size_t j = 0; j < range.IndexCount; ++j)
+      {
+        if (pooled.LoadedIndices[range.IndexOffset + j] - range.VertexOffset != mesh.Indices[j])
+          return false;
+      }
+    }
+    for (size_t i = 0; i < pooled.LoadedMaterials.size(); ++i)
+    {
+      if (!sameMaterial(reference.LoadedMaterials[i], pooled.LoadedMaterials[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // Cached meshes that are views of exactly the meshes in reference
+  static bool sameCachedMeshes(const objl::Loader& reference, const objl::Loader& loader)
+  {
+    if (reference.LoadedMeshes.size() != loader.CachedMeshes.size() || reference.LoadedMaterials.size() != loader.LoadedMaterials.size())
+      return false;
+    for (size_t i = 0; i < loader.CachedMeshes.size(); ++i)
+    {
+      const objl::Mesh& mesh = reference.LoadedMeshes[i];
+      const objl::MeshView& view = loader.CachedMeshes[i];
+      const objl::Material& material = materialOf(loader, view.MaterialIndex);
+      if (mesh.MeshName != view.MeshName || mesh.Vertices.size() != view.VertexCount || mesh.Indices.size() != view.IndexCount
+        || !sameMaterial(materialOf(reference, mesh.MaterialIndex), material))
+        return false;
+      if (view.VertexCount && std::memcmp(mesh.Vertices.data(), view.Vertices, view.VertexCount * sizeof(objl::Vertex)) != 0)
+        return false;
+      if (view.IndexCount && std::memcmp(mesh.Indices.data(), view.Indices, view.IndexCount * sizeof(unsigned int)) != 0)
+        return false;
+    }
+    return true;
+  }
+
+  std::vector<ObjLoadResult> RunObjLoadBenchmark(const std::string& path, unsigned int repeats, unsigned int maxThreads, std::ostream* out)
+  {
+    std::vector<ObjLoadResult> results;
+
+    std::ifstream sizeCheck(path, std::ios::binary | std::ios::ate);
+    if (!sizeCheck.is_open())
+    {
+      if (out)
+        *out << "can't open " << path << std::endl;
+      return results;
+    }
+    double megabytes = (double)sizeCheck.tellg() / (1024.0 * 1024.0);
+    sizeCheck.close();
+
+    struct Mode
+    {
+      std::string name;
+      objl::LoadMode mode;
+      unsigned int threads;
+      objl::scan::Level level;
+      bool weld;
+      bool rebuildCache;  // Delete the .objb first
+      bool copyCache;     // Loader::CopyCachedMeshes
+      bool pool;          // Loader::PoolMeshes
+    };
+    const char* levelNames[] = { "scalar", "sse2", "avx2" };
+    objl::scan::Level bestLevel = objl::scan::DetectLevel();
+
+    std::vector<Mode> modes = {
+      { "stream", objl::LoadMode::Stream, 0, bestLevel, false, false, true, false },
+    };
+    for (int level = 0; level <= (int)bestLevel; ++level)
+    {
+      modes.push_back({ std::string("mapped ") + levelNames[level], objl::LoadMode::Mapped, 0, (objl::scan::Level)level, false, false, true, false });
+    }
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+      modes.push_back({ "parallel " + std::to_string(threads), objl::LoadMode::Parallel, threads, bestLevel, false, false, true, false });
+    }
+    modes.push_back({ "mapped welded", objl::LoadMode::Mapped, 0, bestLevel, true, false, true, false });
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+      modes.push_back({ "parallel " + std::to_string(threads) + " welded", objl::LoadMode::Parallel, threads, bestLevel, true, false, true, false });
+    }
+    modes.push_back({ "cached rebuild", objl::LoadMode::Cached, 0, bestLevel, false, true, true, false });
+    modes.push_back({ "cached", objl::LoadMode::Cached, 0, bestLevel, false, false, true, false });
+    modes.push_back({ "cached views", objl::LoadMode::Cached, 0, bestLevel, false, false, false, false });
+    unsigned int mostThreads = 1;
+    while (mostThreads * 2 <= maxThreads)
+      mostThreads *= 2;
+    modes.push_back({ "mapped pooled", objl::LoadMode::Mapped, 0, bestLevel, false, false, true, true });
+    modes.push_back({ "parallel " + std::to_string(mostThreads) + " pooled", objl::LoadMode::Parallel, mostThreads, bestLevel, false, false, true, true });
+    modes.push_back({ "cached pooled", objl::LoadMode::Cached, 0, bestLevel, false, false, true, true });
+
+    objl::Loader reference;
+    objl::Loader weldedReference;
+    if (repeats == 0)
+      repeats = 1;
+
+    for (const Mode& mode : modes)
+    {
+      ObjLoadResult result;
+      result.mode = mode.name;
+      result.seconds = 0.0;
+
+      for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+      {
+        objl::Loader loader;
+        loader.ThreadCount = mode.threads;
+        loader.WeldVertices = mode.weld;
+        loader.CopyCachedMeshes = mode.copyCache;
+        loader.PoolMeshes = mode.pool;
+        if (mode.rebuildCache)
+          std::remove((path + "b").c_str());
+        objl::scan::SetLevel(mode.level);
+        bool loaded;
+        double seconds;
+        {
+          QuietConsole quiet;
+          auto start = std::chrono::steady_clock::now();
+          loaded = loader.LoadFile(path, mode.mode);
+          seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        if (!loaded)
+          result.identical = false;
+        if (repeat == 0 || seconds < result.seconds)
+          result.seconds = seconds;
+
+        if (repeat == 0)
+        {
+          result.vertices = loader.LoadedVertices.size();
+          for (const objl::MeshView& view : loader.CachedMeshes)
+            result.vertices += mode.copyCache ? 0 : view.VertexCount;
+          if (mode.mode == objl::LoadMode::Stream)
+            reference = std::move(loader);
+          else if (!mode.copyCache)
+            result.identical = result.identical && sameCachedMeshes(reference, loader);
+          else if (mode.pool)
+            result.identical = result.identical && SameObjPool(reference, loader);
+          else if (!mode.weld)
+            result.identical = result.identical && SameObjData(reference, loader);
+          else
+          {
+            // Every welded load has to agree with the first one exactly
+            result.identical = result.identical && SameObjTriangles(reference, loader);
+            if (mode.mode == objl::LoadMode::Mapped)
+              weldedReference = std::move(loader);
+            else
+              result.identical = result.identical && SameObjData(weldedReference, loader);
+          }
+        }
+      }
+
+      result.megabytesPerSecond = result.seconds > 0.0 ? megabytes / result.seconds : 0.0;
+      results.push_back(result);
+    }
+    objl::scan::SetLevel(bestLevel);
+
+    // Stage one on its own, just building the structural index window by window
+    std::vector<ObjLoadResult> indexResults;
+    objl::MappedFile file;
+    if (file.Open(path))
+    {
+      std::vector<uint32_t> index(objl::scan::WindowSize);
+      for (int level = 0; level <= (int)bestLevel; ++level)
+      {
+        ObjLoadResult result;
+        result.mode = std::string("index ") + levelNames[level];
+        size_t structural = 0;
+        for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+        {
+          auto start = std::chrono::steady_clock::now();
+          for (size_t offset = 0; offset < file.Size(); offset += objl::scan::WindowSize)
+          {
+            size_t size = file.Size() - offset < objl::scan::WindowSize ? file.Size() - offset : objl::scan::WindowSize;
+            structural += objl::scan::BuildIndex((objl::scan::Level)level, file.Data() + offset, size, index.data());
+          }
+          double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+          if (repeat == 0 || seconds < result.seconds)
+            result.seconds = seconds;
+        }
+        // Keeps the index from being optimized away
+        result.identical = structural > 0 || file.Size() == 0;
+        result.megabytesPerSecond = result.seconds > 0.0 ? megabytes / result.seconds : 0.0;
+        indexResults.push_back(result);
+      }
+    }
+
+    if (out)
+    {
+      *out << path << ": " << std::fixed << std::setprecision(1) << megabytes << " MB, "
+        << reference.LoadedMeshes.size() << " meshes, " << reference.LoadedIndices.size() / 3 << " triangles" << std::endl;
+      *out << "mode\t\t\tseconds\tMB/s\tspeedup\tidentical\tvertices" << std::endl;
+      for (const ObjLoadResult& result : results)
+      {
+        *out << std::left << std::setw(24) << result.mode << std::right << std::setprecision(3) << result.seconds << "\t" << std::setprecision(1) << result.megabytesPerSecond
+          << "\t" << std::setprecision(2) << results[0].seconds / result.seconds << "x\t" << (result.identical ? "yes" : "NO") << "\t\t" << result.vertices << std::endl;
+      }
+      for (const ObjLoadResult& result : indexResults)
+      {
+        *out << std::left << std::setw(24) << result.mode << std::right << std::setprecision(3) << result.seconds << "\t" << std::setprecision(1) << result.megabytesPerSecond << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    results.insert(results.end(), indexResults.begin(), indexResults.end());
+    return results;
+  }
+
+  std::vector<ObjMemoryResult> RunObjMemoryBenchmark(const std::string& path, size_t batchTriangles, std::ostream* out)
+  {
+    enum class Load { StreamFile, LoadFile };
+    struct Mode
+    {
+      std::string name;
+      Load load;
+      size_t batchTriangles;
+      objl::LoadMode mode;
+      bool pool;
+    };
+    std::vector<Mode> modes = {
+      { "streamfile " + std::to_string(batchTriangles), Load::StreamFile, batchTriangles, objl::LoadMode::Stream, false },
+      // Every mesh is a whole number of batches, so each ends on an empty batch
+      { "streamfile 1", Load::StreamFile, 1, objl::LoadMode::Stream, false },
+      { "streamfile", Load::StreamFile, 0, objl::LoadMode::Stream, false },
+      { "mapped pooled", Load::LoadFile, 0, objl::LoadMode::Mapped, true },
+      { "mapped", Load::LoadFile, 0, objl::LoadMode::Mapped, false },
+      { "parallel pooled", Load::LoadFile, 0, objl::LoadMode::Parallel, true },
+      { "parallel", Load::LoadFile, 0, objl::LoadMode::Parallel, false },
+      { "stream", Load::LoadFile, 0, objl::LoadMode::Stream, false },
+    };
+
+    // What every load has to agree on about each mesh, whole meshes only
+    struct MeshSummary
+    {
+      std::string name;
+      int materialIndex;
+      size_t triangles;
+
+      bool operator==(const MeshSummary& other) const
+      {
+        return name == other.name && materialIndex == other.materialIndex && triangles == other.triangles;
+      }
+    };
+    std::vector<std::vector<MeshSummary>> summaries;
+
+    std::vector<ObjMemoryResult> results;
+    bool resets = true;
+
+    for (const Mode& mode : modes)
+    {
+      ObjMemoryResult result;
+      result.mode = mode.name;
+      resets = resetPeakResident() && resets;
+
+      auto count = [&result](size_t vertexCount, size_t indexCount)
+      {
+        size_t bytes = vertexCount * sizeof(objl::Vertex) + indexCount * sizeof(unsigned int);
+        result.meshBytes += bytes;
+        if (bytes > result.largestMeshBytes)
+          result.largestMeshBytes = bytes;
+      };
+
+      std::vector<MeshSummary>& summary = summaries.emplace_back();
+      QuietConsole quiet;
+      auto start = std::chrono::steady_clock::now();
+      {
+        objl::Loader loader;
+        loader.PoolMeshes = mode.pool;
+        if (mode.load == Load::StreamFile)
+        {
+          size_t batchedTriangles = 0;
+          loader.StreamFile(path, [&](objl::Mesh& mesh, bool complete)
+          {
+            count(mesh.Vertices.size(), mesh.Indices.size());
+            batchedTriangles += mesh.Indices.size() / 3;
+            if (complete)
+            {
+              summary.push_back({ mesh.MeshName, mesh.MaterialIndex, batchedTriangles });
+              batchedTriangles = 0;
+            }
+          }, mode.batchTriangles);
+        }
+        else
+        {
+          loader.LoadFile(path, mode.mode);
+          for (const objl::Mesh& mesh : loader.LoadedMeshes)
+          {
+            count(mesh.Vertices.size(), mesh.Indices.size());
+            summary.push_back({ mesh.MeshName, mesh.MaterialIndex, mesh.Indices.size() / 3 });
+          }
+          for (const objl::MeshRange& range : loader.LoadedMeshRanges)
+          {
+            count(range.VertexCount, range.IndexCount);
+            summary.push_back({ range.MeshName, range.MaterialIndex, range.IndexCount / 3 });
+          }
+        }
+        result.peakBytes = peakResidentBytes();
+      }
+      result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      results.push_back(result);
+    }
+
+    // Every load against LoadMode::Mapped's meshes
+    size_t reference = 0;
+    for (size_t i = 0; i < modes.size(); ++i)
+    {
+      if (modes[i].load == Load::LoadFile && modes[i].mode == objl::LoadMode::Mapped && !modes[i].pool)
+        reference = i;
+    }
+    for (size_t i = 0; i < results.size(); ++i)
+      results[i].identical = summaries[i] == summaries[reference];
+
+    if (out)
+    {
+      const double megabyte = 1024.0 * 1024.0;
+      *out << path << ": peak resident memory" << (resets ? "" : " since the process started") << std::endl;
+      *out << "mode			seconds	peak MB	mesh MB	largest mesh MB	identical" << std::endl;
+      for (const ObjMemoryResult& result : results)
+      {
+        *out << std::left << std::setw(24) << result.mode << std::right << std::fixed << std::setprecision(3) << result.seconds
+          << "\t" << std::setprecision(1) << result.peakBytes / megabyte << "\t" << result.meshBytes / megabyte
+          << "\t" << result.largestMeshBytes / megabyte << "\t\t" << (result.identical ? "yes" : "no") << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+
+  static size_t heapBytes(const std::string& text)
+  {
+    static const size_t inPlace = std::string().capacity();
+    return text.capacity() > inPlace ? text.capacity() + 1 : 0;
+  }
+
+  std::vector<ObjMaterialResult> RunObjMaterialBenchmark(const std::string& directory, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<ObjMaterialResult> results;
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory))
+    {
+      if (entry.path().extension() == ".obj")
+        paths.push_back(entry.path().generic_string());
+    }
+    std::sort(paths.begin(), paths.end());
+    if (paths.empty())
+    {
+      if (out)
+        *out << "no .obj files in " << directory << std::endl;
+      return results;
+    }
+    if (repeats == 0)
+      repeats = 1;
+
+    struct Mode
+    {
+      const char* name;
+      bool shareLibraries;
+      bool copyMaterials;
+    };
+    const Mode modes[] = {
+      { "parse every load", false, true },
+      { "library cache", true, true },
+      { "library cache, handles", true, false },
+    };
+
+    objl::MaterialLibraries& libraries = objl::MaterialLibraries::Get();
+    size_t meshCount = 0;
+    for (const Mode& mode : modes)
+    {
+      ObjMaterialResult result;
+      result.mode = mode.name;
+      for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+      {
+        libraries.Clear();
+        size_t parses = libraries.Parses();
+        size_t materialBytes = 0;
+        meshCount = 0;
+
+        QuietConsole quiet;
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& path : paths)
+        {
+          if (!mode.shareLibraries)
+            libraries.Clear();
+          objl::Loader loader;
+          loader.CopyMaterials = mode.copyMaterials;
+          loader.LoadFile(path, objl::LoadMode::Mapped);
+          for (const objl::Mesh& mesh : loader.LoadedMeshes)
+          {
+            const objl::Material& material = mesh.MeshMaterial;
+            materialBytes += heapBytes(material.name) + heapBytes(material.map_Ka) + heapBytes(material.map_Kd) + heapBytes(material.map_Ks)
+              + heapBytes(material.map_Ns) + heapBytes(material.map_d) + heapBytes(material.map_bump);
+          }
+          meshCount += loader.LoadedMeshes.size();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (repeat == 0 || seconds < result.seconds)
+          result.seconds = seconds;
+        result.parses = libraries.Parses() - parses;
+        result.materialBytes = materialBytes;
+      }
+      results.push_back(result);
+    }
+    libraries.Clear();
+
+    if (out)
+    {
+      *out << directory << ": " << paths.size() << " files, " << meshCount << " meshes" << std::endl;
+      *out << "mode\t\t\tseconds\tspeedup\tparses\tmaterial KB" << std::endl;
+      for (const ObjMaterialResult& result : results)
+      {
+        *out << std::left << std::setw(24) << result.mode << std::right << std::fixed << std::setprecision(3) << result.seconds
+          << "\t" << std::setprecision(2) << results[0].seconds / result.seconds << "x\t" << result.parses
+          << "\t" << std::setprecision(1) << result.materialBytes / 1024.0 << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
\ No newline at end of file
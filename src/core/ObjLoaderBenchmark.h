@@ -0,0 +1,101 @@
+#pragma once
+
+#include "helper/OBJ_Loader.h"
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct ObjLoadResult
+  {
+    std::string mode;
+    double seconds = 0.0;           // Best of the repeats
+    double megabytesPerSecond = 0.0;
+    bool identical = true;          // Same meshes, vertices and indices as LoadMode::Stream, same triangles when welded
+    size_t vertices = 0;            // LoadedVertices after the load, or in CachedMeshes if that is all there is
+  };
+
+  struct ObjMemoryResult
+  {
+    std::string mode;
+    double seconds = 0.0;
+    size_t peakBytes = 0;           // Peak resident memory of the process during the load, 0 if unknown
+    size_t meshBytes = 0;           // Vertices and indices of every mesh
+    size_t largestMeshBytes = 0;    // Vertices and indices of the largest single mesh (or batch)
+    bool identical = false;         // Same meshes, names, materials and triangle counts as LoadMode::Mapped
+  };
+
+  struct ObjMaterialResult
+  {
+    std::string mode;
+    double seconds = 0.0;           // All the files, best of the repeats
+    size_t parses = 0;              // .mtl files parsed
+    size_t materialBytes = 0;       // Heap memory held by the meshes' own copies of their materials
+  };
+
+  // Swallows std::cout, where the loader prints its progress, for as long as it lives
+  // so the progress doesn't end up in the timings or the tables.
+  class QuietConsole
+  {
+  public:
+    QuietConsole();
+    ~QuietConsole();
+    QuietConsole(const QuietConsole&) = delete;
+    QuietConsole& operator=(const QuietConsole&) = delete;
+
+  private:
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+      int overflow(int c) override { return c; }
+      std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    NullBuffer nullBuffer;
+    std::streambuf* console;
+  };
+
+  // Loads path into loader the way the mesh benchmarks all start, welded with LoadMode::Mapped
+  // and quietly, saying "can't load" on out if it fails.
+  bool LoadObjQuietly(objl::Loader& loader, const std::string& path, std::ostream* out = nullptr);
+
+  // Writes a grid mesh of roughly targetBytes with v/vt/vn, triangles and quads, groups and
+  // materials (plus its .mtl), for benchmarking without a real scan at hand.
+  bool WriteSyntheticObj(const std::string& path, size_t targetBytes);
+
+  // Writes objCount small .obj files into directory that all use one .mtl of materialCount materials.
+  bool WriteSharedMaterialObjs(const std::string& directory, unsigned int objCount, unsigned int materialCount);
+
+  // True if both loaders hold exactly the same meshes, vertices, indices and materials.
+  bool SameObjData(const objl::Loader& a, const objl::Loader& b);
+
+  // True if both loaders hold the same meshes and materials with the same triangles corner for corner,
+  // however their vertices are shared.
+  bool SameObjTriangles(const objl::Loader& a, const objl::Loader& b);
+
+  // True if pooled holds in its LoadedMeshRanges exactly the meshes reference holds in LoadedMeshes,
+  // over the same vertices, indices and materials.
+  bool SameObjPool(const objl::Loader& reference, const objl::Loader& pooled);
+
+  // Loads path with every objl::LoadMode and reports throughput against LoadMode::Stream,
+  // LoadMode::Mapped once per SIMD level the CPU has, LoadMode::Parallel once for every
+  // power of two threads up to maxThreads. The "welded" rows load with Loader::WeldVertices,
+  // the "cached" rows go through the .objb cache (left next to path), rebuilding it, copying
+  // out of it and just viewing it. The "pooled" rows load with Loader::PoolMeshes.
+  // The "index" rows time the structural scan alone.
+  std::vector<ObjLoadResult> RunObjLoadBenchmark(const std::string& path, unsigned int repeats, unsigned int maxThreads, std::ostream* out = nullptr);
+
+  // Loads path once each with Loader::StreamFile in batchTriangles batches and in batches of one triangle,
+  // StreamFile per mesh, LoadMode::Mapped and LoadMode::Parallel with and without Loader::PoolMeshes and
+  // LoadMode::Stream, throwing the meshes away, and reports the peak resident memory of each and whether
+  // its meshes agree with LoadMode::Mapped's. Runs in that order since freed memory isn't always given back to the system.
+  std::vector<ObjMemoryResult> RunObjMemoryBenchmark(const std::string& path, size_t batchTriangles, std::ostream* out = nullptr);
+
+  // Loads every .obj in directory with LoadMode::Mapped, parsing their .mtl files for every load
+  // (objl::MaterialLibraries cleared before each), through the library cache, and through it with
+  // Loader::CopyMaterials off so meshes only hold a material index.
+  std::vector<ObjMaterialResult> RunObjMaterialBenchmark(const std::string& directory, unsigned int repeats, std::ostream* out = nullptr);
+}
\ No newline at end of file
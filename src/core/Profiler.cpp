@@ -0,0 +1,179 @@
+#include "PrecompiledHeader.h"
+#include "core/Profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core
+{
+  namespace
+  {
+    enum class EventType : uint8_t
+    {
+      Zone,
+      Counter,
+      Instant
+    };
+
+    struct Event
+    {
+      const char* name;
+      const char* category;
+      int64_t timestamp; // Profiler::Now() ticks
+      int64_t duration;
+      double value;
+      EventType type;
+    };
+
+    struct ThreadBuffer
+    {
+      static constexpr uint64_t mask = PROFILER_EVENTS_PER_THREAD - 1;
+
+      uint32_t threadId = 0;
+      std::string threadName;
+      std::atomic<uint64_t> count{ 0 };
+      std::unique_ptr<Event[]> events{ new Event[PROFILER_EVENTS_PER_THREAD] };
+    };
+
+    // Buffers outlive their threads so a trace can still be written after workers exit
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+    // Pairs up the raw timestamps with the steady clock to convert between them
+    const auto epochTime = std::chrono::steady_clock::now();
+    const int64_t epochTicks = Profiler::Now();
+
+    ThreadBuffer* getThreadBuffer()
+    {
+      if (!threadBuffer)
+      {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffer = buffers.back().get();
+        threadBuffer->threadId = (uint32_t)buffers.size();
+      }
+      return threadBuffer;
+    }
+
+    void pushEvent(const Event& event)
+    {
+      ThreadBuffer* buffer = getThreadBuffer();
+      uint64_t index = buffer->count.load(std::memory_order_relaxed);
+      buffer->events[index & ThreadBuffer::mask] = event;
+      buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    void writeEscaped(std::ostream& out, const char* text)
+    {
+      for (; *text; ++text)
+      {
+        if (*text == '"' || *text == '\\')
+          out << '\\';
+        out << *text;
+      }
+    }
+  }
+
+  void Profiler::RecordZone(const char* name, const char* category, int64_t start, int64_t end)
+  {
+    pushEvent({ name, category, start, end - start, 0.0, EventType::Zone });
+  }
+
+  void Profiler::RecordCounter(const char* name, double value)
+  {
+    pushEvent({ name, "counter", Now(), 0, value, EventType::Counter });
+  }
+
+  void Profiler::RecordInstant(const char* name)
+  {
+    pushEvent({ name, "instant", Now(), 0, 0.0, EventType::Instant });
+  }
+
+  void Profiler::SetThreadName(const std::string& name)
+  {
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffer->threadName = name;
+  }
+
+  void Profiler::WriteTrace(std::ostream& out)
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+#ifdef PROFILER_USE_TSC
+    double nanosecondsPerTick = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - epochTime).count() / (double)(Profiler::Now() - epochTicks);
+#else
+    double nanosecondsPerTick = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+    double microsecondsPerTick = nanosecondsPerTick / 1000.0;
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& buffer : buffers)
+    {
+      if (!buffer->threadName.empty())
+      {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"";
+        writeEscaped(out, buffer->threadName.c_str());
+        out << "\"}}";
+        first = false;
+      }
+
+      uint64_t end = buffer->count.load(std::memory_order_acquire);
+      uint64_t begin = end > PROFILER_EVENTS_PER_THREAD ? end - PROFILER_EVENTS_PER_THREAD : 0;
+      // Once wrapped, leave some room so the owning thread doesn't overwrite what we are reading
+      if (end > PROFILER_EVENTS_PER_THREAD)
+        begin += 1024;
+
+      for (uint64_t i = begin; i < end; ++i)
+      {
+        const Event& event = buffer->events[i & ThreadBuffer::mask];
+        out << (first ? "" : ",") << "\n{\"name\":\"";
+        writeEscaped(out, event.name);
+        out << "\",\"cat\":\"";
+        writeEscaped(out, event.category);
+        out << "\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":" << (event.timestamp - epochTicks) * microsecondsPerTick;
+
+        switch (event.type)
+        {
+        case EventType::Zone:
+          out << ",\"ph\":\"X\",\"dur\":" << event.duration * microsecondsPerTick << "}";
+          break;
+        case EventType::Counter:
+          out << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+          break;
+        case EventType::Instant:
+          out << ",\"ph\":\"i\",\"s\":\"t\"}";
+          break;
+        }
+        first = false;
+      }
+    }
+    out << "\n]}" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  bool Profiler::WriteTrace(const std::string& path)
+  {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+      return false;
+
+    WriteTrace(file);
+    return true;
+  }
+}
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+//#define ENABLE_PROFILER // Compiles the PROFILE_ macros in, without it they expand to nothing
+#define PROFILER_EVENTS_PER_THREAD 65536 // Must be a power of two, older events get overwritten
+#define PROFILER_TRACE_PATH "trace.json" // Written on engine cleanup, open in chrome://tracing or ui.perfetto.dev
+
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PROFILER_USE_TSC
+#endif
+
+namespace Core
+{
+  // Chrome trace event format recorder. Every thread writes into its own ring
+  // of events without locks, WriteTrace copies whatever is in the rings out.
+  class Profiler
+  {
+  public:
+    // Raw timestamp, the TSC where there is one since it's several times cheaper
+    // than the OS clock. Converted to real time when the trace gets written.
+    static int64_t Now()
+    {
+#ifdef PROFILER_USE_TSC
+      return (int64_t)__rdtsc();
+#else
+      return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    static void RecordZone(const char* name, const char* category, int64_t start, int64_t end);
+    static void RecordCounter(const char* name, double value);
+    static void RecordInstant(const char* name);
+    static void SetThreadName(const std::string& name);
+
+    static void WriteTrace(std::ostream& out);
+    static bool WriteTrace(const std::string& path);
+  };
+
+  // Records a complete event spanning its own lifetime.
+  class ProfileZone
+  {
+  public:
+    ProfileZone(const char* name, const char* category = "engine") : name(name), category(category), start(Profiler::Now()) {}
+    ~ProfileZone() { Profiler::RecordZone(name, category, start, Profiler::Now()); }
+  private:
+    ProfileZone(ProfileZone const&) = delete;
+    void operator=(ProfileZone const&) = delete;
+
+    const char* name;
+    const char* category;
+    int64_t start;
+  };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Names have to outlive the trace, string literals or GetName() style constants
+#define PROFILE_ZONE(name) Core::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_ZONE_CATEGORY(name, category) Core::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name, category)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_COUNTER(name, value) Core::Profiler::RecordCounter(name, (double)(value))
+#define PROFILE_INSTANT(name) Core::Profiler::RecordInstant(name)
+#define PROFILE_THREAD_NAME(name) Core::Profiler::SetThreadName(name)
+#define PROFILE_WRITE_TRACE(path) Core::Profiler::WriteTrace(std::string(path))
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_ZONE_CATEGORY(name, category)
+#define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_INSTANT(name)
+#define PROFILE_THREAD_NAME(name)
+#define PROFILE_WRITE_TRACE(path)
+
+#endif
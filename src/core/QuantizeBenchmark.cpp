@@ -0,0 +1,118 @@
+#include "PrecompiledHeader.h"
+#include "core/QuantizeBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Quantize.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+namespace Core
+{
+  std::vector<QuantizeResult> RunQuantizeBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<QuantizeResult> results;
+
+    objl::Loader loader;
+    if (!LoadObjQuietly(loader, path, out))
+      return results;
+    if (repeats == 0)
+      repeats = 1;
+
+    size_t vertexCount = 0;
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+      vertexCount += mesh.Vertices.size();
+
+    const char* formatNames[] = { "16 bit", "10 bit" };
+    const char* levelNames[] = { "scalar", "sse2", "avx2" };
+    const objl::scan::Level bestLevel = objl::scan::DetectLevel();
+
+    for (int format = 0; format < 2; ++format)
+    {
+      // The scalar encoder's output, what every level has to match
+      std::vector<objl::quantize::PackedMesh> reference;
+
+      for (int level = 0; level <= (int)bestLevel; ++level)
+      {
+        QuantizeResult result;
+        result.encoder = std::string(formatNames[format]) + " " + levelNames[level];
+        result.bytesPerVertex = (float)sizeof(objl::quantize::PackedVertex);
+
+        for (size_t m = 0; m < loader.LoadedMeshes.size(); ++m)
+        {
+          const objl::Mesh& mesh = loader.LoadedMeshes[m];
+          objl::quantize::PackedMesh packed;
+          packed.VertexFormat = (objl::quantize::Format)format;
+          packed.Indices = mesh.Indices;
+          objl::quantize::ComputeBounds(mesh.Vertices.data(), mesh.Vertices.size(), packed.Offset, packed.Scale);
+          packed.Vertices.resize(mesh.Vertices.size());
+
+          double best = 0.0;
+          for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+          {
+            auto start = std::chrono::steady_clock::now();
+            objl::quantize::Encode((objl::scan::Level)level, packed.VertexFormat, mesh.Vertices.data(), mesh.Vertices.size(),
+              packed.Offset, packed.Scale, packed.Vertices.data());
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (repeat == 0 || milliseconds < best)
+              best = milliseconds;
+          }
+          result.milliseconds += best;
+
+          if (level == 0)
+          {
+            objl::quantize::Error error = objl::quantize::MeasureError(mesh, packed);
+            float longest = std::max(packed.Scale.X, std::max(packed.Scale.Y, packed.Scale.Z));
+            if (longest > 0.0f)
+            {
+              result.positionError = std::max(result.positionError, error.Position / longest);
+              result.positionBound = std::max(result.positionBound, error.PositionBound / longest);
+            }
+            result.normalDegrees = std::max(result.normalDegrees, error.NormalDegrees);
+            result.uvError = std::max(result.uvError, error.TextureCoordinate);
+            reference.push_back(std::move(packed));
+          }
+          else
+          {
+            const objl::quantize::PackedMesh& expected = reference[m];
+            for (size_t v = 0; v < packed.Vertices.size(); ++v)
+              result.mismatches += std::memcmp(&packed.Vertices[v], &expected.Vertices[v], sizeof(objl::quantize::PackedVertex)) != 0;
+          }
+        }
+
+        if (level > 0)
+        {
+          // Matching bytes decode the same, the errors are the scalar row's
+          const QuantizeResult& scalar = results[results.size() - level];
+          result.positionError = scalar.positionError;
+          result.positionBound = scalar.positionBound;
+          result.normalDegrees = scalar.normalDegrees;
+          result.uvError = scalar.uvError;
+        }
+        if (result.milliseconds > 0.0)
+          result.gigabytesPerSecond = vertexCount * sizeof(objl::Vertex) / (result.milliseconds / 1000.0) / 1e9;
+        results.push_back(result);
+      }
+    }
+
+    if (out)
+    {
+      *out << path << ": " << loader.LoadedMeshes.size() << " meshes, " << vertexCount << " welded vertices, "
+        << sizeof(objl::Vertex) << " bytes each as floats" << std::endl;
+      *out << "encoder\t\tms\tGB/s\tbytes\tmismatch\tposition\tbound\t\tnormal deg\tuv" << std::endl;
+      for (const QuantizeResult& result : results)
+      {
+        *out << std::left << std::setw(16) << result.encoder << std::right << std::fixed << std::setprecision(2) << result.milliseconds
+          << "\t" << result.gigabytesPerSecond << "\t" << std::setprecision(0) << result.bytesPerVertex << "\t" << result.mismatches
+          << "\t\t" << std::scientific << std::setprecision(2) << result.positionError << "\t" << result.positionBound << "\t"
+          << std::fixed << std::setprecision(3) << result.normalDegrees << "\t\t" << std::scientific << std::setprecision(2)
+          << result.uvError << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct QuantizeResult
+  {
+    std::string encoder;            // Which objl::quantize::Format and objl::scan::Level the row is
+    double milliseconds = 0.0;      // Packing every mesh, best of the repeats
+    double gigabytesPerSecond = 0.0; // Float vertices going in over the time
+    float bytesPerVertex = 0.0f;    // Packed, 32 for the float vertices
+    size_t mismatches = 0;          // Vertices packed differently from the scalar encoder
+    float positionError = 0.0f;     // Furthest a position axis moved over the mesh's longest axis, worst mesh
+    float positionBound = 0.0f;     // Half a quantization step over the longest axis
+    float normalDegrees = 0.0f;     // Largest angle a normal turned, worst mesh
+    float uvError = 0.0f;           // Furthest a texture coordinate moved, worst mesh
+  };
+
+  // Loads the .obj at path with welded vertices and packs every mesh with objl::quantize in both
+  // formats with every encoder level the CPU has, checks each level against the scalar encoder and
+  // decodes the packed meshes to measure how far their vertices moved.
+  std::vector<QuantizeResult> RunQuantizeBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
@@ -0,0 +1,349 @@
+#include "PrecompiledHeader.h"
+#include "core/SimplifyBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Simplify.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+namespace
+{
+  objl::Vector3 closestOnTriangle(const objl::Vector3& p, const objl::Vector3& a, const objl::Vector3& b, const objl::Vector3& c)
+  {
+    using objl::math::DotV3;
+    objl::Vector3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = DotV3(ab, ap), d2 = DotV3(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+      return a;
+
+    objl::Vector3 bp = p - b;
+    float d3 = DotV3(ab, bp), d4 = DotV3(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+      return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+      return a + ab * (d1 / (d1 - d3));
+
+    objl::Vector3 cp = p - c;
+    float d5 = DotV3(ab, cp), d6 = DotV3(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+      return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+      return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+      return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+  }
+
+  // Uniform grid of the triangles of a mesh for finding the nearest one to a point
+  class TriangleGrid
+  {
+  public:
+    TriangleGrid(const objl::Mesh& mesh, objl::Vector3 low, objl::Vector3 high)
+      : mesh(mesh), low(low)
+    {
+      size_t triangleCount = mesh.Indices.size() / 3;
+      float extent = std::max(high.X - low.X, std::max(high.Y - low.Y, high.Z - low.Z));
+      // About two cells a side for every cube root triangle, at most 128 a side
+      cellSize = std::max(extent / (std::cbrt((float)triangleCount) * 2.0f + 1.0f), extent / 127.0f);
+      if (cellSize <= 0.0f)
+        cellSize = 1.0f;
+      float size[3] = { high.X - low.X, high.Y - low.Y, high.Z - low.Z };
+      for (int axis = 0; axis < 3; ++axis)
+        cells[axis] = (int)(size[axis] / cellSize) + 1;
+
+      std::vector<std::array<int, 6>> bounds(triangleCount);
+      offsets.assign((size_t)cells[0] * cells[1] * cells[2] + 1, 0);
+      for (int pass = 0; pass < 2; ++pass)
+      {
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+          std::array<int, 6>& box = bounds[t];
+          if (pass == 0)
+          {
+            box = { cells[0], cells[1], cells[2], -1, -1, -1 };
+            for (int corner = 0; corner < 3; ++corner)
+            {
+              int cell[3];
+              cellOf(mesh.Vertices[mesh.Indices[t * 3 + corner]].Position, cell);
+              for (int axis = 0; axis < 3; ++axis)
+              {
+                box[axis] = std::min(box[axis], cell[axis]);
+                box[axis + 3] = std::max(box[axis + 3], cell[axis]);
+              }
+            }
+          }
+          for (int z = box[2]; z <= box[5]; ++z)
+            for (int y = box[1]; y <= box[4]; ++y)
+              for (int x = box[0]; x <= box[3]; ++x)
+              {
+                size_t cell = ((size_t)z * cells[1] + y) * cells[0] + x;
+                if (pass == 0)
+                  ++offsets[cell + 1];
+                else
+                  triangles[filled[cell]++] = (unsigned int)t;
+              }
+        }
+        if (pass == 0)
+        {
+          for (size_t cell = 1; cell < offsets.size(); ++cell)
+            offsets[cell] += offsets[cell - 1];
+          triangles.resize(offsets.back());
+          filled.assign(offsets.begin(), offsets.end() - 1);
+        }
+      }
+    }
+
+    // Distance from p to the nearest triangle, searching shells of cells outward until none can be nearer
+    float Distance(const objl::Vector3& p) const
+    {
+      int center[3];
+      cellOf(p, center);
+      float best = std::numeric_limits<float>::infinity();
+      int maxRing = std::max(cells[0], std::max(cells[1], cells[2]));
+      for (int ring = 0; ring <= maxRing; ++ring)
+      {
+        if (best <= (ring - 1) * cellSize)
+          break;
+        for (int z = center[2] - ring; z <= center[2] + ring; ++z)
+          for (int y = center[1] - ring; y <= center[1] + ring; ++y)
+            for (int x = center[0] - ring; x <= center[0] + ring; ++x)
+            {
+              if (std::max(std::abs(x - center[0]), std::max(std::abs(y - center[1]), std::abs(z - center[2]))) != ring)
+                continue;
+              if (x < 0 || y < 0 || z < 0 || x >= cells[0] || y >= cells[1] || z >= cells[2])
+                continue;
+              size_t cell = ((size_t)z * cells[1] + y) * cells[0] + x;
+              for (unsigned int k = offsets[cell]; k < offsets[cell + 1]; ++k)
+              {
+                const unsigned int* corners = &mesh.Indices[triangles[k] * 3];
+                objl::Vector3 closest = closestOnTriangle(p, mesh.Vertices[corners[0]].Position,
+                  mesh.Vertices[corners[1]].Position, mesh.Vertices[corners[2]].Position);
+                best = std::min(best, objl::math::MagnitudeV3(closest - p));
+              }
+            }
+      }
+      return best;
+    }
+
+  private:
+    void cellOf(const objl::Vector3& p, int* cell) const
+    {
+      const float* position = &p.X;
+      const float* origin = &low.X;
+      for (int axis = 0; axis < 3; ++axis)
+        cell[axis] = std::clamp((int)((position[axis] - origin[axis]) / cellSize), 0, cells[axis] - 1);
+    }
+
+    const objl::Mesh& mesh;
+    objl::Vector3 low;
+    float cellSize = 1.0f;
+    int cells[3] = { 1, 1, 1 };
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> filled;
+    std::vector<unsigned int> triangles;
+  };
+
+  struct Measured
+  {
+    float maxError = 0.0f;
+    double errorSum = 0.0;
+    size_t samples = 0;
+  };
+
+  // Distances from up to 20000 vertices of original to the surface of simplified, over original's largest side
+  void measureError(const objl::Mesh& original, const objl::Mesh& simplified, Measured& measured)
+  {
+    if (original.Vertices.empty() || simplified.Indices.size() < 3)
+      return;
+
+    objl::Vector3 low = original.Vertices[0].Position, high = low;
+    for (const objl::Mesh* mesh : { &original, &simplified })
+    {
+      for (const objl::Vertex& vertex : mesh->Vertices)
+      {
+        const objl::Vector3& p = vertex.Position;
+        low = objl::Vector3(std::min(low.X, p.X), std::min(low.Y, p.Y), std::min(low.Z, p.Z));
+        high = objl::Vector3(std::max(high.X, p.X), std::max(high.Y, p.Y), std::max(high.Z, p.Z));
+      }
+    }
+    float extent = std::max(high.X - low.X, std::max(high.Y - low.Y, high.Z - low.Z));
+    if (extent <= 0.0f)
+      return;
+
+    TriangleGrid grid(simplified, low, high);
+    size_t stride = std::max<size_t>(1, original.Vertices.size() / 20000);
+    for (size_t v = 0; v < original.Vertices.size(); v += stride)
+    {
+      float error = grid.Distance(original.Vertices[v].Position) / extent;
+      measured.maxError = std::max(measured.maxError, error);
+      measured.errorSum += error;
+      ++measured.samples;
+    }
+  }
+
+  // Edges, by position, with a triangle on one side and not the other
+  size_t openEdges(const objl::Mesh& mesh)
+  {
+    std::map<std::array<float, 6>, int> edges;
+    for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+    {
+      for (int corner = 0; corner < 3; ++corner)
+      {
+        const objl::Vector3& a = mesh.Vertices[mesh.Indices[i + corner]].Position;
+        const objl::Vector3& b = mesh.Vertices[mesh.Indices[i + (corner + 1) % 3]].Position;
+        if (a == b)
+          continue;
+        auto reverse = edges.find({ b.X, b.Y, b.Z, a.X, a.Y, a.Z });
+        if (reverse != edges.end() && reverse->second > 0)
+          --reverse->second;
+        else
+          ++edges[{ a.X, a.Y, a.Z, b.X, b.Y, b.Z }];
+      }
+    }
+    size_t open = 0;
+    for (const auto& edge : edges)
+      open += edge.second;
+    return open;
+  }
+}
+
+namespace Core
+{
+  std::vector<SimplifyResult> RunSimplifyBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<SimplifyResult> results;
+
+    objl::Loader loader;
+    if (!LoadObjQuietly(loader, path, out))
+      return results;
+    if (repeats == 0)
+      repeats = 1;
+
+    objl::simplify::LodOptions lodOptions;
+    lodOptions.Levels = 6;
+    lodOptions.MaxError = 0.1f;
+
+    size_t triangleCount = 0;
+    std::vector<size_t> meshOpenEdges;
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+    {
+      triangleCount += mesh.Indices.size() / 3;
+      meshOpenEdges.push_back(openEdges(mesh));
+    }
+
+    double chainMilliseconds = 0.0;
+    size_t chainTriangles = 0;
+    std::vector<std::vector<objl::simplify::Lod>> chains(loader.LoadedMeshes.size());
+    for (size_t m = 0; m < loader.LoadedMeshes.size(); ++m)
+    {
+      const objl::Mesh& mesh = loader.LoadedMeshes[m];
+      double best = 0.0;
+      for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+      {
+        auto start = std::chrono::steady_clock::now();
+        chains[m] = objl::simplify::GenerateLods(mesh, lodOptions);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (repeat == 0 || milliseconds < best)
+          best = milliseconds;
+      }
+      chainMilliseconds += best;
+      chainTriangles += mesh.Indices.size() / 3;
+      for (size_t level = 0; level + 1 < chains[m].size(); ++level)
+        chainTriangles += chains[m][level].LodMesh.Indices.size() / 3;
+    }
+
+    for (unsigned int level = 0; level < lodOptions.Levels; ++level)
+    {
+      for (int direct = 0; direct < 2; ++direct)
+      {
+        SimplifyResult result;
+        result.level = (direct ? "direct " : "lod ") + std::to_string(level + 1);
+        Measured measured;
+        bool any = false;
+
+        for (size_t m = 0; m < loader.LoadedMeshes.size(); ++m)
+        {
+          const objl::Mesh& mesh = loader.LoadedMeshes[m];
+          // Meshes whose chain stopped early stay at their last level
+          const objl::Mesh* simplified = &mesh;
+          float error = 0.0f;
+          if (!chains[m].empty())
+          {
+            const objl::simplify::Lod& lod = chains[m][std::min<size_t>(level, chains[m].size() - 1)];
+            simplified = &lod.LodMesh;
+            error = lod.Error;
+            any = any || level < chains[m].size();
+          }
+
+          objl::Mesh fromScratch;
+          if (direct && simplified != &mesh)
+          {
+            objl::simplify::Options options = lodOptions.Simplify;
+            options.TargetTriangles = simplified->Indices.size() / 3;
+            options.TargetError = lodOptions.MaxError;
+            double best = 0.0;
+            for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+            {
+              auto start = std::chrono::steady_clock::now();
+              fromScratch = objl::simplify::SimplifyMesh(mesh, options, &error);
+              double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+              if (repeat == 0 || milliseconds < best)
+                best = milliseconds;
+            }
+            result.milliseconds += best;
+            simplified = &fromScratch;
+          }
+
+          result.triangles += simplified->Indices.size() / 3;
+          result.error = std::max(result.error, error);
+          measureError(mesh, *simplified, measured);
+          size_t open = openEdges(*simplified);
+          if (open > meshOpenEdges[m])
+            result.openEdges += open - meshOpenEdges[m];
+        }
+        if (!any)
+          break;
+
+        if (direct && result.milliseconds > 0.0)
+          result.trianglesPerSecond = triangleCount / (result.milliseconds / 1000.0);
+        result.measuredError = measured.maxError;
+        result.meanError = measured.samples > 0 ? (float)(measured.errorSum / measured.samples) : 0.0f;
+        results.push_back(result);
+      }
+    }
+
+    if (out)
+    {
+      *out << path << ": " << loader.LoadedMeshes.size() << " meshes, " << triangleCount << " triangles, chain of "
+        << lodOptions.Levels << " levels in " << std::fixed << std::setprecision(1) << chainMilliseconds << " ms ("
+        << std::setprecision(2) << (chainMilliseconds > 0.0 ? chainTriangles / (chainMilliseconds * 1000.0) : 0.0)
+        << " M triangles/s in)" << std::endl;
+      *out << "level\t\ttriangles\tms\tM tri/s\terror\tmeasured\tmean\topened" << std::endl;
+      for (const SimplifyResult& result : results)
+      {
+        *out << std::left << std::setw(16) << result.level << std::right << result.triangles << "\t\t";
+        if (result.milliseconds > 0.0)
+          *out << std::setprecision(1) << result.milliseconds << "\t" << std::setprecision(2) << result.trianglesPerSecond / 1000000.0 << "\t";
+        else
+          *out << "-\t-\t";
+        *out << std::setprecision(4) << result.error << "\t" << result.measuredError << "\t\t" << result.meanError << "\t" << result.openEdges << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct SimplifyResult
+  {
+    std::string level;               // "lod N" out of objl::simplify::GenerateLods, or "direct N" from the mesh itself
+    size_t triangles = 0;            // Every mesh at this level
+    double milliseconds = 0.0;       // Direct rows only, best of the repeats
+    double trianglesPerSecond = 0.0; // Triangles going in over the time, direct rows only
+    float error = 0.0f;              // Largest error the simplifier reported for a mesh
+    float measuredError = 0.0f;      // Largest distance from an original vertex to the level's surface
+    float meanError = 0.0f;          // Mean of the same distances
+    size_t openEdges = 0;            // Edges with a triangle on one side only, by position, that the mesh didn't have
+  };
+
+  // Loads the .obj at path with welded vertices, builds the LOD chain of every mesh with
+  // objl::simplify::GenerateLods and simplifies every mesh from scratch down to each level's
+  // triangle count. Errors are relative to each mesh's largest side, the measured ones sample
+  // up to 20000 original vertices per mesh.
+  std::vector<SimplifyResult> RunSimplifyBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/EngineSystem.h"
+#include "core/FixedTimestep.h"
+#include "core/FramePacer.h"
+
+#include <chrono>
+#include <tuple>
+#include <type_traits>
+
+namespace Core
+{
+  // Engine loop over a system set fixed at compile time, e.g.
+  //   StaticEngine<Systems::Windows, Systems::Graphics> engine(windows, graphics);
+  // Systems are called with class qualified calls (system.T::Update) out of a tuple,
+  // which skips the vtable even for EngineSystem subclasses and lets the calls inline.
+  // Systems run in order on the calling thread, there is no scheduler, telemetry or
+  // render pipeline, that is what the dynamic Engine is for.
+  template<typename... SystemTypes>
+  class StaticEngine
+  {
+  public:
+    static constexpr size_t SystemCount = sizeof...(SystemTypes);
+
+    StaticEngine(SystemTypes&... systems) : systems(systems...) {}
+
+    void Initialize()
+    {
+      forEach([](auto& system) { using T = std::remove_reference_t<decltype(system)>; system.T::Initialize(); });
+    }
+
+    void Update(float dt)
+    {
+      forEach([dt](auto& system) { using T = std::remove_reference_t<decltype(system)>; system.T::Update(dt); });
+    }
+
+    void FixedUpdate(float dt)
+    {
+      forEach([dt](auto& system) { using T = std::remove_reference_t<decltype(system)>; system.T::FixedUpdate(dt); });
+    }
+
+    void Cleanup()
+    {
+      forEach([](auto& system) { using T = std::remove_reference_t<decltype(system)>; system.T::Cleanup(); });
+    }
+
+    // One loop iteration: the fixed steps due for elapsed, then Update.
+    void Frame(FixedTimestep::Duration elapsed)
+    {
+      unsigned int fixedSteps = fixedTimestep.Advance(elapsed);
+      for (unsigned int step = 0; step < fixedSteps; ++step)
+      {
+        FixedUpdate(fixedTimestep.GetStepSeconds());
+      }
+      Update((float)std::chrono::duration<double>(elapsed).count());
+    }
+
+    // Runs until Stop, pacing to targetFrameTime when it is above 0.
+    void Start(double targetFrameTime = 0.0)
+    {
+      Initialize();
+      interruptLoop = false;
+      if (targetFrameTime > 0.0)
+        framePacer.SetTargetFrameTime(targetFrameTime);
+
+      auto previousFrameTime = std::chrono::steady_clock::now();
+      while (!interruptLoop)
+      {
+        auto currentFrameTime = std::chrono::steady_clock::now();
+        Frame(currentFrameTime - previousFrameTime);
+        previousFrameTime = currentFrameTime;
+
+        if (targetFrameTime > 0.0)
+          framePacer.WaitForNextFrame();
+      }
+
+      Cleanup();
+    }
+
+    void Stop() { interruptLoop = true; }
+
+    template<size_t Index>
+    auto& Get() { return std::get<Index>(systems); }
+    FixedTimestep* GetFixedTimestep() { return &fixedTimestep; }
+    FramePacer* GetFramePacer() { return &framePacer; }
+  private:
+    template<typename Function>
+    void forEach(Function&& function)
+    {
+      std::apply([&function](auto&... system) { (function(system), ...); }, systems);
+    }
+
+    std::tuple<SystemTypes&...> systems;
+    FixedTimestep fixedTimestep{ 1.0 / 60.0, 5 };
+    FramePacer framePacer;
+    bool interruptLoop = false;
+  };
+}
@@ -0,0 +1,225 @@
+#include "PrecompiledHeader.h"
+#include "core/SystemScheduler.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Core
+{
+  void SystemScheduler::Build(const std::list<Systems::EngineSystem*>& systems)
+  {
+    buildGraph(Systems::SystemPhase::Update, systems);
+    buildGraph(Systems::SystemPhase::FixedUpdate, systems);
+  }
+
+  void SystemScheduler::buildGraph(Systems::SystemPhase phase, const std::list<Systems::EngineSystem*>& systems)
+  {
+    Graph& target = graph(phase);
+    target.nodes.clear();
+    target.roots.clear();
+
+    for (auto system : systems)
+    {
+      auto node = std::make_unique<Node>();
+      node->system = system;
+      node->timings = telemetry ? telemetry->GetTimings(system) : nullptr;
+      node->exclusive = !system->DeclareAccess(phase, node->access);
+      node->mainThread = system->RequiresMainThread();
+      target.nodes.push_back(std::move(node));
+    }
+
+    // Edges only ever point forward, so insertion order doubles as a topological order
+    int count = (int)target.nodes.size();
+    for (int j = 0; j < count; ++j)
+    {
+      Node& node = *target.nodes[j];
+      for (int i = 0; i < j; ++i)
+      {
+        if (conflicts(*target.nodes[i], node))
+        {
+          node.predecessors.push_back(i);
+          target.nodes[i]->successors.push_back(j);
+          node.depth = std::max(node.depth, target.nodes[i]->depth + 1);
+        }
+      }
+
+      if (node.predecessors.empty())
+        target.roots.push_back(j);
+    }
+  }
+
+  bool SystemScheduler::conflicts(const Node& first, const Node& second)
+  {
+    if (first.exclusive || second.exclusive)
+      return true;
+
+    auto touches = [](const std::vector<std::string>& resources, const std::string& resource) {
+      return std::find(resources.begin(), resources.end(), resource) != resources.end();
+    };
+
+    for (auto& resource : first.access.writes)
+    {
+      if (touches(second.access.writes, resource) || touches(second.access.reads, resource))
+        return true;
+    }
+    for (auto& resource : first.access.reads)
+    {
+      if (touches(second.access.writes, resource))
+        return true;
+    }
+    return false;
+  }
+
+  void SystemScheduler::Run(Systems::SystemPhase phase, float dt, JobSystem& jobSystem)
+  {
+    Graph& target = graph(phase);
+    if (target.nodes.empty())
+      return;
+
+    Execution execution;
+    execution.graph = &target;
+    execution.phase = phase;
+    execution.dt = dt;
+    execution.jobSystem = &jobSystem;
+    execution.nodesLeft = (int)target.nodes.size();
+
+    for (auto& node : target.nodes)
+    {
+      node->remaining.store((int)node->predecessors.size(), std::memory_order_relaxed);
+    }
+
+    for (int root : target.roots)
+    {
+      dispatch(execution, root);
+    }
+
+    // Run main thread systems as they become ready, otherwise help with the jobs
+    while (execution.nodesLeft.load(std::memory_order_acquire) > 0)
+    {
+      int ready = -1;
+      {
+        std::lock_guard<std::mutex> lock(execution.mainThreadMutex);
+        if (!execution.mainThreadReady.empty())
+        {
+          ready = execution.mainThreadReady.front();
+          execution.mainThreadReady.erase(execution.mainThreadReady.begin());
+        }
+      }
+
+      if (ready >= 0)
+        runNode(execution, ready);
+      else if (!jobSystem.TryRunJob())
+        std::this_thread::yield();
+    }
+
+    // The last job may still be on its way out, it references execution
+    jobSystem.Wait(execution.counter);
+
+    target.totalWorkTime = 0.0;
+    target.criticalPathTime = 0.0;
+    std::vector<double> pathTime(target.nodes.size(), 0.0);
+    for (size_t i = 0; i < target.nodes.size(); ++i)
+    {
+      Node& node = *target.nodes[i];
+      double longestPredecessor = 0.0;
+      for (int predecessor : node.predecessors)
+      {
+        longestPredecessor = std::max(longestPredecessor, pathTime[predecessor]);
+      }
+      pathTime[i] = longestPredecessor + node.duration;
+
+      target.totalWorkTime += node.duration;
+      target.criticalPathTime = std::max(target.criticalPathTime, pathTime[i]);
+    }
+  }
+
+  void SystemScheduler::dispatch(Execution& execution, int index)
+  {
+    if (execution.graph->nodes[index]->mainThread)
+    {
+      std::lock_guard<std::mutex> lock(execution.mainThreadMutex);
+      execution.mainThreadReady.push_back(index);
+    }
+    else
+    {
+      Execution* shared = &execution;
+      execution.jobSystem->Submit([shared, index]() { runNode(*shared, index); }, &execution.counter);
+    }
+  }
+
+  void SystemScheduler::runNode(Execution& execution, int index)
+  {
+    Node& node = *execution.graph->nodes[index];
+
+    auto start = std::chrono::steady_clock::now();
+    if (execution.phase == Systems::SystemPhase::Update)
+    {
+      PROFILE_ZONE_CATEGORY(node.system->GetName(), "Update");
+      node.system->Update(execution.dt);
+    }
+    else
+    {
+      PROFILE_ZONE_CATEGORY(node.system->GetName(), "FixedUpdate");
+      node.system->FixedUpdate(execution.dt);
+    }
+    node.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (node.timings)
+      node.timings->Record(execution.phase == Systems::SystemPhase::Update ? SystemCall::Update : SystemCall::FixedUpdate, node.duration);
+
+    for (int successor : node.successors)
+    {
+      if (execution.graph->nodes[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        dispatch(execution, successor);
+    }
+
+    // Has to be the last thing touching execution, Run returns once it hits zero
+    execution.nodesLeft.fetch_sub(1, std::memory_order_release);
+  }
+
+  void SystemScheduler::DumpSchedule(std::ostream& out)
+  {
+    const Systems::SystemPhase phases[] = { Systems::SystemPhase::Update, Systems::SystemPhase::FixedUpdate };
+    for (auto phase : phases)
+    {
+      Graph& target = graph(phase);
+      int levels = 0;
+      for (auto& node : target.nodes)
+      {
+        levels = std::max(levels, node->depth + 1);
+      }
+
+      out << (phase == Systems::SystemPhase::Update ? "Update" : "FixedUpdate")
+        << ": " << target.nodes.size() << " systems in " << levels << " levels"
+        << ", last critical path " << target.criticalPathTime * 1000.0 << " ms"
+        << " of " << target.totalWorkTime * 1000.0 << " ms work" << std::endl;
+
+      for (auto& node : target.nodes)
+      {
+        out << "  [" << node->depth << "] " << node->system->GetName()
+          << (node->mainThread ? " (main thread)" : "")
+          << (node->exclusive ? " exclusive" : "");
+
+        if (!node->exclusive)
+        {
+          out << " reads {";
+          for (size_t i = 0; i < node->access.reads.size(); ++i)
+            out << (i ? ", " : "") << node->access.reads[i];
+          out << "} writes {";
+          for (size_t i = 0; i < node->access.writes.size(); ++i)
+            out << (i ? ", " : "") << node->access.writes[i];
+          out << "}";
+        }
+
+        if (!node->predecessors.empty())
+        {
+          out << " after {";
+          for (size_t i = 0; i < node->predecessors.size(); ++i)
+            out << (i ? ", " : "") << target.nodes[node->predecessors[i]]->system->GetName();
+          out << "}";
+        }
+        out << " " << node->duration * 1000.0 << " ms" << std::endl;
+      }
+    }
+  }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/EngineSystem.h"
+#include "core/JobSystem.h"
+#include "core/SystemTelemetry.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Core
+{
+  // Builds a dependency graph per phase out of the systems' declared access and
+  // runs systems without conflicts concurrently. Conflicting systems keep the
+  // order they were added to the engine in.
+  class SystemScheduler
+  {
+  public:
+    SystemScheduler() {}
+
+    // Every system call gets recorded into the telemetry when one is set.
+    void SetTelemetry(SystemTelemetry* telemetry) { this->telemetry = telemetry; }
+
+    void Build(const std::list<Systems::EngineSystem*>& systems);
+    void Run(Systems::SystemPhase phase, float dt, JobSystem& jobSystem);
+
+    void DumpSchedule(std::ostream& out);
+
+    // Timings of the last Run of a phase, in seconds. The critical path is the longest
+    // dependency chain, so total work / critical path is the parallelism we got.
+    double GetCriticalPathTime(Systems::SystemPhase phase) { return graph(phase).criticalPathTime; }
+    double GetTotalWorkTime(Systems::SystemPhase phase) { return graph(phase).totalWorkTime; }
+  protected:
+    SystemScheduler(SystemScheduler const&) = delete;
+    void operator=(SystemScheduler const&) = delete;
+  private:
+    struct Node
+    {
+      Systems::EngineSystem* system = nullptr;
+      SystemTimings* timings = nullptr;
+      Systems::SystemAccess access;
+      bool exclusive = false;
+      bool mainThread = false;
+      std::vector<int> predecessors;
+      std::vector<int> successors;
+      int depth = 0; // longest chain of predecessors, in nodes
+      std::atomic<int> remaining{ 0 };
+      double duration = 0.0;
+    };
+
+    struct Graph
+    {
+      std::vector<std::unique_ptr<Node>> nodes;
+      std::vector<int> roots;
+      double criticalPathTime = 0.0;
+      double totalWorkTime = 0.0;
+    };
+
+    // State shared by everything that runs during one phase.
+    struct Execution
+    {
+      Graph* graph;
+      Systems::SystemPhase phase;
+      float dt;
+      JobSystem* jobSystem;
+      JobCounter counter;
+      std::atomic<int> nodesLeft{ 0 };
+      std::mutex mainThreadMutex;
+      std::vector<int> mainThreadReady;
+    };
+
+    Graph& graph(Systems::SystemPhase phase) { return phase == Systems::SystemPhase::Update ? updateGraph : fixedUpdateGraph; }
+    void buildGraph(Systems::SystemPhase phase, const std::list<Systems::EngineSystem*>& systems);
+    static bool conflicts(const Node& first, const Node& second);
+    static void dispatch(Execution& execution, int index);
+    static void runNode(Execution& execution, int index);
+
+    Graph updateGraph;
+    Graph fixedUpdateGraph;
+    SystemTelemetry* telemetry = nullptr;
+  };
+}
@@ -0,0 +1,166 @@
+#include "PrecompiledHeader.h"
+#include "core/SystemTelemetry.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Core
+{
+  static const char* callNames[] = { "Initialize", "Update", "FixedUpdate", "Cleanup" };
+
+  void TimingRing::Record(double seconds)
+  {
+    double nanoseconds = seconds * 1000000000.0;
+    uint32_t sample = nanoseconds >= 4294967295.0 ? 4294967295u : (uint32_t)(nanoseconds > 0.0 ? nanoseconds : 0.0);
+
+    uint64_t index = head.load(std::memory_order_relaxed);
+    samples[index & mask].store(sample, std::memory_order_relaxed);
+    head.store(index + 1, std::memory_order_release);
+  }
+
+  void TimingRing::Snapshot(std::vector<double>& out)
+  {
+    out.clear();
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > TELEMETRY_WINDOW ? end - TELEMETRY_WINDOW : 0;
+
+    for (uint64_t i = begin; i < end; ++i)
+    {
+      out.push_back(samples[i & mask].load(std::memory_order_relaxed) / 1000000000.0);
+    }
+
+    // The writer may have lapped us while copying, drop whatever it could have overwritten
+    uint64_t after = head.load(std::memory_order_acquire);
+    uint64_t overwritten = after > TELEMETRY_WINDOW ? after - TELEMETRY_WINDOW : 0;
+    if (overwritten > begin)
+    {
+      size_t stale = (size_t)std::min<uint64_t>(overwritten - begin, out.size());
+      out.erase(out.begin(), out.begin() + stale);
+    }
+  }
+
+  SystemTelemetry::SystemTelemetry()
+  {
+    timings.push_back(std::make_unique<SystemTimings>());
+    frameTimings = timings.back().get();
+    frameTimings->name = "Frame";
+  }
+
+  SystemTimings* SystemTelemetry::GetTimings(Systems::EngineSystem* system)
+  {
+    for (auto& entry : timings)
+    {
+      if (entry->system == system)
+        return entry.get();
+    }
+
+    timings.push_back(std::make_unique<SystemTimings>());
+    SystemTimings* entry = timings.back().get();
+    entry->system = system;
+    entry->name = system->GetName();
+    return entry;
+  }
+
+  std::vector<TimingStats> SystemTelemetry::ComputeStats()
+  {
+    std::vector<TimingStats> result;
+    std::vector<double> window;
+
+    // Nearest rank percentile
+    auto percentile = [&window](double p) {
+      size_t rank = (size_t)(p * window.size() + 0.999999);
+      rank = std::clamp(rank, (size_t)1, window.size());
+      return window[rank - 1];
+    };
+
+    for (auto& entry : timings)
+    {
+      for (int call = 0; call < (int)SystemCall::Count; ++call)
+      {
+        entry->calls[call].Snapshot(window);
+        if (window.empty())
+          continue;
+
+        std::sort(window.begin(), window.end());
+
+        TimingStats stats;
+        stats.name = entry->name;
+        stats.call = (SystemCall)call;
+        stats.count = entry->calls[call].GetCount();
+        stats.p50 = percentile(0.50);
+        stats.p95 = percentile(0.95);
+        stats.p99 = percentile(0.99);
+        stats.max = window.back();
+        result.push_back(stats);
+      }
+    }
+
+    return result;
+  }
+
+  void SystemTelemetry::WriteCsv(std::ostream& out, bool header)
+  {
+    if (header)
+      out << "time,system,call,count,p50_ms,p95_ms,p99_ms,max_ms" << std::endl;
+
+    for (auto& stats : ComputeStats())
+    {
+      out << runTime << "," << stats.name << "," << callNames[(int)stats.call] << "," << stats.count
+        << "," << stats.p50 * 1000.0 << "," << stats.p95 * 1000.0
+        << "," << stats.p99 * 1000.0 << "," << stats.max * 1000.0 << std::endl;
+    }
+  }
+
+  // One object per line so periodic dumps can be appended to the same file
+  void SystemTelemetry::WriteJson(std::ostream& out)
+  {
+    out << "{\"time\":" << runTime << ",\"systems\":[";
+    bool first = true;
+    for (auto& stats : ComputeStats())
+    {
+      out << (first ? "" : ",")
+        << "{\"system\":\"" << stats.name << "\",\"call\":\"" << callNames[(int)stats.call]
+        << "\",\"count\":" << stats.count
+        << ",\"p50_ms\":" << stats.p50 * 1000.0 << ",\"p95_ms\":" << stats.p95 * 1000.0
+        << ",\"p99_ms\":" << stats.p99 * 1000.0 << ",\"max_ms\":" << stats.max * 1000.0 << "}";
+      first = false;
+    }
+    out << "]}" << std::endl;
+  }
+
+  void SystemTelemetry::SetPeriodicDump(double intervalSeconds, const std::string& path, TelemetryFormat format)
+  {
+    dumpInterval = intervalSeconds;
+    dumpPath = path;
+    dumpFormat = format;
+    sinceDump = 0.0;
+    wroteHeader = false;
+  }
+
+  void SystemTelemetry::Tick(double elapsedSeconds)
+  {
+    runTime += elapsedSeconds;
+    if (dumpInterval <= 0.0)
+      return;
+
+    sinceDump += elapsedSeconds;
+    if (sinceDump >= dumpInterval)
+    {
+      sinceDump = 0.0;
+      dump();
+    }
+  }
+
+  void SystemTelemetry::dump()
+  {
+    std::ofstream file(dumpPath, wroteHeader ? std::ios::app : std::ios::trunc);
+    if (!file.is_open())
+      return;
+
+    if (dumpFormat == TelemetryFormat::Csv)
+      WriteCsv(file, !wroteHeader);
+    else
+      WriteJson(file);
+    wroteHeader = true;
+  }
+}
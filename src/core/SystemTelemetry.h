@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/EngineSystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define TELEMETRY_WINDOW 512 // Samples kept per system and call, must be a power of two
+
+namespace Core
+{
+  enum class SystemCall
+  {
+    Initialize,
+    Update,
+    FixedUpdate,
+    Cleanup,
+    Count
+  };
+
+  enum class TelemetryFormat
+  {
+    Csv,
+    Json
+  };
+
+  // Last TELEMETRY_WINDOW durations of one call, written by whichever thread runs
+  // the system (never two at once) and read from the main thread without locks.
+  class TimingRing
+  {
+  public:
+    void Record(double seconds);
+    // Copies the samples in the window, oldest first, in seconds.
+    void Snapshot(std::vector<double>& out);
+    uint64_t GetCount() { return head.load(std::memory_order_acquire); }
+  private:
+    static constexpr uint64_t mask = TELEMETRY_WINDOW - 1;
+
+    std::atomic<uint64_t> head{ 0 };
+    std::atomic<uint32_t> samples[TELEMETRY_WINDOW] = {}; // nanoseconds
+  };
+
+  struct SystemTimings
+  {
+    std::string name;
+    Systems::EngineSystem* system = nullptr;
+    TimingRing calls[(int)SystemCall::Count];
+
+    void Record(SystemCall call, double seconds) { calls[(int)call].Record(seconds); }
+  };
+
+  struct TimingStats
+  {
+    std::string name;
+    SystemCall call = SystemCall::Update;
+    uint64_t count = 0;  // calls since start, the percentiles only cover the window
+    double p50 = 0.0;    // seconds
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  class SystemTelemetry
+  {
+  public:
+    SystemTelemetry();
+
+    // Timings for a system, created on first use. Only call from the main thread.
+    SystemTimings* GetTimings(Systems::EngineSystem* system);
+    void RecordFrame(double seconds) { frameTimings->Record(SystemCall::Update, seconds); }
+
+    // Percentiles per system and call over the current window, calls that never ran are skipped.
+    std::vector<TimingStats> ComputeStats();
+    void WriteCsv(std::ostream& out, bool header = true);
+    void WriteJson(std::ostream& out);
+
+    // Appends a dump to path every intervalSeconds of frame time, 0 turns it off.
+    void SetPeriodicDump(double intervalSeconds, const std::string& path, TelemetryFormat format);
+    void Tick(double elapsedSeconds);
+  protected:
+    SystemTelemetry(SystemTelemetry const&) = delete;
+    void operator=(SystemTelemetry const&) = delete;
+  private:
+    void dump();
+
+    std::vector<std::unique_ptr<SystemTimings>> timings;
+    SystemTimings* frameTimings;
+
+    double dumpInterval = 0.0;
+    double sinceDump = 0.0;
+    double runTime = 0.0;
+    bool wroteHeader = false;
+    std::string dumpPath;
+    TelemetryFormat dumpFormat = TelemetryFormat::Csv;
+  };
+}
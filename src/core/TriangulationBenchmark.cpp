@@ -0,0 +1,358 @@
+#include "PrecompiledHeader.h"
+#include "core/TriangulationBenchmark.h"
+#include "helper/OBJ_Loader.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+
+namespace
+{
+  struct Point
+  {
+    float x;
+    float y;
+  };
+
+  // Corners of one face in its own plane, repeats point at a position written once
+  struct Shape
+  {
+    std::vector<Point> points;
+    std::vector<int> corners;
+  };
+
+  Shape convexShape(int count)
+  {
+    Shape shape;
+    for (int i = 0; i < count; ++i)
+    {
+      float angle = 6.2831853f * i / count;
+      shape.points.push_back({ std::cos(angle), std::sin(angle) });
+      shape.corners.push_back(i);
+    }
+    return shape;
+  }
+
+  Shape starShape(int count)
+  {
+    Shape shape;
+    for (int i = 0; i < count; ++i)
+    {
+      float angle = 6.2831853f * i / count;
+      float radius = i % 2 == 0 ? 1.0f : 0.4f;
+      shape.points.push_back({ radius * std::cos(angle), radius * std::sin(angle) });
+      shape.corners.push_back(i);
+    }
+    return shape;
+  }
+
+  // count / 4 teeth standing on a bar
+  Shape combShape(int count)
+  {
+    Shape shape;
+    int teeth = count / 4;
+    shape.points.push_back({ 0.0f, 0.0f });
+    shape.points.push_back({ 2.0f * teeth - 1.0f, 0.0f });
+    for (int tooth = teeth - 1; tooth >= 0; --tooth)
+    {
+      shape.points.push_back({ 2.0f * tooth + 1.0f, 3.0f });
+      shape.points.push_back({ 2.0f * tooth, 3.0f });
+      if (tooth > 0)
+      {
+        shape.points.push_back({ 2.0f * tooth, 1.0f });
+        shape.points.push_back({ 2.0f * tooth - 1.0f, 1.0f });
+      }
+    }
+    for (int i = 0; i < (int)shape.points.size(); ++i)
+      shape.corners.push_back(i);
+    return shape;
+  }
+
+  // A disc with a hole, walked around the outside, across to the hole, around it the other way
+  // and back, so the two corners of the bridge come up twice
+  Shape bridgedShape(int count)
+  {
+    Shape shape;
+    int ring = (count - 2) / 2;
+    for (int i = 0; i < ring; ++i)
+    {
+      float angle = 6.2831853f * i / ring;
+      shape.points.push_back({ std::cos(angle), std::sin(angle) });
+    }
+    for (int i = 0; i < ring; ++i)
+    {
+      float angle = -6.2831853f * i / ring;
+      shape.points.push_back({ 0.5f * std::cos(angle), 0.5f * std::sin(angle) });
+    }
+    for (int i = 0; i < ring; ++i)
+      shape.corners.push_back(i);
+    shape.corners.push_back(0);
+    for (int i = 0; i < ring; ++i)
+      shape.corners.push_back(ring + i);
+    shape.corners.push_back(ring);
+    return shape;
+  }
+
+  struct Face
+  {
+    std::vector<objl::Vertex> corners;
+    bool convex = true;
+  };
+
+  // Same test the triangulator makes before it fans a face
+  bool isConvex(const std::vector<objl::Vertex>& corners)
+  {
+    if (corners.size() <= 3)
+      return true;
+    objl::Vector3 normal = objl::triangulate::polygonNormal(corners.data(), corners.size());
+    size_t count = corners.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+      const objl::Vector3& a = corners[i == 0 ? count - 1 : i - 1].Position;
+      const objl::Vector3& b = corners[i].Position;
+      const objl::Vector3& c = corners[i + 1 == count ? 0 : i + 1].Position;
+      if (objl::math::DotV3(objl::math::CrossV3(b - a, c - b), normal) < 0)
+        return false;
+    }
+    return true;
+  }
+
+  // count - 2 triangles, none of them turned over, that add up to the face's area
+  bool coversFace(const std::vector<objl::Vertex>& corners, const std::vector<unsigned int>& indices)
+  {
+    size_t count = corners.size();
+    if (count < 3)
+      return indices.empty();
+    if (indices.size() != (count - 2) * 3)
+      return false;
+    for (unsigned int index : indices)
+    {
+      if (index >= count)
+        return false;
+    }
+
+    objl::Vector3 normal = objl::triangulate::polygonNormal(corners.data(), count);
+    float length = objl::math::MagnitudeV3(normal);
+    if (length == 0.0f)
+      return true;
+    normal = normal / length;
+    float area = length * 0.5f;
+
+    float covered = 0.0f;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+      const objl::Vector3& a = corners[indices[i]].Position;
+      const objl::Vector3& b = corners[indices[i + 1]].Position;
+      const objl::Vector3& c = corners[indices[i + 2]].Position;
+      float triangle = objl::math::DotV3(objl::math::CrossV3(b - a, c - a), normal) * 0.5f;
+      if (triangle < -area * 1e-4f)
+        return false;
+      covered += triangle;
+    }
+    return std::fabs(covered - area) <= area * 1e-3f;
+  }
+
+  std::vector<Face> readFaces(const std::string& path)
+  {
+    std::vector<Face> faces;
+    objl::MappedFile file;
+    if (!file.Open(path))
+      return faces;
+
+    std::vector<objl::Vector3> positions;
+    objl::scan::ForEachLine(file.Data(), file.Data() + file.Size(), [&](const objl::scan::Line& line)
+    {
+      std::string_view key = line.Key();
+      if (key == "v")
+      {
+        objl::Vector3 position;
+        objl::scan::parseFloats(line, &position.X, 3);
+        positions.push_back(position);
+      }
+      else if (key == "f")
+      {
+        Face face;
+        for (size_t t = 1; t < line.tokens.size(); ++t)
+        {
+          std::string_view parts[3];
+          objl::scan::splitCorner(line.tokens[t], parts);
+          const objl::Vector3* position = objl::algorithm::getElementView(positions, parts[0]);
+          if (!position)
+            continue;
+          objl::Vertex corner;
+          corner.Position = *position;
+          face.corners.push_back(corner);
+        }
+        face.convex = isConvex(face.corners);
+        faces.push_back(std::move(face));
+      }
+    });
+    return faces;
+  }
+}
+
+namespace Core
+{
+  bool WriteSyntheticNgonObj(const std::string& path)
+  {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+      return false;
+
+    std::fprintf(file, "# synthetic n-gon benchmark faces\no ngons\n");
+    const int copies = 64;
+    int written = 0;
+    for (int count = 4; count <= 128; count *= 2)
+    {
+      std::vector<Shape> shapes = { convexShape(count), starShape(count), combShape(count) };
+      if (count >= 8)
+        shapes.push_back(bridgedShape(count));
+
+      for (const Shape& shape : shapes)
+      {
+        for (int copy = 0; copy < copies; ++copy)
+        {
+          // Tip the plane a different way for every copy, the first one lies flat on the ground
+          float theta = copy * 0.7f, phi = copy * 1.3f;
+          float normal[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+          float helper[3] = { 1.0f, 0.0f, 0.0f };
+          if (std::fabs(normal[0]) > 0.9f)
+          {
+            helper[0] = 0.0f;
+            helper[2] = 1.0f;
+          }
+          float u[3] = { helper[1] * normal[2] - helper[2] * normal[1], helper[2] * normal[0] - helper[0] * normal[2], helper[0] * normal[1] - helper[1] * normal[0] };
+          float uLength = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+          for (float& axis : u)
+            axis /= uLength;
+          float v[3] = { normal[1] * u[2] - normal[2] * u[1], normal[2] * u[0] - normal[0] * u[2], normal[0] * u[1] - normal[1] * u[0] };
+          float origin[3] = { copy * 3.0f, copy == 0 ? 0.0f : 2.0f, count * 0.5f };
+
+          for (const Point& point : shape.points)
+          {
+            std::fprintf(file, "v %.6f %.6f %.6f\n", origin[0] + u[0] * point.x + v[0] * point.y,
+              origin[1] + u[1] * point.x + v[1] * point.y, origin[2] + u[2] * point.x + v[2] * point.y);
+          }
+          std::fprintf(file, "f");
+          for (int corner : shape.corners)
+            std::fprintf(file, " %d", written + corner + 1);
+          std::fprintf(file, "\n");
+          written += (int)shape.points.size();
+        }
+      }
+    }
+
+    std::fclose(file);
+    return true;
+  }
+
+  std::vector<TriangulationResult> RunTriangulationBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<TriangulationResult> results;
+    std::vector<Face> faces = readFaces(path);
+    if (faces.empty())
+    {
+      if (out)
+        *out << "no faces in " << path << std::endl;
+      return results;
+    }
+    if (repeats == 0)
+      repeats = 1;
+
+    struct Subset
+    {
+      const char* name;
+      std::function<bool(const Face&)> contains;
+    };
+    std::vector<Subset> subsets = {
+      { "all", [](const Face&) { return true; } },
+      { "convex", [](const Face& face) { return face.convex; } },
+      { "concave", [](const Face& face) { return !face.convex; } },
+      { "4 corners", [](const Face& face) { return face.corners.size() <= 4; } },
+      { "5-16 corners", [](const Face& face) { return face.corners.size() > 4 && face.corners.size() <= 16; } },
+      { "17-64 corners", [](const Face& face) { return face.corners.size() > 16 && face.corners.size() <= 64; } },
+      { "65+ corners", [](const Face& face) { return face.corners.size() > 64; } },
+    };
+
+    std::vector<unsigned int> indices;
+    objl::triangulate::Scratch scratch;
+    size_t checksum = 0;
+
+    for (const Subset& subset : subsets)
+    {
+      std::vector<const Face*> chosen;
+      TriangulationResult result;
+      result.faces = subset.name;
+      for (const Face& face : faces)
+      {
+        if (subset.contains(face))
+        {
+          chosen.push_back(&face);
+          result.cornerCount += face.corners.size();
+        }
+      }
+      result.faceCount = chosen.size();
+      if (chosen.empty())
+        continue;
+
+      for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+      {
+        auto start = std::chrono::steady_clock::now();
+        for (const Face* face : chosen)
+        {
+          indices.clear();
+          objl::triangulate::Legacy(indices, face->corners);
+          checksum += indices.size();
+        }
+        double legacy = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (const Face* face : chosen)
+        {
+          indices.clear();
+          objl::triangulate::Polygon(indices, face->corners.data(), face->corners.size(), scratch);
+          checksum += indices.size();
+        }
+        double polygon = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (repeat == 0 || legacy < result.legacyMilliseconds)
+          result.legacyMilliseconds = legacy;
+        if (repeat == 0 || polygon < result.polygonMilliseconds)
+          result.polygonMilliseconds = polygon;
+      }
+
+      for (const Face* face : chosen)
+      {
+        indices.clear();
+        objl::triangulate::Legacy(indices, face->corners);
+        if (!coversFace(face->corners, indices))
+          ++result.legacyWrong;
+
+        indices.clear();
+        objl::triangulate::Polygon(indices, face->corners.data(), face->corners.size(), scratch);
+        if (!coversFace(face->corners, indices))
+          ++result.polygonWrong;
+      }
+      results.push_back(result);
+    }
+
+    if (out)
+    {
+      *out << path << ": " << faces.size() << " faces (checksum " << checksum << ")" << std::endl;
+      *out << "faces\t\tcount\tcorners\tlegacy ms\tnew ms\tspeedup\tlegacy wrong\tnew wrong" << std::endl;
+      for (const TriangulationResult& result : results)
+      {
+        *out << std::left << std::setw(16) << result.faces << std::right << result.faceCount << "\t" << result.cornerCount
+          << "\t" << std::fixed << std::setprecision(3) << result.legacyMilliseconds << "\t\t" << result.polygonMilliseconds
+          << "\t" << std::setprecision(1) << (result.polygonMilliseconds > 0.0 ? result.legacyMilliseconds / result.polygonMilliseconds : 0.0)
+          << "x\t" << result.legacyWrong << "\t\t" << result.polygonWrong << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct TriangulationResult
+  {
+    std::string faces;                 // Which faces of the file the row covers
+    size_t faceCount = 0;
+    size_t cornerCount = 0;
+    double legacyMilliseconds = 0.0;   // objl::triangulate::Legacy, best of the repeats
+    double polygonMilliseconds = 0.0;  // objl::triangulate::Polygon, best of the repeats
+    size_t legacyWrong = 0;            // Faces that didn't come out as count - 2 triangles covering the face
+    size_t polygonWrong = 0;
+  };
+
+  // Writes faces of 4 to 128 corners in planes facing every which way, convex ones, stars,
+  // combs and discs with a hole bridged by repeated corners, 64 copies of each.
+  bool WriteSyntheticNgonObj(const std::string& path);
+
+  // Triangulates every face of the .obj at path with the old and the new triangulator and checks
+  // the triangles, rows for all the faces, the convex ones and the rest.
+  std::vector<TriangulationResult> RunTriangulationBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
@@ -0,0 +1,150 @@
+#include "PrecompiledHeader.h"
+#include "core/VertexCacheBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "helper/OBJ_Optimize.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+namespace
+{
+  std::vector<std::array<unsigned int, 3>> sortedTriangles(const std::vector<unsigned int>& indices)
+  {
+    std::vector<std::array<unsigned int, 3>> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); ++t)
+      triangles[t] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  }
+
+  struct Order
+  {
+    const char* name;
+    bool reorder;
+    objl::optimize::VertexCacheAlgorithm algorithm;
+    bool overdraw;
+  };
+}
+
+namespace Core
+{
+  std::vector<VertexCacheResult> RunVertexCacheBenchmark(const std::string& path, unsigned int repeats, std::ostream* out)
+  {
+    std::vector<VertexCacheResult> results;
+
+    objl::Loader loader;
+    if (!LoadObjQuietly(loader, path, out))
+      return results;
+    if (repeats == 0)
+      repeats = 1;
+
+    using objl::optimize::VertexCacheAlgorithm;
+    const Order orders[] = {
+      { "file", false, VertexCacheAlgorithm::Tipsify, false },
+      { "tipsify", true, VertexCacheAlgorithm::Tipsify, false },
+      { "tipsify overdraw", true, VertexCacheAlgorithm::Tipsify, true },
+      { "forsyth", true, VertexCacheAlgorithm::Forsyth, false },
+      { "forsyth overdraw", true, VertexCacheAlgorithm::Forsyth, true },
+    };
+    const unsigned int fifoSize = 16, lruSize = 32;
+
+    size_t triangleCount = 0;
+    for (const objl::Mesh& mesh : loader.LoadedMeshes)
+      triangleCount += mesh.Indices.size() / 3;
+
+    for (const Order& order : orders)
+    {
+      VertexCacheResult result;
+      result.order = order.name;
+      size_t fifoTransforms = 0, lruTransforms = 0, usedVertices = 0;
+      size_t covered = 0, shaded = 0, fetched = 0, remappedFetched = 0, usedBytes = 0;
+
+      for (const objl::Mesh& mesh : loader.LoadedMeshes)
+      {
+        size_t indexCount = mesh.Indices.size() - mesh.Indices.size() % 3;
+        if (indexCount == 0)
+          continue;
+
+        std::vector<unsigned int> ordered(mesh.Indices.begin(), mesh.Indices.begin() + indexCount);
+        std::vector<unsigned int> scratch(indexCount);
+        double best = 0.0;
+        for (unsigned int repeat = 0; order.reorder && repeat < repeats; ++repeat)
+        {
+          auto start = std::chrono::steady_clock::now();
+          objl::optimize::OptimizeVertexCache(scratch.data(), mesh.Indices.data(), indexCount, mesh.Vertices.size(), order.algorithm, fifoSize);
+          if (order.overdraw)
+            objl::optimize::OptimizeOverdraw(ordered.data(), scratch.data(), indexCount, mesh.Vertices.data(), mesh.Vertices.size(), fifoSize);
+          else
+            ordered.swap(scratch);
+          double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+          if (repeat == 0 || milliseconds < best)
+            best = milliseconds;
+        }
+        result.milliseconds += best;
+
+        std::vector<unsigned int> original(mesh.Indices.begin(), mesh.Indices.begin() + indexCount);
+        if (sortedTriangles(ordered) != sortedTriangles(original))
+          ++result.wrongMeshes;
+
+        objl::optimize::CacheStats fifo = objl::optimize::AnalyzeVertexCache(ordered.data(), indexCount, mesh.Vertices.size(), fifoSize);
+        objl::optimize::CacheStats lru = objl::optimize::AnalyzeVertexCache(ordered.data(), indexCount, mesh.Vertices.size(), lruSize, objl::optimize::CacheKind::LRU);
+        fifoTransforms += fifo.Transforms;
+        lruTransforms += lru.Transforms;
+        if (fifo.ATVR > 0)
+          usedVertices += (size_t)(fifo.Transforms / fifo.ATVR + 0.5f);
+
+        objl::optimize::OverdrawStats overdraw = objl::optimize::AnalyzeOverdraw(ordered.data(), indexCount, mesh.Vertices.data(), mesh.Vertices.size());
+        covered += overdraw.Covered;
+        shaded += overdraw.Shaded;
+
+        objl::optimize::FetchStats fetch = objl::optimize::AnalyzeVertexFetch(ordered.data(), indexCount, mesh.Vertices.size());
+        fetched += fetch.BytesFetched;
+
+        std::vector<objl::Vertex> remapped(mesh.Vertices.size());
+        std::vector<unsigned int> remappedIndices = ordered;
+        size_t remappedCount = objl::optimize::OptimizeVertexFetch(remapped.data(), remappedIndices.data(), indexCount, mesh.Vertices.data(), mesh.Vertices.size());
+        usedBytes += remappedCount * sizeof(objl::Vertex);
+        remappedFetched += objl::optimize::AnalyzeVertexFetch(remappedIndices.data(), indexCount, remappedCount).BytesFetched;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+          if (std::memcmp(&remapped[remappedIndices[i]], &mesh.Vertices[ordered[i]], sizeof(objl::Vertex)) != 0)
+          {
+            ++result.wrongMeshes;
+            break;
+          }
+        }
+      }
+
+      if (triangleCount > 0)
+      {
+        result.fifoACMR = (float)fifoTransforms / triangleCount;
+        result.lruACMR = (float)lruTransforms / triangleCount;
+      }
+      result.ATVR = usedVertices > 0 ? (float)fifoTransforms / usedVertices : 0.0f;
+      result.overdraw = covered > 0 ? (float)shaded / covered : 0.0f;
+      result.overfetch = usedBytes > 0 ? (float)fetched / usedBytes : 0.0f;
+      result.remappedOverfetch = usedBytes > 0 ? (float)remappedFetched / usedBytes : 0.0f;
+      results.push_back(result);
+    }
+
+    if (out)
+    {
+      *out << path << ": " << loader.LoadedMeshes.size() << " meshes, " << triangleCount << " triangles, "
+        << loader.LoadedVertices.size() << " welded vertices" << std::endl;
+      *out << "order\t\t\tms\tACMR 16\tACMR 32\tATVR\toverdraw\toverfetch\tremapped\twrong" << std::endl;
+      for (const VertexCacheResult& result : results)
+      {
+        *out << std::left << std::setw(24) << result.order << std::right << std::fixed << std::setprecision(1) << result.milliseconds
+          << "\t" << std::setprecision(3) << result.fifoACMR << "\t" << result.lruACMR << "\t" << result.ATVR << "\t" << result.overdraw
+          << "\t\t" << result.overfetch << "\t\t" << result.remappedOverfetch << "\t\t" << result.wrongMeshes << std::endl;
+      }
+      out->unsetf(std::ios::floatfield);
+      *out << std::setprecision(6);
+    }
+
+    return results;
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Core
+{
+  struct VertexCacheResult
+  {
+    std::string order;               // Which triangle order the row is
+    double milliseconds = 0.0;       // Reordering every mesh, best of the repeats
+    float fifoACMR = 0.0f;           // Transforms per triangle with a 16 entry FIFO cache
+    float lruACMR = 0.0f;            // Transforms per triangle with a 32 entry LRU cache
+    float ATVR = 0.0f;               // Transforms per vertex used with the FIFO cache
+    float overdraw = 0.0f;           // Pixels shaded per pixel covered, all six axis views
+    float overfetch = 0.0f;          // Vertex bytes read per vertex byte used, in the loaded vertex order
+    float remappedOverfetch = 0.0f;  // The same after objl::optimize::OptimizeVertexFetch
+    size_t wrongMeshes = 0;          // Meshes that didn't keep exactly their triangles
+  };
+
+  // Loads the .obj at path with welded vertices and reorders every mesh with objl::optimize,
+  // Tipsify and Forsyth each with and without the overdraw pass, and simulates the vertex cache,
+  // overdraw and vertex fetch of every order against the file's own.
+  std::vector<VertexCacheResult> RunVertexCacheBenchmark(const std::string& path, unsigned int repeats, std::ostream* out = nullptr);
+}
@@ -10,12 +10,15 @@
 
 #define DEBUG_GRAPHICS
 #define NUM_FRAMES 3 // The number of swap chain back buffers.
+// Render snapshots on the engine's render thread instead of from WM_PAINT. Uses the
+// triple buffered pipeline so the message pump never blocks on Present.
+#define PIPELINED_RENDERING
 
 using namespace Microsoft::WRL;
 
 namespace Systems 
 {
-  class Graphics : public EngineSystem
+  class Graphics : public EngineSystem, public Core::RenderConsumer
   {
   public:
     Graphics() {}
@@ -29,7 +32,9 @@ namespace Systems
     virtual void Update(float dt) {}
     virtual void FixedUpdate(float dt) {}
     virtual void Cleanup();
+    virtual const char* GetName() { return "Graphics"; }
     void Render();
+    virtual void Consume(const Core::FrameSnapshot& snapshot) { Render(); }
   private:
     // Used for the singleton, C++ 11, deletes these functions
     Graphics(Graphics const&) = delete;
@@ -1,6 +1,7 @@
 #include "PrecompiledHeader.h"
 #include "graphics/GraphcisSystem.h"
 #include "windows/WindowsSystem.h"
+#include "core/Profiler.h"
 
 #include <iostream>
 #include <cassert>
@@ -66,6 +67,8 @@ namespace Systems
     if (!initialized)
       return;
 
+    PROFILE_ZONE("Graphics::Render");
+
     auto commandAllocator = commandAllocators[currentBackBufferIndex];
     auto backBuffer = backBuffers[currentBackBufferIndex];
 
@@ -408,6 +411,7 @@ namespace Systems
   {
     if (fence->GetCompletedValue() < fenceValue)
     {
+      PROFILE_ZONE("Graphics::WaitForFence");
       throwIfFailed(fence->SetEventOnCompletion(fenceValue, fenceEvent));
       WaitForSingleObject(fenceEvent, static_cast<DWORD>(duration.count()));
     }
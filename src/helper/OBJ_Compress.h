@@ -0,0 +1,799 @@
+// OBJ_Compress.h - Lossless Index and Vertex Buffer Compression for OBJ_Loader Meshes
+
+#pragma once
+
+// OBJ_Loader.h - Vertex and Mesh
+#include "helper/OBJ_Loader.h"
+
+// Namespace: OBJL
+//
+// Description: The namespace that holds eveyrthing that
+//	is needed and used for the OBJ Model Loader
+namespace objl
+{
+	// Namespace: Compress
+	//
+	// Description: Shrinks the index and vertex buffers of a mesh
+	//	for shipping, decoding back to exactly the same bytes.
+	//	Indices are coded a triangle at a time against the edges and
+	//	vertices of the triangles just before it, vertices as byte
+	//	deltas from the vertex before them, transposed into one plane
+	//	per byte of the vertex so the bytes that barely change pack
+	//	down to a few bits. Both do best on meshes ordered by
+	//	optimize::OptimizeVertexCache and OptimizeVertexFetch first.
+	//	Decoders check every read against the input and fail instead
+	//	of reading past it, the output is then undefined.
+	//	Decoding targets DecodeTargetBytesPerSecond of output per core
+	//	and doesn't always make it. On a 2 GHz Xeon core at full speed
+	//	every buffer of the --bench-compress meshes decodes at 1.3 to
+	//	2.8 GB/s, but once the core throttles the indices of the
+	//	synthetic mesh fall to 0.82 to 0.94 GB/s, so do its optimized
+	//	vertices now and then, while a torus still decodes at 1.2 GB/s
+	//	or more. --bench-compress marks every rate under the target
+	namespace compress
+	{
+		// Decode speed the codec is meant to reach, bytes out per second
+		const double DecodeTargetBytesPerSecond = 1e9;
+
+		// First byte of every encoded buffer, the high nibble says which
+		//	kind it is and the low one which version of the layout
+		const uint8_t IndexHeader = 0xE1;
+		const uint8_t VertexHeader = 0xA1;
+
+		// Recent edges and vertices the index coder can refer back to.
+		//	Edge codes 0 to 14 and vertex codes 1 to 14 say how far back
+		const unsigned int EdgeFifoSize = 16;
+		const unsigned int VertexFifoSize = 16;
+
+		// Index code byte of a triangle sharing no recent edge, the low
+		//	three bits say which of its corners are the next new vertex.
+		//	The others are a varint each, under VertexFifoSize how far
+		//	back in the vertex fifo, else that much more than the delta
+		const uint8_t CodeNoEdge = 0xF0;
+		// Low nibble of an edge code whose third corner is the next new
+		//	vertex, or is written out in full
+		const uint8_t CodeNext = 0x0;
+		const uint8_t CodeFree = 0xF;
+
+		// What a no edge code says about the varints after it when they
+		//	are all one byte: which byte each corner reads, how many there
+		//	are, and their high bits, any of which set means a longer one
+		struct NoEdgeRule
+		{
+			uint8_t Offsets[3] = {};
+			uint8_t DataBytes = 0;
+			uint32_t LongMask = 0;
+		};
+
+		struct NoEdgeRules
+		{
+			NoEdgeRule Rules[8];
+		};
+
+		constexpr NoEdgeRules makeNoEdgeRules()
+		{
+			NoEdgeRules table;
+			for (unsigned int nextMask = 0; nextMask < 8; nextMask++)
+			{
+				NoEdgeRule& rule = table.Rules[nextMask];
+				for (unsigned int corner = 0; corner < 3; corner++)
+				{
+					rule.Offsets[corner] = rule.DataBytes;
+					if (!(nextMask >> corner & 1))
+						rule.LongMask |= 0x80u << (rule.DataBytes++ * 8);
+				}
+			}
+			return table;
+		}
+
+		// Indexed by the low three bits of a no edge code
+		inline constexpr NoEdgeRules NoEdgeCodeRules = makeNoEdgeRules();
+
+		inline void writeVarint(std::vector<uint8_t>& out, uint32_t value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back((uint8_t)value);
+		}
+
+		// False if the varint runs off the end or past 32 bits
+		inline bool readVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value)
+		{
+			// Most are a single byte
+			if (data != end && *data < 0x80)
+			{
+				value = *data++;
+				return true;
+			}
+			value = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				if (data == end)
+					return false;
+				uint8_t byte = *data++;
+				value |= (uint32_t)(byte & 0x7F) << shift;
+				if (byte < 0x80)
+					return true;
+			}
+			return false;
+		}
+
+		inline uint32_t zigzag(int32_t value)
+		{
+			return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+		}
+
+		inline int32_t unzigzag(uint32_t value)
+		{
+			return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+		}
+
+		// Encode a triangle list, indexCount has to be a multiple of 3.
+		//	The triangles and the order of their corners are kept
+		//	exactly, decode with the same indexCount
+		inline std::vector<uint8_t> EncodeIndexBuffer(const unsigned int* indices, size_t indexCount)
+		{
+			std::vector<uint8_t> out;
+			if (indexCount % 3 != 0)
+				return out;
+			size_t triangleCount = indexCount / 3;
+
+			// Header, a code per triangle, two bits of rotation per triangle, then the varints
+			std::vector<uint8_t> data;
+			out.resize(1 + triangleCount + (triangleCount + 3) / 4, 0);
+			out[0] = IndexHeader;
+			uint8_t* codes = out.data() + 1;
+			uint8_t* rotations = codes + triangleCount;
+
+			unsigned int edges[EdgeFifoSize][2] = {};
+			unsigned int vertexFifo[VertexFifoSize] = {};
+			size_t edgeCount = 0, vertexCount = 0;
+			unsigned int next = 0, last = 0;
+
+			auto pushEdge = [&](unsigned int a, unsigned int b)
+			{
+				edges[edgeCount % EdgeFifoSize][0] = a;
+				edges[edgeCount % EdgeFifoSize][1] = b;
+				edgeCount++;
+			};
+			auto pushVertex = [&](unsigned int v)
+			{
+				vertexFifo[vertexCount % VertexFifoSize] = v;
+				vertexCount++;
+			};
+			auto writeFree = [&](unsigned int v)
+			{
+				writeVarint(data, zigzag((int32_t)(v - last)));
+				last = v;
+			};
+
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				const unsigned int* triangle = indices + t * 3;
+
+				// A recent edge run the other way is one of this triangle's,
+				//	rotate the triangle so it comes first
+				int edge = -1, rotation = 0;
+				for (unsigned int e = 0; e < EdgeFifoSize - 1 && e < edgeCount && edge < 0; e++)
+				{
+					const unsigned int* candidate = edges[(edgeCount - 1 - e) % EdgeFifoSize];
+					for (int r = 0; r < 3; r++)
+					{
+						if (triangle[r] == candidate[1] && triangle[(r + 1) % 3] == candidate[0])
+						{
+							edge = (int)e;
+							rotation = r;
+							break;
+						}
+					}
+				}
+
+				if (edge >= 0)
+				{
+					unsigned int a = triangle[rotation], b = triangle[(rotation + 1) % 3], c = triangle[(rotation + 2) % 3];
+					uint8_t third = CodeFree;
+					if (c == next)
+					{
+						third = CodeNext;
+						next++;
+						pushVertex(c);
+					}
+					else
+					{
+						for (unsigned int v = 0; v < VertexFifoSize - 2 && v < vertexCount; v++)
+						{
+							if (vertexFifo[(vertexCount - 1 - v) % VertexFifoSize] == c)
+							{
+								third = (uint8_t)(v + 1);
+								break;
+							}
+						}
+						if (third == CodeFree)
+						{
+							writeFree(c);
+							pushVertex(c);
+						}
+					}
+					codes[t] = (uint8_t)(edge << 4) | third;
+					rotations[t / 4] |= (uint8_t)(rotation << (t % 4 * 2));
+					pushEdge(b, c);
+					pushEdge(c, a);
+				}
+				else
+				{
+					uint8_t code = CodeNoEdge;
+					for (int corner = 0; corner < 3; corner++)
+					{
+						unsigned int v = triangle[corner];
+						if (v == next)
+						{
+							code |= (uint8_t)(1 << corner);
+							next++;
+						}
+						else
+						{
+							// Recent vertices are one byte, the rest come after them. The oldest
+							//	slot is off limits, the decoder writes it ahead of time
+							uint32_t recent = VertexFifoSize;
+							for (unsigned int r = 0; r < VertexFifoSize - 1 && r < vertexCount; r++)
+							{
+								if (vertexFifo[(vertexCount - 1 - r) % VertexFifoSize] == v)
+								{
+									recent = r;
+									break;
+								}
+							}
+							if (recent < VertexFifoSize)
+							{
+								data.push_back((uint8_t)recent);
+							}
+							else
+							{
+								writeVarint(data, VertexFifoSize + zigzag((int32_t)(v - last)));
+								last = v;
+							}
+						}
+						pushVertex(v);
+					}
+					codes[t] = code;
+					pushEdge(triangle[0], triangle[1]);
+					pushEdge(triangle[1], triangle[2]);
+					pushEdge(triangle[2], triangle[0]);
+				}
+			}
+
+			out.insert(out.end(), data.begin(), data.end());
+			return out;
+		}
+
+		// Decode indexCount indices encoded by EncodeIndexBuffer
+		inline bool DecodeIndexBuffer(unsigned int* indices, size_t indexCount, const uint8_t* buffer, size_t size)
+		{
+			if (indexCount % 3 != 0)
+				return false;
+			size_t triangleCount = indexCount / 3;
+			size_t fixed = 1 + triangleCount + (triangleCount + 3) / 4;
+			if (size < fixed || buffer[0] != IndexHeader)
+				return false;
+			const uint8_t* codes = buffer + 1;
+			const uint8_t* rotations = codes + triangleCount;
+			const uint8_t* data = buffer + fixed;
+			const uint8_t* end = buffer + size;
+
+			// The fifos are rings indexed with a wrapping counter, an edge
+			//	is kept as one word with its start in the low half
+			uint64_t edges[EdgeFifoSize] = {};
+			unsigned int vertexFifo[VertexFifoSize] = {};
+			unsigned int edgeCount = 0, vertexCount = 0;
+			unsigned int next = 0, last = 0;
+
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				unsigned int code = codes[t];
+				unsigned int* triangle = indices + t * 3;
+
+				if (code < CodeNoEdge)
+				{
+					uint64_t edge = edges[(edgeCount - 1 - (code >> 4)) % EdgeFifoSize];
+					unsigned int a = (unsigned int)(edge >> 32), b = (unsigned int)edge, c;
+					unsigned int third = code & 0xF;
+					if (third != CodeFree)
+					{
+						// Next and recent vertices are both common, pick without a branch
+						//	and only count the vertex into the fifo if it is new
+						unsigned int isNext = third == CodeNext;
+						c = isNext ? next : vertexFifo[(vertexCount - third) % VertexFifoSize];
+						vertexFifo[vertexCount % VertexFifoSize] = c;
+						vertexCount += isNext;
+						next += isNext;
+					}
+					else
+					{
+						uint32_t value;
+						if (!readVarint(data, end, value))
+							return false;
+						c = last += (unsigned int)unzigzag(value);
+						vertexFifo[vertexCount++ % VertexFifoSize] = c;
+					}
+
+					// Undo the rotation that brought the shared edge first
+					unsigned int rotation = rotations[t / 4] >> (t % 4 * 2) & 3;
+					unsigned int x = a, y = b, z = c;
+					if (rotation == 1)
+					{
+						x = c;
+						y = a;
+						z = b;
+					}
+					if (rotation == 2)
+					{
+						x = b;
+						y = c;
+						z = a;
+					}
+					triangle[0] = x;
+					triangle[1] = y;
+					triangle[2] = z;
+					edges[edgeCount % EdgeFifoSize] = b | (uint64_t)c << 32;
+					edges[(edgeCount + 1) % EdgeFifoSize] = c | (uint64_t)a << 32;
+					edgeCount += 2;
+					continue;
+				}
+
+				const NoEdgeRule& rule = NoEdgeCodeRules.Rules[code & 7];
+				unsigned int corners[3];
+				uint32_t bytes;
+				if (end - data >= 4 && (memcpy(&bytes, data, 4), (bytes & rule.LongMask) == 0))
+				{
+					// Every varint is one byte and the code says where, so pick
+					//	next, recent or delta for each corner without a branch
+					auto decodeCorner = [&](unsigned int corner)
+					{
+						unsigned int isNext = code >> corner & 1;
+						unsigned int value = bytes >> (rule.Offsets[corner] * 8) & 0xFF;
+						unsigned int recent = vertexFifo[(vertexCount - 1 - value) % VertexFifoSize];
+						unsigned int free = last + (unsigned int)unzigzag(value - VertexFifoSize);
+						unsigned int isFree = !isNext & (value >= VertexFifoSize);
+						unsigned int v = isNext ? next : value < VertexFifoSize ? recent : free;
+						last = isFree ? free : last;
+						next += isNext;
+						vertexFifo[vertexCount++ % VertexFifoSize] = v;
+						return v;
+					};
+					corners[0] = decodeCorner(0);
+					corners[1] = decodeCorner(1);
+					corners[2] = decodeCorner(2);
+					data += rule.DataBytes;
+				}
+				else
+				{
+					for (int corner = 0; corner < 3; corner++)
+					{
+						unsigned int v;
+						if (code >> corner & 1)
+							v = next++;
+						else
+						{
+							uint32_t value;
+							if (!readVarint(data, end, value))
+								return false;
+							v = value < VertexFifoSize ? vertexFifo[(vertexCount - 1 - value) % VertexFifoSize]
+								: (last += (unsigned int)unzigzag(value - VertexFifoSize));
+						}
+						corners[corner] = v;
+						vertexFifo[vertexCount++ % VertexFifoSize] = v;
+					}
+				}
+				triangle[0] = corners[0];
+				triangle[1] = corners[1];
+				triangle[2] = corners[2];
+				edges[edgeCount % EdgeFifoSize] = corners[0] | (uint64_t)corners[1] << 32;
+				edges[(edgeCount + 1) % EdgeFifoSize] = corners[1] | (uint64_t)corners[2] << 32;
+				edges[(edgeCount + 2) % EdgeFifoSize] = corners[2] | (uint64_t)corners[0] << 32;
+				edgeCount += 3;
+			}
+			return data == end;
+		}
+
+		// Vertices per block of the vertex coder, every byte plane
+		//	of a block is coded on its own in groups of 16 bytes
+		const size_t VertexBlockSize = 256;
+		const size_t VertexGroupSize = 16;
+		// Largest vertex the coder takes
+		const size_t MaxVertexSize = 256;
+
+		// Bits per byte of a group for each two bit group mode
+		const unsigned int GroupBits[4] = { 0, 2, 4, 8 };
+
+		// Byte deltas from the vertex before, zigzagged so small changes
+		//	either way are small numbers
+		inline uint8_t zigzagByte(uint8_t delta)
+		{
+			return (uint8_t)((delta << 1) ^ (uint8_t)((int8_t)delta >> 7));
+		}
+
+		inline uint8_t unzigzagByte(uint8_t value)
+		{
+			return (uint8_t)((value >> 1) ^ (uint8_t)-(value & 1));
+		}
+
+		// Encode vertexCount vertices of vertexSize bytes each, any layout,
+		//	Vertex and quantize::PackedVertex alike. Decode with the same
+		//	count and size
+		inline std::vector<uint8_t> EncodeVertexBuffer(const void* vertices, size_t vertexCount, size_t vertexSize)
+		{
+			std::vector<uint8_t> out;
+			if (vertexSize == 0 || vertexSize > MaxVertexSize)
+				return out;
+			out.push_back(VertexHeader);
+
+			const uint8_t* bytes = (const uint8_t*)vertices;
+			uint8_t previous[MaxVertexSize] = {};
+			uint8_t plane[VertexBlockSize];
+
+			for (size_t begin = 0; begin < vertexCount; begin += VertexBlockSize)
+			{
+				size_t count = std::min(VertexBlockSize, vertexCount - begin);
+				size_t groups = (count + VertexGroupSize - 1) / VertexGroupSize;
+
+				for (size_t k = 0; k < vertexSize; k++)
+				{
+					uint8_t before = previous[k];
+					for (size_t v = 0; v < count; v++)
+					{
+						uint8_t value = bytes[(begin + v) * vertexSize + k];
+						plane[v] = zigzagByte((uint8_t)(value - before));
+						before = value;
+					}
+					std::fill(plane + count, plane + groups * VertexGroupSize, (uint8_t)0);
+					previous[k] = before;
+
+					// Two bits of mode per group up front, then the groups
+					size_t modes = out.size();
+					out.resize(out.size() + (groups + 3) / 4, 0);
+					for (size_t g = 0; g < groups; g++)
+					{
+						const uint8_t* group = plane + g * VertexGroupSize;
+						uint8_t largest = 0;
+						for (size_t i = 0; i < VertexGroupSize; i++)
+							largest |= group[i];
+						unsigned int mode = largest == 0 ? 0 : largest < 4 ? 1 : largest < 16 ? 2 : 3;
+						out[modes + g / 4] |= (uint8_t)(mode << (g % 4 * 2));
+
+						unsigned int bits = GroupBits[mode];
+						if (bits == 8)
+						{
+							out.insert(out.end(), group, group + VertexGroupSize);
+						}
+						else if (bits != 0)
+						{
+							// Packed first value highest, as many to a byte as fit
+							unsigned int perByte = 8 / bits;
+							for (size_t i = 0; i < VertexGroupSize; i += perByte)
+							{
+								uint8_t packed = 0;
+								for (unsigned int j = 0; j < perByte; j++)
+									packed = (uint8_t)(packed << bits | group[i + j]);
+								out.push_back(packed);
+							}
+						}
+					}
+				}
+			}
+			return out;
+		}
+
+		// Unpack a group of 16 bytes of the given mode, false if it runs off the end
+		inline bool decodeGroup(unsigned int mode, const uint8_t*& data, const uint8_t* end, uint8_t* group)
+		{
+			if (mode == 0)
+			{
+				memset(group, 0, VertexGroupSize);
+				return true;
+			}
+			size_t length = GroupBits[mode] * VertexGroupSize / 8;
+			if ((size_t)(end - data) < length)
+				return false;
+			if (mode == 3)
+			{
+				memcpy(group, data, VertexGroupSize);
+			}
+			else if (mode == 2)
+			{
+				for (size_t i = 0; i < 8; i++)
+				{
+					group[i * 2] = data[i] >> 4;
+					group[i * 2 + 1] = data[i] & 0xF;
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < 4; i++)
+				{
+					uint8_t packed = data[i];
+					group[i * 4] = packed >> 6;
+					group[i * 4 + 1] = packed >> 4 & 3;
+					group[i * 4 + 2] = packed >> 2 & 3;
+					group[i * 4 + 3] = packed & 3;
+				}
+			}
+			data += length;
+			return true;
+		}
+
+		// Decode every byte plane of a block into planes, VertexBlockSize
+		//	bytes apart, as the bytes themselves with the deltas added up
+		inline bool decodePlanesScalar(const uint8_t*& data, const uint8_t* end, size_t groups, size_t vertexSize, uint8_t* previous, uint8_t* planes)
+		{
+			size_t modeBytes = (groups + 3) / 4;
+			for (size_t k = 0; k < vertexSize; k++)
+			{
+				if ((size_t)(end - data) < modeBytes)
+					return false;
+				const uint8_t* modes = data;
+				data += modeBytes;
+				uint8_t* plane = planes + k * VertexBlockSize;
+				uint8_t running = previous[k];
+				for (size_t g = 0; g < groups; g++)
+				{
+					uint8_t* group = plane + g * VertexGroupSize;
+					if (!decodeGroup(modes[g / 4] >> (g % 4 * 2) & 3, data, end, group))
+						return false;
+					for (size_t i = 0; i < VertexGroupSize; i++)
+					{
+						running = (uint8_t)(running + unzigzagByte(group[i]));
+						group[i] = running;
+					}
+				}
+				// Padding decodes to no change, so this is the block's last vertex
+				previous[k] = running;
+			}
+			return true;
+		}
+
+		// Put count vertices of the block back together from its planes
+		inline void interleaveScalar(const uint8_t* planes, size_t count, size_t vertexSize, size_t firstPlane, uint8_t* out)
+		{
+			for (size_t v = 0; v < count; v++)
+			{
+				for (size_t k = firstPlane; k < vertexSize; k++)
+					out[v * vertexSize + k] = planes[k * VertexBlockSize + v];
+			}
+		}
+
+#ifdef OBJL_X86
+		OBJL_TARGET_SSE2 inline bool decodePlanesSSE2(const uint8_t*& data, const uint8_t* end, size_t groups, size_t vertexSize, uint8_t* previous, uint8_t* planes)
+		{
+			const __m128i low2 = _mm_set1_epi8(3);
+			const __m128i low4 = _mm_set1_epi8(0xF);
+			const __m128i one = _mm_set1_epi8(1);
+			const __m128i low7 = _mm_set1_epi8(0x7F);
+			size_t modeBytes = (groups + 3) / 4;
+
+			for (size_t k = 0; k < vertexSize; k++)
+			{
+				if ((size_t)(end - data) < modeBytes)
+					return false;
+				const uint8_t* modes = data;
+				data += modeBytes;
+				uint8_t* plane = planes + k * VertexBlockSize;
+				__m128i running = _mm_set1_epi8((char)previous[k]);
+
+				for (size_t g = 0; g < groups; g++)
+				{
+					unsigned int mode = modes[g / 4] >> (g % 4 * 2) & 3;
+					size_t length = GroupBits[mode] * VertexGroupSize / 8;
+					if ((size_t)(end - data) < length)
+						return false;
+
+					__m128i group;
+					if (mode == 0)
+					{
+						// Nothing changes, the whole group is the last byte
+						_mm_storeu_si128((__m128i*)(plane + g * VertexGroupSize), running);
+						continue;
+					}
+					else if (mode == 3)
+					{
+						group = _mm_loadu_si128((const __m128i*)data);
+					}
+					else if (mode == 2)
+					{
+						__m128i packed = _mm_loadl_epi64((const __m128i*)data);
+						group = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(packed, 4), low4), _mm_and_si128(packed, low4));
+					}
+					else
+					{
+						int32_t word;
+						memcpy(&word, data, 4);
+						__m128i packed = _mm_cvtsi32_si128(word);
+						__m128i high = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(packed, 6), low2), _mm_and_si128(_mm_srli_epi16(packed, 4), low2));
+						__m128i low = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(packed, 2), low2), _mm_and_si128(packed, low2));
+						group = _mm_unpacklo_epi16(high, low);
+					}
+					data += length;
+
+					// Unzigzag, then add up the deltas across the group and onto the byte before it
+					__m128i delta = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(group, 1), low7), _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(group, one)));
+					delta = _mm_add_epi8(delta, _mm_slli_si128(delta, 1));
+					delta = _mm_add_epi8(delta, _mm_slli_si128(delta, 2));
+					delta = _mm_add_epi8(delta, _mm_slli_si128(delta, 4));
+					delta = _mm_add_epi8(delta, _mm_slli_si128(delta, 8));
+					__m128i values = _mm_add_epi8(delta, running);
+					_mm_storeu_si128((__m128i*)(plane + g * VertexGroupSize), values);
+
+					// Every byte of running becomes the group's last byte
+					__m128i last = _mm_unpackhi_epi8(values, values);
+					last = _mm_shufflehi_epi16(last, _MM_SHUFFLE(3, 3, 3, 3));
+					running = _mm_unpackhi_epi64(last, last);
+				}
+				previous[k] = (uint8_t)(_mm_cvtsi128_si32(running) & 0xFF);
+			}
+			return true;
+		}
+
+		// Eight planes at a time then four, transposed 16 vertices at a time into runs of that many bytes
+		OBJL_TARGET_SSE2 inline void interleaveSSE2(const uint8_t* planes, size_t count, size_t vertexSize, uint8_t* out)
+		{
+			size_t fullGroups = count / VertexGroupSize;
+			size_t k = 0;
+			for (; k + 8 <= vertexSize; k += 8)
+			{
+				const uint8_t* plane = planes + k * VertexBlockSize;
+				for (size_t g = 0; g < fullGroups; g++)
+				{
+					size_t v = g * VertexGroupSize;
+					__m128i bytes[8], words[8], dwords[8];
+					for (int i = 0; i < 8; i++)
+						bytes[i] = _mm_loadu_si128((const __m128i*)(plane + VertexBlockSize * i + v));
+					for (int i = 0; i < 4; i++)
+					{
+						words[i * 2] = _mm_unpacklo_epi8(bytes[i * 2], bytes[i * 2 + 1]);
+						words[i * 2 + 1] = _mm_unpackhi_epi8(bytes[i * 2], bytes[i * 2 + 1]);
+					}
+					// Planes 0-3 and 4-7 of vertices 0-3, 4-7, 8-11 and 12-15
+					for (int i = 0; i < 2; i++)
+					{
+						dwords[i * 4] = _mm_unpacklo_epi16(words[i], words[i + 2]);
+						dwords[i * 4 + 1] = _mm_unpackhi_epi16(words[i], words[i + 2]);
+						dwords[i * 4 + 2] = _mm_unpacklo_epi16(words[i + 4], words[i + 6]);
+						dwords[i * 4 + 3] = _mm_unpackhi_epi16(words[i + 4], words[i + 6]);
+					}
+
+					uint8_t* write = out + v * vertexSize + k;
+					for (int quarter = 0; quarter < 4; quarter++)
+					{
+						// Vertices quarter * 4 to quarter * 4 + 3, all eight planes of each
+						__m128i lowPlanes = dwords[quarter / 2 * 4 + quarter % 2];
+						__m128i highPlanes = dwords[quarter / 2 * 4 + quarter % 2 + 2];
+						__m128i first = _mm_unpacklo_epi32(lowPlanes, highPlanes);
+						__m128i second = _mm_unpackhi_epi32(lowPlanes, highPlanes);
+						_mm_storel_epi64((__m128i*)write, first);
+						_mm_storeh_pd((double*)(write + vertexSize), _mm_castsi128_pd(first));
+						_mm_storel_epi64((__m128i*)(write + vertexSize * 2), second);
+						_mm_storeh_pd((double*)(write + vertexSize * 3), _mm_castsi128_pd(second));
+						write += vertexSize * 4;
+					}
+				}
+			}
+			for (; k + 4 <= vertexSize; k += 4)
+			{
+				const uint8_t* plane = planes + k * VertexBlockSize;
+				for (size_t g = 0; g < fullGroups; g++)
+				{
+					size_t v = g * VertexGroupSize;
+					__m128i p0 = _mm_loadu_si128((const __m128i*)(plane + v));
+					__m128i p1 = _mm_loadu_si128((const __m128i*)(plane + VertexBlockSize + v));
+					__m128i p2 = _mm_loadu_si128((const __m128i*)(plane + VertexBlockSize * 2 + v));
+					__m128i p3 = _mm_loadu_si128((const __m128i*)(plane + VertexBlockSize * 3 + v));
+					__m128i p01Low = _mm_unpacklo_epi8(p0, p1), p01High = _mm_unpackhi_epi8(p0, p1);
+					__m128i p23Low = _mm_unpacklo_epi8(p2, p3), p23High = _mm_unpackhi_epi8(p2, p3);
+					__m128i runs[4] = { _mm_unpacklo_epi16(p01Low, p23Low), _mm_unpackhi_epi16(p01Low, p23Low),
+						_mm_unpacklo_epi16(p01High, p23High), _mm_unpackhi_epi16(p01High, p23High) };
+
+					uint8_t* write = out + v * vertexSize + k;
+					for (int r = 0; r < 4; r++)
+					{
+						__m128i run = runs[r];
+						for (int lane = 0; lane < 4; lane++)
+						{
+							int32_t word = _mm_cvtsi128_si32(run);
+							memcpy(write, &word, 4);
+							write += vertexSize;
+							run = _mm_srli_si128(run, 4);
+						}
+					}
+				}
+			}
+			// The vertices past the last full group, and any planes past the last four
+			interleaveScalar(planes, count, vertexSize, k, out);
+			for (size_t v = fullGroups * VertexGroupSize; v < count; v++)
+			{
+				for (size_t plane = 0; plane < k; plane++)
+					out[v * vertexSize + plane] = planes[plane * VertexBlockSize + v];
+			}
+		}
+#endif
+
+		// Decode vertexCount vertices encoded by EncodeVertexBuffer, any
+		//	level decodes any buffer
+		inline bool DecodeVertexBuffer(void* vertices, size_t vertexCount, size_t vertexSize, const uint8_t* buffer, size_t size,
+			scan::Level level = scan::GetLevel())
+		{
+			if (vertexSize == 0 || vertexSize > MaxVertexSize || size < 1 || buffer[0] != VertexHeader)
+				return false;
+			const uint8_t* data = buffer + 1;
+			const uint8_t* end = buffer + size;
+
+			uint8_t* bytes = (uint8_t*)vertices;
+			uint8_t previous[MaxVertexSize] = {};
+			// Every plane of a block is unpacked before the block is put back together
+			//	a vertex at a time, so the output is written in order
+			std::vector<uint8_t> planes(vertexSize * VertexBlockSize);
+
+			for (size_t begin = 0; begin < vertexCount; begin += VertexBlockSize)
+			{
+				size_t count = std::min(VertexBlockSize, vertexCount - begin);
+				size_t groups = (count + VertexGroupSize - 1) / VertexGroupSize;
+				uint8_t* out = bytes + begin * vertexSize;
+#ifdef OBJL_X86
+				if (level != scan::Level::Scalar)
+				{
+					if (!decodePlanesSSE2(data, end, groups, vertexSize, previous, planes.data()))
+						return false;
+					interleaveSSE2(planes.data(), count, vertexSize, out);
+					continue;
+				}
+#endif
+				if (!decodePlanesScalar(data, end, groups, vertexSize, previous, planes.data()))
+					return false;
+				interleaveScalar(planes.data(), count, vertexSize, 0, out);
+			}
+			return data == end;
+		}
+
+		// Structure: CompressedMesh
+		//
+		// Description: A mesh with its vertices and indices encoded
+		struct CompressedMesh
+		{
+			// Mesh Name
+			std::string MeshName;
+			size_t VertexCount = 0;
+			size_t IndexCount = 0;
+			// Encoded Vertex List
+			std::vector<uint8_t> VertexData;
+			// Encoded Index List
+			std::vector<uint8_t> IndexData;
+			// Material, an index into Loader::LoadedMaterials or -1 for none
+			int MaterialIndex = -1;
+		};
+
+		// Encode a mesh loaded by objl::Loader
+		inline CompressedMesh CompressMesh(const Mesh& mesh)
+		{
+			CompressedMesh compressed;
+			compressed.MeshName = mesh.MeshName;
+			compressed.VertexCount = mesh.Vertices.size();
+			compressed.IndexCount = mesh.Indices.size();
+			compressed.VertexData = EncodeVertexBuffer(mesh.Vertices.data(), mesh.Vertices.size(), sizeof(Vertex));
+			compressed.IndexData = EncodeIndexBuffer(mesh.Indices.data(), mesh.Indices.size());
+			compressed.MaterialIndex = mesh.MaterialIndex;
+			return compressed;
+		}
+
+		// Decode a mesh encoded by CompressMesh, false if its data is damaged
+		inline bool DecompressMesh(const CompressedMesh& compressed, Mesh& mesh)
+		{
+			mesh.MeshName = compressed.MeshName;
+			mesh.MaterialIndex = compressed.MaterialIndex;
+			mesh.Vertices.resize(compressed.VertexCount);
+			mesh.Indices.resize(compressed.IndexCount);
+			return DecodeVertexBuffer(mesh.Vertices.data(), mesh.Vertices.size(), sizeof(Vertex), compressed.VertexData.data(), compressed.VertexData.size())
+				&& DecodeIndexBuffer(mesh.Indices.data(), mesh.Indices.size(), compressed.IndexData.data(), compressed.IndexData.size());
+		}
+	}
+}
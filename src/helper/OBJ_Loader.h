@@ -17,6 +17,80 @@
 // Math.h - STD math Library
 #include <math.h>
 
+// String View - STD Non Owning String Library
+#include <string_view>
+
+// Charconv - STD Locale Free Number Parsing
+#include <charconv>
+
+// Cstring - STD memchr
+#include <cstring>
+
+// Cstdint & Algorithm - STD Integer Limits and Copies
+#include <cstdint>
+#include <algorithm>
+
+// Thread & Atomic - STD Threading for the parallel loader
+#include <atomic>
+#include <thread>
+
+// Bit - STD Bit Counting for the structural index
+#include <bit>
+
+// Functional - STD Function for the streaming callback
+#include <functional>
+
+// Memory & Filesystem - STD Shared Ownership and File Replacement for the mesh cache
+#include <memory>
+#include <filesystem>
+
+// Mutex, Deque & Unordered Map - STD Locking and Tables for the process wide material libraries
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+
+// SIMD - SSE2 and AVX2 intrinsics for the structural index on x86,
+//	the AVX2 path is only taken when the CPU has it
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define OBJL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define OBJL_TARGET_SSE2
+#define OBJL_TARGET_AVX2
+#else
+#define OBJL_TARGET_SSE2 __attribute__((target("sse2")))
+#define OBJL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Memory mapping - Platform File Mapping APIs
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Profiler.h - Engine profiling zones when built inside the engine, compiled out
+//	unless enabled. On its own (or after a profiler of your own that defines
+//	PROFILE_ZONE) the loader needs nothing more than this header
+#ifndef PROFILE_ZONE
+#if defined(__has_include)
+#if __has_include("core/Profiler.h")
+#include "core/Profiler.h"
+#endif
+#endif
+#endif
+#ifndef PROFILE_ZONE
+#define PROFILE_ZONE(name)
+#endif
+
 // Print progress to console while loading (large models)
 #define OBJL_CONSOLE_OUTPUT
 
@@ -211,8 +285,96 @@ namespace objl
 		// Index List
 		std::vector<unsigned int> Indices;
 
-		// Material
+		// Material, a copy of LoadedMaterials[MaterialIndex] only
+		//	filled in with Loader::CopyMaterials
 		Material MeshMaterial;
+		// Material, an index into Loader::LoadedMaterials or -1 for none
+		int MaterialIndex = -1;
+	};
+
+	// Structure: MeshView
+	//
+	// Description: A mesh whose vertices and indices live
+	//	somewhere else, like a memory mapped .objb cache
+	struct MeshView
+	{
+		// Mesh Name
+		std::string_view MeshName;
+		// Vertex List
+		const Vertex* Vertices = nullptr;
+		size_t VertexCount = 0;
+		// Index List
+		const unsigned int* Indices = nullptr;
+		size_t IndexCount = 0;
+		// Material, an index into Loader::LoadedMaterials or -1 for none
+		int MaterialIndex = -1;
+	};
+
+	// Structure: MeshRange
+	//
+	// Description: A mesh as a run of Loader::LoadedVertices and
+	//	Loader::LoadedIndices, what loads with Loader::PoolMeshes
+	//	give instead of copying every mesh out on its own.
+	//	The indices are into all of LoadedVertices, take
+	//	VertexOffset off them for indices into the mesh
+	struct MeshRange
+	{
+		// Mesh Name
+		std::string MeshName;
+		// Vertex Run
+		size_t VertexOffset = 0;
+		size_t VertexCount = 0;
+		// Index Run
+		size_t IndexOffset = 0;
+		size_t IndexCount = 0;
+		// Material, an index into Loader::LoadedMaterials or -1 for none
+		int MaterialIndex = -1;
+	};
+
+	// Structure: CompactMesh
+	//
+	// Description: A mesh whose indices are 16 bit whenever its
+	//	vertices allow it, what loads with Loader::CompactIndices
+	//	give. Meshes too big for 16 bit indices are split into parts
+	//	that fit, each with the whole mesh's name and material index
+	struct CompactMesh
+	{
+		// Most vertices 16 bit indices can reach
+		static const size_t Max16BitVertices = 65536;
+
+		// Mesh Name
+		std::string MeshName;
+		// Vertex List
+		std::vector<Vertex> Vertices;
+		// 16 bit Index List, used whenever Vertices fit
+		std::vector<uint16_t> Indices16;
+		// 32 bit Index List, only for meshes too big that weren't split
+		std::vector<unsigned int> Indices32;
+
+		// Material, an index into Loader::LoadedMaterials or -1 for none
+		int MaterialIndex = -1;
+		// Which mesh of the load this was, an index into whichever of
+		//	LoadedMeshes, LoadedMeshRanges or CachedMeshes it filled.
+		//	The parts of a split mesh share it
+		size_t SourceMesh = 0;
+
+		bool Uses16BitIndices() const
+		{
+			return Indices32.empty();
+		}
+		size_t IndexCount() const
+		{
+			return Uses16BitIndices() ? Indices16.size() : Indices32.size();
+		}
+		unsigned int Index(size_t i) const
+		{
+			return Uses16BitIndices() ? Indices16[i] : Indices32[i];
+		}
+		// What the index buffer takes up
+		size_t IndexBytes() const
+		{
+			return Indices16.size() * sizeof(uint16_t) + Indices32.size() * sizeof(unsigned int);
+		}
 	};
 
 	// Namespace: Math
@@ -222,7 +384,7 @@ namespace objl
 	namespace math
 	{
 		// Vector3 Cross Product
-		Vector3 CrossV3(const Vector3 a, const Vector3 b)
+		inline Vector3 CrossV3(const Vector3 a, const Vector3 b)
 		{
 			return Vector3(a.Y * b.Z - a.Z * b.Y,
 				a.Z * b.X - a.X * b.Z,
@@ -230,19 +392,19 @@ namespace objl
 		}
 
 		// Vector3 Magnitude Calculation
-		float MagnitudeV3(const Vector3 in)
+		inline float MagnitudeV3(const Vector3 in)
 		{
 			return (sqrtf(powf(in.X, 2) + powf(in.Y, 2) + powf(in.Z, 2)));
 		}
 
 		// Vector3 DotProduct
-		float DotV3(const Vector3 a, const Vector3 b)
+		inline float DotV3(const Vector3 a, const Vector3 b)
 		{
 			return (a.X * b.X) + (a.Y * b.Y) + (a.Z * b.Z);
 		}
 
 		// Angle between 2 Vector3 Objects
-		float AngleBetweenV3(const Vector3 a, const Vector3 b)
+		inline float AngleBetweenV3(const Vector3 a, const Vector3 b)
 		{
 			float angle = DotV3(a, b);
 			angle /= (MagnitudeV3(a) * MagnitudeV3(b));
@@ -250,7 +412,7 @@ namespace objl
 		}
 
 		// Projection Calculation of a onto b
-		Vector3 ProjV3(const Vector3 a, const Vector3 b)
+		inline Vector3 ProjV3(const Vector3 a, const Vector3 b)
 		{
 			Vector3 bn = b / MagnitudeV3(b);
 			return bn * DotV3(a, bn);
@@ -264,13 +426,13 @@ namespace objl
 	namespace algorithm
 	{
 		// Vector3 Multiplication Opertor Overload
-		Vector3 operator*(const float& left, const Vector3& right)
+		inline Vector3 operator*(const float& left, const Vector3& right)
 		{
 			return Vector3(right.X * left, right.Y * left, right.Z * left);
 		}
 
 		// A test to see if P1 is on the same side as P2 of a line segment ab
-		bool SameSide(Vector3 p1, Vector3 p2, Vector3 a, Vector3 b)
+		inline bool SameSide(Vector3 p1, Vector3 p2, Vector3 a, Vector3 b)
 		{
 			Vector3 cp1 = math::CrossV3(b - a, p1 - a);
 			Vector3 cp2 = math::CrossV3(b - a, p2 - a);
@@ -282,7 +444,7 @@ namespace objl
 		}
 
 		// Generate a cross produect normal for a triangle
-		Vector3 GenTriNormal(Vector3 t1, Vector3 t2, Vector3 t3)
+		inline Vector3 GenTriNormal(Vector3 t1, Vector3 t2, Vector3 t3)
 		{
 			Vector3 u = t2 - t1;
 			Vector3 v = t3 - t1;
@@ -293,7 +455,7 @@ namespace objl
 		}
 
 		// Check to see if a Vector3 Point is within a 3 Vector3 Triangle
-		bool inTriangle(Vector3 point, Vector3 tri1, Vector3 tri2, Vector3 tri3)
+		inline bool inTriangle(Vector3 point, Vector3 tri1, Vector3 tri2, Vector3 tri3)
 		{
 			// Test to see if it is within an infinite prism that the triangle outlines.
 			bool within_tri_prisim = SameSide(point, tri1, tri2, tri3) && SameSide(point, tri2, tri1, tri3)
@@ -404,324 +566,3245 @@ namespace objl
 				idx--;
 			return elements[idx];
 		}
+
+		// Space or tab, the only separators firstToken and tail know
+		inline bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t';
+		}
+
+		// Skip what std::stof and std::stoi skip in front of a number
+		inline const char* skipNumberPrefix(const char* first, const char* last)
+		{
+			while (first != last && (*first == ' ' || (*first >= '\t' && *first <= '\r')))
+				first++;
+			if (first != last && *first == '+')
+				first++;
+			return first;
+		}
+
+		// Parse a float like std::stof without the string,
+		//	returns false where std::stof would throw
+		inline bool parseFloat(std::string_view in, float &out)
+		{
+			const char* last = in.data() + in.size();
+			return std::from_chars(skipNumberPrefix(in.data(), last), last, out).ec == std::errc();
+		}
+
+		// Parse an int like std::stoi without the string
+		inline bool parseInt(std::string_view in, int &out)
+		{
+			const char* last = in.data() + in.size();
+			return std::from_chars(skipNumberPrefix(in.data(), last), last, out).ec == std::errc();
+		}
+
+		// Get element at an index position that is still in the file,
+		//	nullptr if it is not a valid index
+		template <class T>
+		inline const T * getElementView(const std::vector<T> &elements, std::string_view index)
+		{
+			int idx;
+			if (!parseInt(index, idx))
+				return nullptr;
+			if (idx < 0)
+				idx = int(elements.size()) + idx;
+			else
+				idx--;
+			if (idx < 0 || idx >= int(elements.size()))
+				return nullptr;
+			return &elements[idx];
+		}
+
+		// Turn a mesh into compact meshes at the end of out, copying its
+		//	vertices. indexBase comes off every index, for the view of a
+		//	MeshRange whose indices are into all of LoadedVertices. A mesh
+		//	of at most CompactMesh::Max16BitVertices just narrows its
+		//	indices. A bigger one is cut into runs of its triangles in
+		//	order, each holding only the vertices it uses, or keeps 32 bit
+		//	indices if split is false
+		inline void ToCompactMeshes(const MeshView& mesh, size_t sourceMesh, bool split, std::vector<CompactMesh>& out,
+			unsigned int indexBase = 0)
+		{
+			auto part = [&]() -> CompactMesh&
+			{
+				CompactMesh& compact = out.emplace_back();
+				compact.MeshName = mesh.MeshName;
+				compact.MaterialIndex = mesh.MaterialIndex;
+				compact.SourceMesh = sourceMesh;
+				return compact;
+			};
+
+			if (mesh.VertexCount <= CompactMesh::Max16BitVertices || !split)
+			{
+				CompactMesh& compact = part();
+				compact.Vertices.assign(mesh.Vertices, mesh.Vertices + mesh.VertexCount);
+				if (mesh.VertexCount <= CompactMesh::Max16BitVertices)
+				{
+					compact.Indices16.resize(mesh.IndexCount);
+					for (size_t i = 0; i < mesh.IndexCount; i++)
+						compact.Indices16[i] = (uint16_t)(mesh.Indices[i] - indexBase);
+				}
+				else
+				{
+					compact.Indices32.resize(mesh.IndexCount);
+					for (size_t i = 0; i < mesh.IndexCount; i++)
+						compact.Indices32[i] = mesh.Indices[i] - indexBase;
+				}
+				return;
+			}
+
+			// Where each of the mesh's vertices is in the part being built, if it is
+			std::vector<uint32_t> remap(mesh.VertexCount, UINT32_MAX);
+			std::vector<unsigned int> used;
+			CompactMesh* current = &part();
+			size_t triangleCount = mesh.IndexCount / 3;
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				unsigned int triangle[3];
+				for (int corner = 0; corner < 3; corner++)
+					triangle[corner] = mesh.Indices[t * 3 + corner] - indexBase;
+				size_t added = 0;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					bool repeated = (corner > 0 && triangle[corner] == triangle[0]) || (corner > 1 && triangle[corner] == triangle[1]);
+					added += remap[triangle[corner]] == UINT32_MAX && !repeated;
+				}
+				if (current->Vertices.size() + added > CompactMesh::Max16BitVertices)
+				{
+					for (unsigned int vertex : used)
+						remap[vertex] = UINT32_MAX;
+					used.clear();
+					current = &part();
+				}
+
+				for (int corner = 0; corner < 3; corner++)
+				{
+					uint32_t& local = remap[triangle[corner]];
+					if (local == UINT32_MAX)
+					{
+						local = (uint32_t)current->Vertices.size();
+						current->Vertices.push_back(mesh.Vertices[triangle[corner]]);
+						used.push_back(triangle[corner]);
+					}
+					current->Indices16.push_back((uint16_t)local);
+				}
+			}
+		}
+
+		inline void ToCompactMeshes(const Mesh& mesh, size_t sourceMesh, bool split, std::vector<CompactMesh>& out)
+		{
+			MeshView view;
+			view.MeshName = mesh.MeshName;
+			view.Vertices = mesh.Vertices.data();
+			view.VertexCount = mesh.Vertices.size();
+			view.Indices = mesh.Indices.data();
+			view.IndexCount = mesh.Indices.size();
+			view.MaterialIndex = mesh.MaterialIndex;
+			ToCompactMeshes(view, sourceMesh, split, out);
+		}
 	}
 
-	// Class: Loader
+	// Namespace: Scan
 	//
-	// Description: The OBJ Model Loader
-	class Loader
+	// Description: Stage one of the in place loaders, finds
+	//	every token, slash and line end 64 bytes at a time
+	//	so the record parser never walks the text byte by byte
+	namespace scan
 	{
-	public:
-		// Default Constructor
-		Loader()
+		// Instruction set the structural index is built with
+		enum class Level
 		{
+			Scalar,
+			SSE2,
+			AVX2
+		};
 
+		// Best level the CPU and OS support
+		inline Level DetectLevel()
+		{
+#ifdef OBJL_X86
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			int maxLeaf = info[0];
+			__cpuid(info, 1);
+			bool sse2 = (info[3] & (1 << 26)) != 0;
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+			{
+				__cpuidex(info, 7, 0);
+				if (info[1] & (1 << 5))
+					return Level::AVX2;
+			}
+			if (sse2)
+				return Level::SSE2;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return Level::AVX2;
+			if (__builtin_cpu_supports("sse2"))
+				return Level::SSE2;
+#endif
+#endif
+			return Level::Scalar;
 		}
-		~Loader()
+
+		inline Level activeLevel = DetectLevel();
+
+		// Use a lower level than detected, e.g. to compare them,
+		//	levels the CPU doesn't have fall back to the best it does
+		inline void SetLevel(Level level)
 		{
-			LoadedMeshes.clear();
+			Level detected = DetectLevel();
+			activeLevel = level > detected ? detected : level;
+		}
+		inline Level GetLevel()
+		{
+			return activeLevel;
 		}
 
-		// Load a file into the loader
-		//
-		// If file is loaded return true
-		//
-		// If the file is unable to be found
-		// or unable to be loaded return false
-		bool LoadFile(std::string Path)
+		// Separators, line ends and slashes of a 64 byte block, one bit per byte
+		struct BlockMasks
 		{
-			// If the file is not an .obj file return false
-			if (Path.substr(Path.size() - 4, 4) != ".obj")
-				return false;
+			uint64_t separator;
+			uint64_t newline;
+			uint64_t slash;
+		};
 
+		inline BlockMasks classifyScalar(const char* block)
+		{
+			BlockMasks masks = { 0, 0, 0 };
+			for (int i = 0; i < 64; i++)
+			{
+				uint64_t bit = 1ull << i;
+				char c = block[i];
+				masks.newline |= c == '\n' ? bit : 0;
+				masks.separator |= (c == ' ' || c == '\t' || c == '\n') ? bit : 0;
+				masks.slash |= c == '/' ? bit : 0;
+			}
+			return masks;
+		}
 
-			std::ifstream file(Path);
+#ifdef OBJL_X86
+		OBJL_TARGET_SSE2 inline BlockMasks classifySSE2(const char* block)
+		{
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i tab = _mm_set1_epi8('\t');
+			const __m128i newline = _mm_set1_epi8('\n');
+			const __m128i slash = _mm_set1_epi8('/');
 
-			if (!file.is_open())
-				return false;
+			BlockMasks masks = { 0, 0, 0 };
+			for (int i = 0; i < 4; i++)
+			{
+				__m128i bytes = _mm_loadu_si128((const __m128i*)(block + i * 16));
+				__m128i isNewline = _mm_cmpeq_epi8(bytes, newline);
+				__m128i isSeparator = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)), isNewline);
+				masks.newline |= (uint64_t)(uint16_t)_mm_movemask_epi8(isNewline) << (i * 16);
+				masks.separator |= (uint64_t)(uint16_t)_mm_movemask_epi8(isSeparator) << (i * 16);
+				masks.slash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, slash)) << (i * 16);
+			}
+			return masks;
+		}
 
-			LoadedMeshes.clear();
-			LoadedVertices.clear();
-			LoadedIndices.clear();
+		OBJL_TARGET_AVX2 inline BlockMasks classifyAVX2(const char* block)
+		{
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i tab = _mm256_set1_epi8('\t');
+			const __m256i newline = _mm256_set1_epi8('\n');
+			const __m256i slash = _mm256_set1_epi8('/');
 
-			std::vector<Vector3> Positions;
-			std::vector<Vector2> TCoords;
-			std::vector<Vector3> Normals;
+			BlockMasks masks = { 0, 0, 0 };
+			for (int i = 0; i < 2; i++)
+			{
+				__m256i bytes = _mm256_loadu_si256((const __m256i*)(block + i * 32));
+				__m256i isNewline = _mm256_cmpeq_epi8(bytes, newline);
+				__m256i isSeparator = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, space), _mm256_cmpeq_epi8(bytes, tab)), isNewline);
+				masks.newline |= (uint64_t)(uint32_t)_mm256_movemask_epi8(isNewline) << (i * 32);
+				masks.separator |= (uint64_t)(uint32_t)_mm256_movemask_epi8(isSeparator) << (i * 32);
+				masks.slash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, slash)) << (i * 32);
+			}
+			return masks;
+		}
+#endif
+
+		// Write the offset of every structural byte of text that starts
+		//	a line to index: the first byte of each token, the separator
+		//	ending it, every slash and every line end. index needs room
+		//	for size offsets, returns how many were written
+		template <BlockMasks (*Classify)(const char*)>
+		inline size_t buildIndex(const char* data, size_t size, uint32_t* index)
+		{
+			uint32_t* out = index;
+			// Text starts as if it came after a separator
+			uint64_t previousSeparator = 1;
+			char padded[64];
 
-			std::vector<Vertex> Vertices;
-			std::vector<unsigned int> Indices;
+			for (size_t offset = 0; offset < size; offset += 64)
+			{
+				const char* block = data + offset;
+				uint64_t valid = ~0ull;
+				if (size - offset < 64)
+				{
+					memset(padded, ' ', sizeof(padded));
+					memcpy(padded, block, size - offset);
+					block = padded;
+					valid = (1ull << (size - offset)) - 1;
+				}
 
-			std::vector<std::string> MeshMatNames;
+				BlockMasks masks = Classify(block);
+				uint64_t afterSeparator = (masks.separator << 1) | previousSeparator;
+				previousSeparator = masks.separator >> 63;
+				uint64_t structural = ((masks.separator ^ afterSeparator) | masks.newline | masks.slash) & valid;
 
-			bool listening = false;
-			std::string meshname;
+				while (structural)
+				{
+					*out++ = (uint32_t)(offset + std::countr_zero(structural));
+					structural &= structural - 1;
+				}
+			}
+			return out - index;
+		}
 
-			Mesh tempMesh;
+		// buildIndex with the given level
+		inline size_t BuildIndex(Level level, const char* data, size_t size, uint32_t* index)
+		{
+#ifdef OBJL_X86
+			if (level == Level::AVX2)
+				return buildIndex<classifyAVX2>(data, size, index);
+			if (level == Level::SSE2)
+				return buildIndex<classifySSE2>(data, size, index);
+#endif
+			return buildIndex<classifyScalar>(data, size, index);
+		}
 
-			#ifdef OBJL_CONSOLE_OUTPUT
-			const unsigned int outputEveryNth = 1000;
-			unsigned int outputIndicator = outputEveryNth;
-			#endif
+		// A token and where its first three slashes are
+		struct Token
+		{
+			const char* begin;
+			const char* end;
+			const char* slashes[3];
+			int slashCount;
 
-			std::string curline;
-			while (std::getline(file, curline))
+			std::string_view View() const
 			{
-				#ifdef OBJL_CONSOLE_OUTPUT
-				if ((outputIndicator = ((outputIndicator + 1) % outputEveryNth)) == 1)
+				return std::string_view(begin, end - begin);
+			}
+		};
+
+		// A line split into the same tokens firstToken and tail see
+		struct Line
+		{
+			const char* begin;
+			const char* end;
+			std::vector<Token> tokens;
+
+			// algorithm::firstToken
+			std::string_view Key() const
+			{
+				return tokens.empty() ? std::string_view() : tokens[0].View();
+			}
+			// algorithm::tail
+			std::string_view Tail() const
+			{
+				if (tokens.size() < 2)
+					return std::string_view();
+				return std::string_view(tokens[1].begin, tokens.back().end - tokens[1].begin);
+			}
+			size_t Size() const
+			{
+				return end - begin;
+			}
+		};
+
+		// Split a face corner into its v, vt and vn parts the same way
+		//	split(corner, "/") does, returns how many parts there are
+		inline int splitCorner(const Token& corner, std::string_view (&svert)[3])
+		{
+			const char* partBegin = corner.begin;
+			int parts = 0;
+			while (parts < 3)
+			{
+				const char* partEnd = parts < corner.slashCount ? corner.slashes[parts] : corner.end;
+				svert[parts++] = std::string_view(partBegin, partEnd - partBegin);
+				if (partEnd == corner.end)
+					break;
+				partBegin = partEnd + 1;
+				if (partBegin == corner.end)
+					break;
+			}
+			return parts;
+		}
+
+		// Parse the floats after the key of a line, up to count of
+		//	them, missing ones are left alone
+		inline void parseFloats(const Line& line, float* out, int count)
+		{
+			for (int i = 0; i < count && i + 1 < int(line.tokens.size()); i++)
+			{
+				algorithm::parseFloat(line.tokens[i + 1].View(), out[i]);
+			}
+		}
+
+		// Bytes indexed at a time, small enough for the index to stay in cache
+		const size_t WindowSize = 64 * 1024;
+
+		// Call function(line) for every line of [begin, end), split at
+		//	line ends the way std::getline does
+		template <class Function>
+		inline void ForEachLine(const char* begin, const char* end, Function&& function)
+		{
+			Level level = activeLevel;
+			std::vector<uint32_t> index;
+			Line line;
+			line.begin = begin;
+			bool inToken = false;
+
+			const char* windowBegin = begin;
+			while (windowBegin < end)
+			{
+				// Windows end on a line end so every one starts a line
+				const char* windowEnd = end;
+				if ((size_t)(end - windowBegin) > WindowSize)
 				{
-					if (!meshname.empty())
+					windowEnd = windowBegin + WindowSize;
+					while (windowEnd > windowBegin && windowEnd[-1] != '\n')
+						windowEnd--;
+					if (windowEnd == windowBegin)
 					{
-						std::cout
-							<< "\r- " << meshname
-							<< "\t| vertices > " << Positions.size()
-							<< "\t| texcoords > " << TCoords.size()
-							<< "\t| normals > " << Normals.size()
-							<< "\t| triangles > " << (Vertices.size() / 3)
-							<< (!MeshMatNames.empty() ? "\t| material: " + MeshMatNames.back() : "");
+						const char* newline = (const char*)memchr(windowBegin + WindowSize, '\n', end - windowBegin - WindowSize);
+						windowEnd = newline ? newline + 1 : end;
 					}
 				}
-				#endif
 
-				// Generate a Mesh Object or Prepare for an object to be created
-				if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g" || curline[0] == 'g')
+				// A byte is structural at most once
+				size_t size = windowEnd - windowBegin;
+				if (index.size() < size)
+					index.resize(size);
+				size_t count = BuildIndex(level, windowBegin, size, index.data());
+
+				for (size_t i = 0; i < count; i++)
 				{
-					if (!listening)
+					const char* at = windowBegin + index[i];
+					char c = *at;
+					if (algorithm::isSpace(c) || c == '\n')
 					{
-						listening = true;
-
-						if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g")
+						if (inToken)
 						{
-							meshname = algorithm::tail(curline);
+							line.tokens.back().end = at;
+							inToken = false;
 						}
-						else
+						if (c == '\n')
 						{
-							meshname = "unnamed";
+							line.end = at;
+							function(line);
+							line.tokens.clear();
+							line.begin = at + 1;
 						}
 					}
 					else
 					{
-						// Generate the mesh to put into the array
-
-						if (!Indices.empty() && !Vertices.empty())
+						if (!inToken)
 						{
-							// Create Mesh
-							tempMesh = Mesh(Vertices, Indices);
-							tempMesh.MeshName = meshname;
-
-							// Insert Mesh
-							LoadedMeshes.push_back(tempMesh);
-
-							// Cleanup
-							Vertices.clear();
-							Indices.clear();
-							meshname.clear();
-
-							meshname = algorithm::tail(curline);
+							line.tokens.push_back({ at, at, { nullptr, nullptr, nullptr }, 0 });
+							inToken = true;
 						}
-						else
+						if (c == '/')
 						{
-							if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g")
-							{
-								meshname = algorithm::tail(curline);
-							}
-							else
-							{
-								meshname = "unnamed";
-							}
+							Token& token = line.tokens.back();
+							if (token.slashCount < 3)
+								token.slashes[token.slashCount++] = at;
 						}
 					}
-					#ifdef OBJL_CONSOLE_OUTPUT
-					std::cout << std::endl;
-					outputIndicator = 0;
-					#endif
 				}
-				// Generate a Vertex Position
-				if (algorithm::firstToken(curline) == "v")
-				{
-					std::vector<std::string> spos;
-					Vector3 vpos;
-					algorithm::split(algorithm::tail(curline), spos, " ");
 
-					vpos.X = std::stof(spos[0]);
-					vpos.Y = std::stof(spos[1]);
-					vpos.Z = std::stof(spos[2]);
+				windowBegin = windowEnd;
+			}
 
-					Positions.push_back(vpos);
-				}
-				// Generate a Vertex Texture Coordinate
-				if (algorithm::firstToken(curline) == "vt")
-				{
-					std::vector<std::string> stex;
-					Vector2 vtex;
-					algorithm::split(algorithm::tail(curline), stex, " ");
+			// Last line without a line end
+			if (inToken)
+				line.tokens.back().end = end;
+			if (line.begin < end)
+			{
+				line.end = end;
+				function(line);
+			}
+		}
+	}
 
-					vtex.X = std::stof(stex[0]);
-					vtex.Y = std::stof(stex[1]);
+	// Namespace: Triangulate
+	//
+	// Description: Turns a face with any number of corners
+	//	into triangles, a fan for convex faces and ear clipping
+	//	in the face's dominant plane for everything else
+	namespace triangulate
+	{
+		// Structure: Scratch
+		//
+		// Description: Working memory of the ear clipper, kept
+		//	between faces so they don't allocate once it has grown
+		struct Scratch
+		{
+			// Corners projected to the dominant plane, counter clockwise
+			std::vector<Vector2> points;
+			// The corners that are left, as a ring
+			std::vector<unsigned int> prev;
+			std::vector<unsigned int> next;
+			// Corners that were reflex at some point, the only ones that can be inside an ear
+			std::vector<unsigned int> reflexCorners;
+			// Whether a corner is reflex now, clipped corners aren't
+			std::vector<char> reflex;
+		};
+
+		// Newell's normal of a polygon, it doesn't need the
+		//	polygon to be planar or any three corners to be a good triangle
+		inline Vector3 polygonNormal(const Vertex* verts, size_t count)
+		{
+			Vector3 normal;
+			for (size_t i = 0, j = count - 1; i < count; j = i++)
+			{
+				const Vector3& a = verts[j].Position;
+				const Vector3& b = verts[i].Position;
+				normal.X += (a.Y - b.Y) * (a.Z + b.Z);
+				normal.Y += (a.Z - b.Z) * (a.X + b.X);
+				normal.Z += (a.X - b.X) * (a.Y + b.Y);
+			}
+			return normal;
+		}
 
-					TCoords.push_back(vtex);
-				}
-				// Generate a Vertex Normal;
-				if (algorithm::firstToken(curline) == "vn")
+		// Twice the signed area of abc, positive when it turns left
+		inline float area2(const Vector2& a, const Vector2& b, const Vector2& c)
+		{
+			return (b.X - a.X) * (c.Y - a.Y) - (b.Y - a.Y) * (c.X - a.X);
+		}
+
+		// Is p inside abc or on its edges
+		inline bool inTriangle2(const Vector2& p, const Vector2& a, const Vector2& b, const Vector2& c)
+		{
+			return area2(a, b, p) >= 0 && area2(b, c, p) >= 0 && area2(c, a, p) >= 0;
+		}
+
+		// Ear clip a polygon that isn't convex, by index so repeated
+		//	positions can't be mistaken for each other
+		inline void earClip(std::vector<unsigned int>& oIndices, const Vertex* verts, unsigned int count, const Vector3& normal, Scratch& scratch)
+		{
+			// Drop the axis the normal points along the most, and
+			//	mirror the other two if needed to make the polygon counter clockwise
+			float ax = fabsf(normal.X), ay = fabsf(normal.Y), az = fabsf(normal.Z);
+			int u = 0, v = 1;
+			float facing = normal.Z;
+			if (ax >= ay && ax >= az)
+			{
+				u = 1; v = 2;
+				facing = normal.X;
+			}
+			else if (ay >= az)
+			{
+				u = 2; v = 0;
+				facing = normal.Y;
+			}
+			if (facing < 0)
+				std::swap(u, v);
+
+			scratch.points.resize(count);
+			scratch.prev.resize(count);
+			scratch.next.resize(count);
+			scratch.reflex.resize(count);
+			scratch.reflexCorners.clear();
+			for (unsigned int i = 0; i < count; i++)
+			{
+				const float* position = &verts[i].Position.X;
+				scratch.points[i] = Vector2(position[u], position[v]);
+				scratch.prev[i] = i == 0 ? count - 1 : i - 1;
+				scratch.next[i] = i + 1 == count ? 0 : i + 1;
+			}
+
+			const std::vector<Vector2>& points = scratch.points;
+			std::vector<unsigned int>& prev = scratch.prev;
+			std::vector<unsigned int>& next = scratch.next;
+
+			auto updateReflex = [&](unsigned int i)
+			{
+				bool isReflex = area2(points[prev[i]], points[i], points[next[i]]) <= 0;
+				if (isReflex && !scratch.reflex[i])
+					scratch.reflexCorners.push_back(i);
+				scratch.reflex[i] = isReflex;
+			};
+			for (unsigned int i = 0; i < count; i++)
+			{
+				scratch.reflex[i] = false;
+				updateReflex(i);
+			}
+
+			auto isEar = [&](unsigned int i)
+			{
+				if (scratch.reflex[i])
+					return false;
+
+				const Vector2& a = points[prev[i]];
+				const Vector2& b = points[i];
+				const Vector2& c = points[next[i]];
+				for (unsigned int r : scratch.reflexCorners)
+				{
+					// Corners on top of the ear's own don't block it
+					if (!scratch.reflex[r] || r == prev[i] || r == next[i])
+						continue;
+					const Vector2& p = points[r];
+					if (p == a || p == b || p == c)
+						continue;
+					if (inTriangle2(p, a, b, c))
+						return false;
+				}
+				return true;
+			};
+
+			unsigned int remaining = count;
+			unsigned int i = 0;
+			unsigned int misses = 0;
+			while (remaining > 3)
+			{
+				// A full lap without an ear only happens to polygons that cross
+				//	themselves, clip anyway so every face still gives count - 2 triangles
+				if (isEar(i) || misses >= remaining)
+				{
+					unsigned int p = prev[i], n = next[i];
+					oIndices.push_back(p);
+					oIndices.push_back(i);
+					oIndices.push_back(n);
+
+					next[p] = n;
+					prev[n] = p;
+					scratch.reflex[i] = false;
+					remaining--;
+					misses = 0;
+
+					updateReflex(p);
+					updateReflex(n);
+					i = n;
+				}
+				else
+				{
+					misses++;
+					i = next[i];
+				}
+			}
+
+			oIndices.push_back(prev[i]);
+			oIndices.push_back(i);
+			oIndices.push_back(next[i]);
+		}
+
+		// Triangulate the face verts[0, count) into oIndices, indices are
+		//	relative to verts and wound the same way as the face.
+		//	Any face with 3 or more corners gives count - 2 triangles
+		inline void Polygon(std::vector<unsigned int>& oIndices, const Vertex* verts, size_t count, Scratch& scratch)
+		{
+			if (count < 3)
+				return;
+
+			// Convex faces, which is nearly all of them, fan out of
+			//	the first corner without any further work
+			bool convex = true;
+			if (count > 3)
+			{
+				Vector3 normal = polygonNormal(verts, count);
+				for (size_t i = 0; i < count && convex; i++)
+				{
+					const Vector3& a = verts[i == 0 ? count - 1 : i - 1].Position;
+					const Vector3& b = verts[i].Position;
+					const Vector3& c = verts[i + 1 == count ? 0 : i + 1].Position;
+					convex = math::DotV3(math::CrossV3(b - a, c - b), normal) >= 0;
+				}
+
+				if (!convex)
+				{
+					earClip(oIndices, verts, (unsigned int)count, normal, scratch);
+					return;
+				}
+			}
+
+			for (unsigned int i = 1; i + 1 < count; i++)
+			{
+				oIndices.push_back(0);
+				oIndices.push_back(i);
+				oIndices.push_back(i + 1);
+			}
+		}
+
+		// The triangulation the loader used before Polygon, it scans
+		//	the whole face again after every ear and matches corners by
+		//	position. Only kept as the baseline for benchmarks
+		inline void Legacy(std::vector<unsigned int>& oIndices,
+			const std::vector<Vertex>& iVerts)
+		{
+			// If there are 2 or less verts,
+			// no triangle can be created,
+			// so exit
+			if (iVerts.size() < 3)
+			{
+				return;
+			}
+			// If it is a triangle no need to calculate it
+			if (iVerts.size() == 3)
+			{
+				oIndices.push_back(0);
+				oIndices.push_back(1);
+				oIndices.push_back(2);
+				return;
+			}
+
+			// Create a list of vertices
+			std::vector<Vertex> tVerts = iVerts;
+
+			while (true)
+			{
+				// For every vertex
+				for (int i = 0; i < int(tVerts.size()); i++)
+				{
+					// pPrev = the previous vertex in the list
+					Vertex pPrev;
+					if (i == 0)
+					{
+						pPrev = tVerts[tVerts.size() - 1];
+					}
+					else
+					{
+						pPrev = tVerts[i - 1];
+					}
+
+					// pCur = the current vertex;
+					Vertex pCur = tVerts[i];
+
+					// pNext = the next vertex in the list
+					Vertex pNext;
+					if (i == tVerts.size() - 1)
+					{
+						pNext = tVerts[0];
+					}
+					else
+					{
+						pNext = tVerts[i + 1];
+					}
+
+					// Check to see if there are only 3 verts left
+					// if so this is the last triangle
+					if (tVerts.size() == 3)
+					{
+						// Create a triangle from pCur, pPrev, pNext
+						for (int j = 0; j < int(tVerts.size()); j++)
+						{
+							if (iVerts[j].Position == pCur.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == pPrev.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == pNext.Position)
+								oIndices.push_back(j);
+						}
+
+						tVerts.clear();
+						break;
+					}
+					if (tVerts.size() == 4)
+					{
+						// Create a triangle from pCur, pPrev, pNext
+						for (int j = 0; j < int(iVerts.size()); j++)
+						{
+							if (iVerts[j].Position == pCur.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == pPrev.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == pNext.Position)
+								oIndices.push_back(j);
+						}
+
+						Vector3 tempVec;
+						for (int j = 0; j < int(tVerts.size()); j++)
+						{
+							if (tVerts[j].Position != pCur.Position
+								&& tVerts[j].Position != pPrev.Position
+								&& tVerts[j].Position != pNext.Position)
+							{
+								tempVec = tVerts[j].Position;
+								break;
+							}
+						}
+
+						// Create a triangle from pCur, pPrev, pNext
+						for (int j = 0; j < int(iVerts.size()); j++)
+						{
+							if (iVerts[j].Position == pPrev.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == pNext.Position)
+								oIndices.push_back(j);
+							if (iVerts[j].Position == tempVec)
+								oIndices.push_back(j);
+						}
+
+						tVerts.clear();
+						break;
+					}
+
+					// If Vertex is not an interior vertex
+					float angle = math::AngleBetweenV3(pPrev.Position - pCur.Position, pNext.Position - pCur.Position) * (180 / 3.14159265359);
+					if (angle <= 0 && angle >= 180)
+						continue;
+
+					// If any vertices are within this triangle
+					bool inTri = false;
+					for (int j = 0; j < int(iVerts.size()); j++)
+					{
+						if (algorithm::inTriangle(iVerts[j].Position, pPrev.Position, pCur.Position, pNext.Position)
+							&& iVerts[j].Position != pPrev.Position
+							&& iVerts[j].Position != pCur.Position
+							&& iVerts[j].Position != pNext.Position)
+						{
+							inTri = true;
+							break;
+						}
+					}
+					if (inTri)
+						continue;
+
+					// Create a triangle from pCur, pPrev, pNext
+					for (int j = 0; j < int(iVerts.size()); j++)
+					{
+						if (iVerts[j].Position == pCur.Position)
+							oIndices.push_back(j);
+						if (iVerts[j].Position == pPrev.Position)
+							oIndices.push_back(j);
+						if (iVerts[j].Position == pNext.Position)
+							oIndices.push_back(j);
+					}
+
+					// Delete pCur from the list
+					for (int j = 0; j < int(tVerts.size()); j++)
+					{
+						if (tVerts[j].Position == pCur.Position)
+						{
+							tVerts.erase(tVerts.begin() + j);
+							break;
+						}
+					}
+
+					// reset i to the start
+					// -1 since loop will add 1 to it
+					i = -1;
+				}
+
+				// if no triangles were created
+				if (oIndices.size() == 0)
+					break;
+
+				// if no more vertices
+				if (tVerts.size() == 0)
+					break;
+			}
+		}
+	}
+
+	// Namespace: Cache
+	//
+	// Description: The layout of the .objb compiled mesh cache
+	//	LoadMode::Cached keeps next to an .obj. Everything the
+	//	loader produced is stored so it can be used straight
+	//	out of the mapped file, each section on a cache line
+	namespace cache
+	{
+		// Bump whenever the layout changes, older caches get rebuilt
+		const uint32_t Version = 1;
+		const uint32_t ByteOrder = 0x01020304;
+		const size_t Alignment = 64;
+
+		// Loader settings that change what gets loaded
+		const uint32_t FlagWelded = 1;
+
+		// A piece of the string table
+		struct String
+		{
+			uint32_t offset;
+			uint32_t length;
+		};
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint32_t vertexSize;
+			uint32_t flags;
+			uint32_t meshCount;
+			uint32_t materialCount;
+			// .mtl files the .obj pulled in, they are part of the hash
+			uint32_t sourceCount;
+			// Hash of the .obj followed by every .mtl
+			uint64_t sourceHash;
+			uint64_t fileSize;
+			uint64_t vertexCount;
+			uint64_t indexCount;
+			uint64_t meshOffset;
+			uint64_t materialOffset;
+			uint64_t sourceOffset;
+			uint64_t vertexOffset;
+			// Every mesh's indices, relative to its own vertices
+			uint64_t meshIndexOffset;
+			// Loader::LoadedIndices
+			uint64_t loadedIndexOffset;
+			uint64_t stringOffset;
+			uint64_t stringSize;
+		};
+
+		struct MeshEntry
+		{
+			String name;
+			// Into the cache's materials, -1 for none
+			int32_t material;
+			uint32_t padding;
+			uint64_t vertexBegin;
+			uint64_t vertexCount;
+			uint64_t indexBegin;
+			uint64_t indexCount;
+		};
+
+		struct MaterialEntry
+		{
+			String name;
+			Vector3 Ka;
+			Vector3 Kd;
+			Vector3 Ks;
+			float Ns;
+			float Ni;
+			float d;
+			int32_t illum;
+			String map_Ka;
+			String map_Kd;
+			String map_Ks;
+			String map_Ns;
+			String map_d;
+			String map_bump;
+		};
+
+		inline size_t align(size_t offset)
+		{
+			return (offset + Alignment - 1) & ~(Alignment - 1);
+		}
+
+		inline uint64_t hashRound(uint64_t acc, uint64_t input)
+		{
+			acc += input * 0xC2B2AE3D27D4EB4Full;
+			acc = std::rotl(acc, 31);
+			return acc * 0x9E3779B185EBCA87ull;
+		}
+
+		// xxHash64 style hash, four independent lanes so it runs
+		//	at memory speed and checking a cache costs next to nothing
+		inline uint64_t Hash(const void* data, size_t size, uint64_t seed)
+		{
+			const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+			const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+			const uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+			const unsigned char* bytes = (const unsigned char*)data;
+			const unsigned char* end = bytes + size;
+			uint64_t h;
+
+			if (size >= 32)
+			{
+				uint64_t lanes[4] = { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+				for (; end - bytes >= 32; bytes += 32)
+				{
+					for (int lane = 0; lane < 4; lane++)
+					{
+						uint64_t input;
+						memcpy(&input, bytes + lane * 8, 8);
+						lanes[lane] = hashRound(lanes[lane], input);
+					}
+				}
+				h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+				for (uint64_t lane : lanes)
+					h = (h ^ hashRound(0, lane)) * prime1 + prime4;
+			}
+			else
+			{
+				h = seed + 0x27D4EB2F165667C5ull;
+			}
+
+			h += size;
+			for (; end - bytes >= 8; bytes += 8)
+			{
+				uint64_t input;
+				memcpy(&input, bytes, 8);
+				h = std::rotl(h ^ hashRound(0, input), 27) * prime1 + prime4;
+			}
+			for (; bytes < end; bytes++)
+				h = std::rotl(h ^ (*bytes * 0x27D4EB2F165667C5ull), 11) * prime1;
+
+			h ^= h >> 33;
+			h *= prime2;
+			h ^= h >> 29;
+			h *= 0x165667B19E3779F9ull;
+			h ^= h >> 32;
+			return h;
+		}
+	}
+
+	// Enum: LoadMode
+	//
+	// Description: How Loader::LoadFile reads an .obj,
+	//	every mode loads exactly the same meshes
+	enum class LoadMode
+	{
+		// std::getline and std::stof line by line
+		Stream,
+		// Memory map the file and parse it in place in one pass
+		Mapped,
+		// Memory map the file and parse newline aligned chunks of it
+		//	on Loader::ThreadCount threads, then stitch them together
+		Parallel,
+		// Memory map the .objb cache next to the file if it still
+		//	matches the .obj and its .mtl files, otherwise load the
+		//	file like Parallel and write the cache for next time
+		Cached
+	};
+
+	// Class: MappedFile
+	//
+	// Description: A read only view of a whole file
+	//	mapped into memory, unmapped when closed
+	class MappedFile
+	{
+	public:
+		MappedFile()
+		{
+
+		}
+		~MappedFile()
+		{
+			Close();
+		}
+
+		// Map the file at path, false if it can't be opened
+		bool Open(const std::string& path)
+		{
+			Close();
+#ifdef _WIN32
+			fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(fileHandle, &fileSize))
+			{
+				Close();
+				return false;
+			}
+			size = (size_t)fileSize.QuadPart;
+			if (size == 0)
+				return true;
+
+			mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mappingHandle == NULL)
+			{
+				Close();
+				return false;
+			}
+			data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+			fileDescriptor = open(path.c_str(), O_RDONLY);
+			if (fileDescriptor < 0)
+				return false;
+
+			struct stat fileStat;
+			if (fstat(fileDescriptor, &fileStat) != 0)
+			{
+				Close();
+				return false;
+			}
+			size = (size_t)fileStat.st_size;
+			if (size == 0)
+				return true;
+
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+			if (mapping != MAP_FAILED)
+			{
+				data = (const char*)mapping;
+				madvise(mapping, size, MADV_SEQUENTIAL);
+			}
+#endif
+			if (!data)
+			{
+				Close();
+				return false;
+			}
+			return true;
+		}
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (data)
+				UnmapViewOfFile(data);
+			if (mappingHandle != NULL)
+				CloseHandle(mappingHandle);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+				CloseHandle(fileHandle);
+			mappingHandle = NULL;
+			fileHandle = INVALID_HANDLE_VALUE;
+#else
+			if (data)
+				munmap((void*)data, size);
+			if (fileDescriptor >= 0)
+				close(fileDescriptor);
+			fileDescriptor = -1;
+#endif
+			data = nullptr;
+			size = 0;
+		}
+
+		const char* Data() const
+		{
+			return data;
+		}
+		size_t Size() const
+		{
+			return size;
+		}
+
+	private:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+#ifdef _WIN32
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = NULL;
+#else
+		int fileDescriptor = -1;
+#endif
+		const char* data = nullptr;
+		size_t size = 0;
+	};
+
+	// Structure: WeldKey
+	//
+	// Description: What a face corner was built from, two corners
+	//	with the same key always make the same Vertex
+	struct WeldKey
+	{
+		// Index into the positions read so far
+		int Position;
+		// Index into the texture coordinates, -1 if the corner has none
+		int TextureCoordinate;
+		// Index into the normals, -1 if the normal came from somewhere else
+		int Normal;
+		// The normal itself when Normal is -1, usually one generated for the face
+		Vector3 GeneratedNormal;
+
+		bool operator==(const WeldKey& other) const
+		{
+			if (Position != other.Position || TextureCoordinate != other.TextureCoordinate || Normal != other.Normal)
+				return false;
+			return Normal != -1 || std::memcmp(&GeneratedNormal, &other.GeneratedNormal, sizeof(Vector3)) == 0;
+		}
+	};
+
+	// Class: VertexWelder
+	//
+	// Description: Open addressing table from WeldKey to the
+	//	vertex first made from it, numbered in the order they were
+	//	welded, cleared without touching the table
+	class VertexWelder
+	{
+	public:
+		// Find the vertex for key, or number it as the next new
+		//	vertex and set inserted
+		unsigned int Weld(const WeldKey& key, bool& inserted)
+		{
+			if ((keys.size() + 1) * 2 > slots.size())
+				grow();
+
+			size_t mask = slots.size() - 1;
+			for (size_t slot = hash(key) & mask; ; slot = (slot + 1) & mask)
+			{
+				Slot& entry = slots[slot];
+				if (entry.generation != generation)
+				{
+					entry.generation = generation;
+					entry.vertex = (unsigned int)keys.size();
+					keys.push_back(key);
+					inserted = true;
+					return entry.vertex;
+				}
+				if (keys[entry.vertex] == key)
+				{
+					inserted = false;
+					return entry.vertex;
+				}
+			}
+		}
+
+		// Forget every key, the next vertex is 0 again
+		void Clear()
+		{
+			keys.clear();
+			if (++generation == 0)
+			{
+				std::fill(slots.begin(), slots.end(), Slot{ 0, 0 });
+				generation = 1;
+			}
+		}
+
+		// Vertices welded since the last Clear
+		size_t Size() const
+		{
+			return keys.size();
+		}
+
+	private:
+		struct Slot
+		{
+			unsigned int generation;
+			unsigned int vertex;
+		};
+
+		static size_t hash(const WeldKey& key)
+		{
+			uint64_t h = (uint32_t)key.Position * 0x9E3779B97F4A7C15ull;
+			h ^= ((uint64_t)(uint32_t)key.TextureCoordinate << 32 | (uint32_t)key.Normal) * 0xC2B2AE3D27D4EB4Full;
+			if (key.Normal == -1)
+			{
+				uint32_t bits[3];
+				std::memcpy(bits, &key.GeneratedNormal, sizeof(bits));
+				h ^= ((uint64_t)bits[0] << 32 | bits[1]) * 0x165667B19E3779F9ull + bits[2];
+			}
+			return (size_t)(h ^ (h >> 29));
+		}
+
+		void grow()
+		{
+			slots.assign(slots.empty() ? 1024 : slots.size() * 2, Slot{ 0, 0 });
+			generation = 1;
+
+			size_t mask = slots.size() - 1;
+			for (unsigned int vertex = 0; vertex < keys.size(); vertex++)
+			{
+				size_t slot = hash(keys[vertex]) & mask;
+				while (slots[slot].generation == generation)
+					slot = (slot + 1) & mask;
+				slots[slot] = { generation, vertex };
+			}
+		}
+
+		std::vector<Slot> slots;
+		std::vector<WeldKey> keys;
+		unsigned int generation = 1;
+	};
+
+	// Namespace: names
+	//
+	// Description: Process wide interned strings, every distinct
+	//	string gets one number for as long as the process runs
+	namespace names
+	{
+		struct Table
+		{
+			std::mutex mutex;
+			// A deque so a string never moves once it is in
+			std::deque<std::string> strings;
+			std::unordered_map<std::string_view, uint32_t> numbers;
+		};
+
+		inline Table& table()
+		{
+			static Table instance;
+			return instance;
+		}
+
+		// The number of text, the same every time it is asked for
+		inline uint32_t Intern(std::string_view text)
+		{
+			Table& names = table();
+			std::lock_guard<std::mutex> lock(names.mutex);
+			auto found = names.numbers.find(text);
+			if (found != names.numbers.end())
+				return found->second;
+
+			uint32_t number = (uint32_t)names.strings.size();
+			names.strings.emplace_back(text);
+			names.numbers.emplace(names.strings.back(), number);
+			return number;
+		}
+
+		// The text a number was interned from
+		inline const std::string& Name(uint32_t number)
+		{
+			Table& names = table();
+			std::lock_guard<std::mutex> lock(names.mutex);
+			return names.strings[number];
+		}
+	}
+
+	// Structure: MaterialLibrary
+	//
+	// Description: The materials of one .mtl, parsed once
+	//	and shared by every load that reads the same file
+	struct MaterialLibrary
+	{
+		std::vector<Material> Materials;
+		// The interned name of each material
+		std::vector<uint32_t> Names;
+	};
+
+	// Class: MaterialLibraries
+	//
+	// Description: Every .mtl the process has parsed, by canonical
+	//	path, parsed again only once its modification time or size
+	//	changes. Safe to use from any thread
+	class MaterialLibraries
+	{
+	public:
+		static MaterialLibraries& Get()
+		{
+			static MaterialLibraries instance;
+			return instance;
+		}
+
+		// The library at path, parse(materials) is only called when it
+		//	has to be parsed and returns false if it can't be. Null if
+		//	the file isn't there or doesn't parse
+		template <class Parse>
+		std::shared_ptr<const MaterialLibrary> Load(const std::string& path, const Parse& parse)
+		{
+			std::error_code error;
+			std::filesystem::path canonical = std::filesystem::canonical(path, error);
+			if (error)
+				return nullptr;
+			std::filesystem::file_time_type modified = std::filesystem::last_write_time(canonical, error);
+			if (error)
+				return nullptr;
+			uintmax_t size = std::filesystem::file_size(canonical, error);
+			if (error)
+				return nullptr;
+
+			std::string key = canonical.string();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto found = libraries.find(key);
+				if (found != libraries.end() && found->second.modified == modified && found->second.size == size)
+				{
+					hits++;
+					return found->second.library;
+				}
+			}
+
+			// Parse outside the lock, two loads racing for the same file just both parse it
+			std::shared_ptr<MaterialLibrary> library = std::make_shared<MaterialLibrary>();
+			if (!parse(library->Materials))
+				return nullptr;
+			for (const Material& material : library->Materials)
+				library->Names.push_back(names::Intern(material.name));
+
+			std::lock_guard<std::mutex> lock(mutex);
+			parses++;
+			libraries[key] = { modified, size, library };
+			return library;
+		}
+
+		// Forget every library, loads holding on to one keep it
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			libraries.clear();
+		}
+
+		// Loads answered without parsing and libraries parsed so far
+		size_t Hits() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return hits;
+		}
+		size_t Parses() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return parses;
+		}
+
+	private:
+		struct Entry
+		{
+			std::filesystem::file_time_type modified;
+			uintmax_t size;
+			std::shared_ptr<const MaterialLibrary> library;
+		};
+
+		mutable std::mutex mutex;
+		std::unordered_map<std::string, Entry> libraries;
+		size_t hits = 0;
+		size_t parses = 0;
+	};
+
+	// Class: Loader
+	//
+	// Description: The OBJ Model Loader
+	class Loader
+	{
+	public:
+		// Default Constructor
+		Loader()
+		{
+
+		}
+		~Loader()
+		{
+			LoadedMeshes.clear();
+		}
+
+		// Load a file into the loader
+		//
+		// If file is loaded return true
+		//
+		// If the file is unable to be found
+		// or unable to be loaded return false
+		bool LoadFile(std::string Path, LoadMode Mode = LoadMode::Stream)
+		{
+			PROFILE_ZONE("objl::Loader::LoadFile");
+
+			LoadedCompactMeshes.clear();
+			if (!loadFile(Path, Mode))
+				return false;
+
+			if (CompactIndices)
+			{
+				// Whichever of LoadedMeshRanges, LoadedMeshes or CachedMeshes the load filled
+				if (PoolMeshes)
+				{
+					LoadedCompactMeshes.reserve(LoadedMeshRanges.size());
+					for (size_t i = 0; i < LoadedMeshRanges.size(); i++)
+					{
+						const MeshRange& range = LoadedMeshRanges[i];
+						MeshView view;
+						view.MeshName = range.MeshName;
+						view.Vertices = LoadedVertices.data() + range.VertexOffset;
+						view.VertexCount = range.VertexCount;
+						view.Indices = LoadedIndices.data() + range.IndexOffset;
+						view.IndexCount = range.IndexCount;
+						view.MaterialIndex = range.MaterialIndex;
+						algorithm::ToCompactMeshes(view, i, SplitLargeMeshes, LoadedCompactMeshes, (unsigned int)range.VertexOffset);
+					}
+				}
+				else if (!LoadedMeshes.empty())
+				{
+					LoadedCompactMeshes.reserve(LoadedMeshes.size());
+					for (size_t i = 0; i < LoadedMeshes.size(); i++)
+						algorithm::ToCompactMeshes(LoadedMeshes[i], i, SplitLargeMeshes, LoadedCompactMeshes);
+				}
+				else
+				{
+					LoadedCompactMeshes.reserve(CachedMeshes.size());
+					for (size_t i = 0; i < CachedMeshes.size(); i++)
+						algorithm::ToCompactMeshes(CachedMeshes[i], i, SplitLargeMeshes, LoadedCompactMeshes);
+				}
+
+				if (CompactMeshesOnly)
+				{
+					// A rebuilt cache's CachedMeshes are over LoadedMeshes
+					if (!cacheFile)
+						CachedMeshes.clear();
+					LoadedMeshes.clear();
+					LoadedMeshRanges.clear();
+					std::vector<Vertex>().swap(LoadedVertices);
+					std::vector<unsigned int>().swap(LoadedIndices);
+				}
+			}
+			return true;
+		}
+
+		// Gets every mesh StreamFile finishes, move it out to keep it,
+		//	whatever is left in it is thrown away
+		using MeshCallback = std::function<void(Mesh& mesh)>;
+		// Same, and complete says this is the last call for the mesh.
+		//	With batches that call can be empty, when the mesh's triangles
+		//	all went out in the batches before it
+		using BatchCallback = std::function<void(Mesh& mesh, bool complete)>;
+
+		// Load an .obj a mesh at a time, read through a small buffer
+		//	instead of all at once. onMesh gets each mesh as soon as it
+		//	is finished, or every batchTriangles triangles of it if that's
+		//	not 0. Names and materials are what LoadFile would give it, as
+		//	long as its usemtl and mtllib lines came before it finished.
+		//	Only the v/vt/vn lists and the mesh being built are kept,
+		//	LoadedMeshes, LoadedVertices and LoadedIndices stay empty
+		bool StreamFile(const std::string& Path, const MeshCallback& onMesh, size_t batchTriangles = 0)
+		{
+			return StreamFile(Path, BatchCallback([&onMesh](Mesh& mesh, bool) { onMesh(mesh); }), batchTriangles);
+		}
+
+		// StreamFile telling onBatch which call ends each mesh
+		bool StreamFile(const std::string& Path, const BatchCallback& onBatch, size_t batchTriangles = 0)
+		{
+			PROFILE_ZONE("objl::Loader::StreamFile");
+
+			CachedMeshes.clear();
+			LoadedMeshRanges.clear();
+			cacheFile.reset();
+			materialFiles.clear();
+
+			// If the file is not an .obj file return false
+			if (Path.size() < 4 || Path.compare(Path.size() - 4, 4, ".obj") != 0)
+				return false;
+
+			std::ifstream file(Path, std::ios::binary);
+			if (!file.is_open())
+				return false;
+
+			LoadedMeshes.clear();
+			LoadedVertices.clear();
+			LoadedIndices.clear();
+
+			TextState state;
+			state.Path = Path;
+			state.fillLoaded = false;
+			state.batchTriangles = batchTriangles;
+			welder.Clear();
+
+			// Meshes are numbered like LoadedMeshes would be, batches share their mesh's number
+			size_t meshNumber = 0;
+			bool any = false;
+			Mesh mesh;
+			auto finish = [&](const std::string& name, bool complete)
+			{
+				// Lend the vectors to the mesh, and take back whatever the callback leaves
+				mesh.MeshName = name;
+				mesh.Vertices.swap(state.Vertices);
+				mesh.Indices.swap(state.Indices);
+				mesh.MaterialIndex = meshNumber < state.MeshMatNames.size() ? materialIndexOf(state.MeshMatNames[meshNumber]) : -1;
+				mesh.MeshMaterial = CopyMaterials && mesh.MaterialIndex >= 0 ? LoadedMaterials[mesh.MaterialIndex] : Material();
+
+				onBatch(mesh, complete);
+
+				mesh.Vertices.swap(state.Vertices);
+				mesh.Indices.swap(state.Indices);
+				if (complete)
+					meshNumber++;
+				any = true;
+			};
+
+			// Parse whole lines out of the buffer and carry the partial last line over,
+			//	the buffer only grows for a line that doesn't fit in it
+			std::vector<char> buffer(StreamBufferSize);
+			size_t filled = 0;
+			while (true)
+			{
+				file.read(buffer.data() + filled, buffer.size() - filled);
+				filled += (size_t)file.gcount();
+				bool end = !file;
+
+				size_t lineEnd = filled;
+				if (!end)
+				{
+					const char* lastNewline = nullptr;
+					for (size_t i = filled; i > 0; i--)
+					{
+						if (buffer[i - 1] == '\n')
+						{
+							lastNewline = &buffer[i - 1];
+							break;
+						}
+					}
+					if (!lastNewline)
+					{
+						buffer.resize(buffer.size() * 2);
+						continue;
+					}
+					lineEnd = lastNewline - buffer.data() + 1;
+				}
+
+				scan::ForEachLine(buffer.data(), buffer.data() + lineEnd, [&](const scan::Line& curline)
+				{
+					parseLine(curline, state, finish);
+				});
+
+				memmove(buffer.data(), buffer.data() + lineEnd, filled - lineEnd);
+				filled -= lineEnd;
+				if (end)
+					break;
+			}
+
+			// Deal with last mesh
+			if (state.HasMesh())
+				finish(state.meshname, true);
+
+			return any;
+		}
+
+		// Loaded Mesh Objects
+		std::vector<Mesh> LoadedMeshes;
+		// Loaded Vertex Objects
+		std::vector<Vertex> LoadedVertices;
+		// Loaded Index Positions
+		std::vector<unsigned int> LoadedIndices;
+		// Loaded Material Objects
+		std::vector<Material> LoadedMaterials;
+
+		// Threads LoadMode::Parallel uses, 0 for one per hardware thread
+		unsigned int ThreadCount = 0;
+
+		// Share one vertex between all the corners of a mesh made from the
+		//	same v/vt/vn, instead of one vertex per corner. LoadMode::Stream
+		//	loads through LoadMode::Mapped when this is set
+		bool WeldVertices = false;
+
+		// Also copy each mesh's material into Mesh::MeshMaterial for
+		//	callers that still read it. Off, Mesh::MaterialIndex into
+		//	LoadedMaterials is the only binding and MeshMaterial is empty
+		bool CopyMaterials = false;
+
+		// Leave LoadedMeshes empty and describe each mesh as a run of
+		//	LoadedVertices and LoadedIndices in LoadedMeshRanges instead,
+		//	so the geometry is only held once. LoadMode::Stream loads
+		//	through LoadMode::Mapped when this is set
+		bool PoolMeshes = false;
+		// Meshes of the last load with PoolMeshes set, in the order
+		//	LoadedMeshes would have them
+		std::vector<MeshRange> LoadedMeshRanges;
+
+		// Meshes of the last LoadMode::Cached load, straight out of the
+		//	mapped cache, or over LoadedMeshes when the cache was rebuilt
+		//	(none then with PoolMeshes set).
+		//	Good until the next load or the loader goes away
+		std::vector<MeshView> CachedMeshes;
+		// Also copy a cache hit into LoadedMeshes (or LoadedMeshRanges),
+		//	LoadedVertices and LoadedIndices, off leaves just CachedMeshes
+		//	and LoadedMaterials
+		bool CopyCachedMeshes = true;
+
+		// Also give the meshes of each LoadFile with 16 bit indices
+		//	wherever they fit in LoadedCompactMeshes, made from whichever
+		//	of LoadedMeshes, LoadedMeshRanges or CachedMeshes it filled
+		bool CompactIndices = true;
+		// Free LoadedMeshes, LoadedMeshRanges, LoadedVertices and
+		//	LoadedIndices once LoadedCompactMeshes has them, so only the
+		//	16 bit copy of the geometry is held. Off by default
+		bool CompactMeshesOnly = false;
+		// Split meshes too big for 16 bit indices into parts that fit,
+		//	off keeps them whole with 32 bit indices
+		bool SplitLargeMeshes = true;
+		// Meshes of the last load with CompactIndices set
+		std::vector<CompactMesh> LoadedCompactMeshes;
+
+	private:
+		// Vertices and triangulation of the face being parsed,
+		//	kept so faces don't allocate once they have grown
+		std::vector<Vertex> faceVertices;
+		std::vector<unsigned int> faceIndices;
+		// What each face vertex was made from and where it was welded to
+		std::vector<WeldKey> faceKeys;
+		std::vector<unsigned int> faceRemap;
+		VertexWelder welder;
+		triangulate::Scratch triangulation;
+		// The mapped cache CachedMeshes point into
+		std::shared_ptr<MappedFile> cacheFile;
+		// Every .mtl the current load read, in order
+		std::vector<std::string> materialFiles;
+		// The interned name of each of LoadedMaterials
+		std::vector<uint32_t> materialNames;
+
+		// How much of the file StreamFile reads at a time
+		static const size_t StreamBufferSize = 1024 * 1024;
+
+		// LoadFile without filling LoadedCompactMeshes
+		bool loadFile(const std::string& Path, LoadMode Mode)
+		{
+			CachedMeshes.clear();
+			LoadedMeshRanges.clear();
+			cacheFile.reset();
+			materialFiles.clear();
+
+			if (Mode == LoadMode::Cached)
+				return LoadFileCached(Path);
+			if (Mode == LoadMode::Mapped || (Mode == LoadMode::Stream && (WeldVertices || PoolMeshes)))
+				return LoadFileMapped(Path);
+			if (Mode == LoadMode::Parallel)
+				return LoadFileParallel(Path);
+
+			// If the file is not an .obj file return false
+			if (Path.substr(Path.size() - 4, 4) != ".obj")
+				return false;
+
+
+			std::ifstream file(Path);
+
+			if (!file.is_open())
+				return false;
+
+			LoadedMeshes.clear();
+			LoadedVertices.clear();
+			LoadedIndices.clear();
+
+			std::vector<Vector3> Positions;
+			std::vector<Vector2> TCoords;
+			std::vector<Vector3> Normals;
+
+			std::vector<Vertex> Vertices;
+			std::vector<unsigned int> Indices;
+
+			std::vector<uint32_t> MeshMatNames;
+
+			bool listening = false;
+			std::string meshname;
+
+			Mesh tempMesh;
+
+			#ifdef OBJL_CONSOLE_OUTPUT
+			const unsigned int outputEveryNth = 1000;
+			unsigned int outputIndicator = outputEveryNth;
+			#endif
+
+			std::string curline;
+			while (std::getline(file, curline))
+			{
+				#ifdef OBJL_CONSOLE_OUTPUT
+				if ((outputIndicator = ((outputIndicator + 1) % outputEveryNth)) == 1)
+				{
+					if (!meshname.empty())
+					{
+						std::cout
+							<< "\r- " << meshname
+							<< "\t| vertices > " << Positions.size()
+							<< "\t| texcoords > " << TCoords.size()
+							<< "\t| normals > " << Normals.size()
+							<< "\t| triangles > " << (Vertices.size() / 3)
+							<< (!MeshMatNames.empty() ? "\t| material: " + names::Name(MeshMatNames.back()) : "");
+					}
+				}
+				#endif
+
+				// Generate a Mesh Object or Prepare for an object to be created
+				if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g" || curline[0] == 'g')
+				{
+					if (!listening)
+					{
+						listening = true;
+
+						if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g")
+						{
+							meshname = algorithm::tail(curline);
+						}
+						else
+						{
+							meshname = "unnamed";
+						}
+					}
+					else
+					{
+						// Generate the mesh to put into the array
+
+						if (!Indices.empty() && !Vertices.empty())
+						{
+							// Create Mesh
+							tempMesh = Mesh(Vertices, Indices);
+							tempMesh.MeshName = meshname;
+
+							// Insert Mesh
+							LoadedMeshes.push_back(std::move(tempMesh));
+
+							// Cleanup
+							Vertices.clear();
+							Indices.clear();
+							meshname.clear();
+
+							meshname = algorithm::tail(curline);
+						}
+						else
+						{
+							if (algorithm::firstToken(curline) == "o" || algorithm::firstToken(curline) == "g")
+							{
+								meshname = algorithm::tail(curline);
+							}
+							else
+							{
+								meshname = "unnamed";
+							}
+						}
+					}
+					#ifdef OBJL_CONSOLE_OUTPUT
+					std::cout << std::endl;
+					outputIndicator = 0;
+					#endif
+				}
+				// Generate a Vertex Position
+				if (algorithm::firstToken(curline) == "v")
+				{
+					std::vector<std::string> spos;
+					Vector3 vpos;
+					algorithm::split(algorithm::tail(curline), spos, " ");
+
+					vpos.X = std::stof(spos[0]);
+					vpos.Y = std::stof(spos[1]);
+					vpos.Z = std::stof(spos[2]);
+
+					Positions.push_back(vpos);
+				}
+				// Generate a Vertex Texture Coordinate
+				if (algorithm::firstToken(curline) == "vt")
+				{
+					std::vector<std::string> stex;
+					Vector2 vtex;
+					algorithm::split(algorithm::tail(curline), stex, " ");
+
+					vtex.X = std::stof(stex[0]);
+					vtex.Y = std::stof(stex[1]);
+
+					TCoords.push_back(vtex);
+				}
+				// Generate a Vertex Normal;
+				if (algorithm::firstToken(curline) == "vn")
+				{
+					std::vector<std::string> snor;
+					Vector3 vnor;
+					algorithm::split(algorithm::tail(curline), snor, " ");
+
+					vnor.X = std::stof(snor[0]);
+					vnor.Y = std::stof(snor[1]);
+					vnor.Z = std::stof(snor[2]);
+
+					Normals.push_back(vnor);
+				}
+				// Generate a Face (vertices & indices)
+				if (algorithm::firstToken(curline) == "f")
+				{
+					// Generate the vertices
+					std::vector<Vertex> vVerts;
+					GenVerticesFromRawOBJ(vVerts, Positions, TCoords, Normals, curline);
+
+					// Add Vertices
+					for (int i = 0; i < int(vVerts.size()); i++)
+					{
+						Vertices.push_back(vVerts[i]);
+
+						LoadedVertices.push_back(vVerts[i]);
+					}
+
+					std::vector<unsigned int> iIndices;
+
+					VertexTriangluation(iIndices, vVerts);
+
+					// Add Indices
+					for (int i = 0; i < int(iIndices.size()); i++)
+					{
+						unsigned int indnum = (unsigned int)((Vertices.size()) - vVerts.size()) + iIndices[i];
+						Indices.push_back(indnum);
+
+						indnum = (unsigned int)((LoadedVertices.size()) - vVerts.size()) + iIndices[i];
+						LoadedIndices.push_back(indnum);
+
+					}
+				}
+				// Get Mesh Material Name
+				if (algorithm::firstToken(curline) == "usemtl")
+				{
+					MeshMatNames.push_back(names::Intern(algorithm::tail(curline)));
+
+					// Create new Mesh, if Material changes within a group
+					if (!Indices.empty() && !Vertices.empty())
+					{
+						// Create Mesh
+						tempMesh = Mesh(Vertices, Indices);
+						tempMesh.MeshName = meshname;
+						int i = 2;
+						while(1) {
+							tempMesh.MeshName = meshname + "_" + std::to_string(i);
+
+							for (auto &m : LoadedMeshes)
+								if (m.MeshName == tempMesh.MeshName)
+									continue;
+							break;
+						}
+
+						// Insert Mesh
+						LoadedMeshes.push_back(std::move(tempMesh));
+
+						// Cleanup
+						Vertices.clear();
+						Indices.clear();
+					}
+
+					#ifdef OBJL_CONSOLE_OUTPUT
+					outputIndicator = 0;
+					#endif
+				}
+				// Load Materials
+				if (algorithm::firstToken(curline) == "mtllib")
+				{
+					// Generate LoadedMaterial
+
+					// Generate a path to the material file
+					std::vector<std::string> temp;
+					algorithm::split(Path, temp, "/");
+
+					std::string pathtomat = "";
+
+					if (temp.size() != 1)
+					{
+						for (int i = 0; i < temp.size() - 1; i++)
+						{
+							pathtomat += temp[i] + "/";
+						}
+					}
+
+
+					pathtomat += algorithm::tail(curline);
+
+					#ifdef OBJL_CONSOLE_OUTPUT
+					std::cout << std::endl << "- find materials in: " << pathtomat << std::endl;
+					#endif
+
+					// Load Materials
+					LoadMaterials(pathtomat);
+				}
+			}
+
+			#ifdef OBJL_CONSOLE_OUTPUT
+			std::cout << std::endl;
+			#endif
+
+			// Deal with last mesh
+
+			if (!Indices.empty() && !Vertices.empty())
+			{
+				// Create Mesh
+				tempMesh = Mesh(Vertices, Indices);
+				tempMesh.MeshName = meshname;
+
+				// Insert Mesh
+				LoadedMeshes.push_back(std::move(tempMesh));
+			}
+
+			file.close();
+
+			// Set Materials for each Mesh
+			AssignMaterials(MeshMatNames);
+
+			if (LoadedMeshes.empty() && LoadedVertices.empty() && LoadedIndices.empty())
+			{
+				return false;
+			}
+			else
+			{
+				return true;
+			}
+		}
+
+		// Everything the in place parser carries from one line to the next
+		struct TextState
+		{
+			// The .obj, material files are next to it
+			std::string Path;
+
+			std::vector<Vector3> Positions;
+			std::vector<Vector2> TCoords;
+			std::vector<Vector3> Normals;
+
+			std::vector<Vertex> Vertices;
+			std::vector<unsigned int> Indices;
+			// What the mesh being built has so far, whether or not it is kept in Vertices and Indices
+			size_t meshVertexCount = 0;
+			size_t meshIndexCount = 0;
+
+			std::vector<uint32_t> MeshMatNames;
+
+			bool listening = false;
+			std::string meshname;
+
+			// Also build LoadedVertices and LoadedIndices while parsing
+			bool fillLoaded = true;
+			// Build the mesh in Vertices and Indices, off only counts it
+			bool fillMesh = true;
+			// Hand a mesh over every this many triangles, 0 to wait for the whole mesh
+			size_t batchTriangles = 0;
+			// Part of the mesh being built went out in a batch, so it still
+			//	needs its complete finish even with nothing left in it
+			bool batched = false;
+
+			// Whether there is a mesh to finish
+			bool HasMesh() const
+			{
+				return (meshIndexCount > 0 && meshVertexCount > 0) || batched;
+			}
+		};
+
+		// Parse one line of an .obj for the in place loaders. finish(name, complete)
+		//	gets called whenever state.Vertices and state.Indices hold a mesh
+		//	(or the counts say there is one, if they aren't filled),
+		//	complete is false for a batch of a mesh that isn't done yet,
+		//	they're cleared afterwards
+		template <class Finish>
+		void parseLine(const scan::Line& curline, TextState& state, const Finish& finish)
+		{
+			std::string_view key = curline.Key();
+
+			// Generate a Mesh Object or Prepare for an object to be created
+			if (key == "o" || key == "g" || (curline.Size() > 0 && curline.begin[0] == 'g'))
+			{
+				bool named = key == "o" || key == "g";
+				if (state.listening && state.HasMesh())
+				{
+					finishMesh(state, state.meshname, true, finish);
+
+					// LoadFile takes the tail here even for a line that only starts with g
+					named = true;
+				}
+				state.listening = true;
+
+				if (named)
+					state.meshname = curline.Tail();
+				else
+					state.meshname = "unnamed";
+			}
+			// Generate a Vertex Position
+			else if (key == "v")
+			{
+				Vector3 vpos;
+				scan::parseFloats(curline, &vpos.X, 3);
+				state.Positions.push_back(vpos);
+			}
+			// Generate a Vertex Texture Coordinate
+			else if (key == "vt")
+			{
+				Vector2 vtex;
+				scan::parseFloats(curline, &vtex.X, 2);
+				state.TCoords.push_back(vtex);
+			}
+			// Generate a Vertex Normal
+			else if (key == "vn")
+			{
+				Vector3 vnor;
+				scan::parseFloats(curline, &vnor.X, 3);
+				state.Normals.push_back(vnor);
+			}
+			// Generate a Face (vertices & indices)
+			else if (key == "f")
+			{
+				std::vector<Vertex>& Vertices = state.Vertices;
+				std::vector<unsigned int>& Indices = state.Indices;
+
+				GenVerticesFromFaceLine(faceVertices, state.Positions, state.TCoords, state.Normals, curline, WeldVertices ? &faceKeys : nullptr);
+
+				faceIndices.clear();
+				VertexTriangluation(faceIndices, faceVertices);
+
+				if (WeldVertices)
+				{
+					// Only corners the mesh hasn't seen yet become vertices
+					unsigned int loadedBase = (unsigned int)(LoadedVertices.size() - state.meshVertexCount);
+					faceRemap.resize(faceVertices.size());
+					for (size_t i = 0; i < faceVertices.size(); i++)
+					{
+						bool inserted;
+						faceRemap[i] = welder.Weld(faceKeys[i], inserted);
+						if (inserted)
+						{
+							if (state.fillMesh)
+								Vertices.push_back(faceVertices[i]);
+							if (state.fillLoaded)
+								LoadedVertices.push_back(faceVertices[i]);
+							state.meshVertexCount++;
+						}
+					}
+					for (unsigned int index : faceIndices)
+					{
+						if (state.fillMesh)
+							Indices.push_back(faceRemap[index]);
+						if (state.fillLoaded)
+							LoadedIndices.push_back(loadedBase + faceRemap[index]);
+					}
+				}
+				else
+				{
+					unsigned int meshBase = (unsigned int)state.meshVertexCount;
+					unsigned int loadedBase = (unsigned int)LoadedVertices.size();
+					if (state.fillMesh)
+						Vertices.insert(Vertices.end(), faceVertices.begin(), faceVertices.end());
+					if (state.fillLoaded)
+						LoadedVertices.insert(LoadedVertices.end(), faceVertices.begin(), faceVertices.end());
+					state.meshVertexCount += faceVertices.size();
+
+					for (unsigned int index : faceIndices)
+					{
+						if (state.fillMesh)
+							Indices.push_back(meshBase + index);
+						if (state.fillLoaded)
+							LoadedIndices.push_back(loadedBase + index);
+					}
+				}
+				state.meshIndexCount += faceIndices.size();
+
+				if (state.batchTriangles > 0 && state.meshIndexCount >= state.batchTriangles * 3)
+					finishMesh(state, state.meshname, false, finish);
+			}
+			// Get Mesh Material Name
+			else if (key == "usemtl")
+			{
+				state.MeshMatNames.push_back(names::Intern(curline.Tail()));
+
+				// Create new Mesh, if Material changes within a group
+				if (state.HasMesh())
+				{
+					// LoadFile always ends up naming these _2
+					finishMesh(state, state.meshname + "_2", true, finish);
+				}
+			}
+			// Load Materials
+			else if (key == "mtllib")
+			{
+				// The material file sits next to the .obj
+				size_t slash = state.Path.find_last_of('/');
+				std::string pathtomat = slash != std::string::npos ? state.Path.substr(0, slash + 1) : "";
+				pathtomat += curline.Tail();
+
+				#ifdef OBJL_CONSOLE_OUTPUT
+				std::cout << std::endl << "- find materials in: " << pathtomat << std::endl;
+				#endif
+
+				LoadMaterialsMapped(pathtomat);
+			}
+		}
+
+		template <class Finish>
+		void finishMesh(TextState& state, const std::string& name, bool complete, const Finish& finish)
+		{
+			finish(name, complete);
+			state.Vertices.clear();
+			state.Indices.clear();
+			state.meshVertexCount = 0;
+			state.meshIndexCount = 0;
+			state.batched = !complete;
+			welder.Clear();
+		}
+
+		// Load an .obj the same way as LoadFile but straight out of
+		//	a memory mapped file, one pass and no allocation per line
+		bool LoadFileMapped(const std::string& Path)
+		{
+			// If the file is not an .obj file return false
+			if (Path.size() < 4 || Path.compare(Path.size() - 4, 4, ".obj") != 0)
+				return false;
+
+			MappedFile file;
+			if (!file.Open(Path))
+				return false;
+
+			LoadedMeshes.clear();
+			LoadedVertices.clear();
+			LoadedIndices.clear();
+
+			TextState state;
+			state.Path = Path;
+			state.fillMesh = !PoolMeshes;
+			welder.Clear();
+
+			auto finish = [&](const std::string& name, bool)
+			{
+				if (PoolMeshes)
+				{
+					// The mesh is what was last added to the loaded vertices and indices
+					MeshRange& range = LoadedMeshRanges.emplace_back();
+					range.MeshName = name;
+					range.VertexOffset = LoadedVertices.size() - state.meshVertexCount;
+					range.VertexCount = state.meshVertexCount;
+					range.IndexOffset = LoadedIndices.size() - state.meshIndexCount;
+					range.IndexCount = state.meshIndexCount;
+					return;
+				}
+
+				// The mesh takes the vectors over, finishMesh starts new ones
+				Mesh& mesh = LoadedMeshes.emplace_back();
+				mesh.MeshName = name;
+				mesh.Vertices = std::move(state.Vertices);
+				mesh.Indices = std::move(state.Indices);
+			};
+			scan::ForEachLine(file.Data(), file.Data() + file.Size(), [&](const scan::Line& curline)
+			{
+				parseLine(curline, state, finish);
+			});
+
+			// Deal with last mesh
+			if (state.HasMesh())
+				finish(state.meshname, true);
+
+			AssignMaterials(state.MeshMatNames);
+
+			return !(LoadedMeshes.empty() && LoadedMeshRanges.empty() && LoadedVertices.empty() && LoadedIndices.empty());
+		}
+
+		// Load through the .objb cache next to the .obj, rebuilding
+		//	it with LoadFileParallel when it is missing or stale
+		bool LoadFileCached(const std::string& Path)
+		{
+			// If the file is not an .obj file return false
+			if (Path.size() < 4 || Path.compare(Path.size() - 4, 4, ".obj") != 0)
+				return false;
+
+			uint64_t objHash;
+			{
+				MappedFile source;
+				if (!source.Open(Path))
+					return false;
+				objHash = cache::Hash(source.Data(), source.Size(), 0);
+			}
+
+			std::string cachePath = Path + "b";
+			if (readCache(cachePath, objHash))
+				return true;
+
+			size_t materialBase = LoadedMaterials.size();
+			if (!LoadFileParallel(Path))
+				return false;
+
+			CachedMeshes.resize(LoadedMeshes.size());
+			for (size_t i = 0; i < LoadedMeshes.size(); i++)
+			{
+				const Mesh& mesh = LoadedMeshes[i];
+				MeshView& view = CachedMeshes[i];
+				view.MeshName = mesh.MeshName;
+				view.Vertices = mesh.Vertices.data();
+				view.VertexCount = mesh.Vertices.size();
+				view.Indices = mesh.Indices.data();
+				view.IndexCount = mesh.Indices.size();
+				view.MaterialIndex = mesh.MaterialIndex;
+			}
+
+			writeCache(cachePath, sourceHash(objHash, materialFiles), materialBase);
+			return true;
+		}
+
+		// The hash a cache of the .obj has to carry to still be good,
+		//	a .mtl that can't be read counts as empty
+		static uint64_t sourceHash(uint64_t objHash, const std::vector<std::string>& materialPaths)
+		{
+			uint64_t hash = objHash;
+			for (const std::string& path : materialPaths)
+			{
+				MappedFile material;
+				if (material.Open(path))
+					hash = cache::Hash(material.Data(), material.Size(), hash);
+				else
+					hash = cache::Hash(nullptr, 0, ~hash);
+			}
+			return hash;
+		}
+
+		// Map the cache at cachePath and load out of it if it
+		//	belongs to the .obj with objHash and this loader's settings.
+		//	Nothing is touched unless the whole cache checks out
+		bool readCache(const std::string& cachePath, uint64_t objHash)
+		{
+			std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+			if (!file->Open(cachePath) || file->Size() < sizeof(cache::Header))
+				return false;
+
+			const char* data = file->Data();
+			size_t size = file->Size();
+			const cache::Header& header = *(const cache::Header*)data;
+			if (memcmp(header.magic, "OBJB", 4) != 0 || header.version != cache::Version || header.byteOrder != cache::ByteOrder
+				|| header.vertexSize != sizeof(Vertex) || header.flags != (WeldVertices ? cache::FlagWelded : 0) || header.fileSize != size)
+				return false;
+
+			// Every section has to sit inside the file, on its alignment
+			auto fits = [&](uint64_t offset, uint64_t count, size_t elementSize)
+			{
+				return offset % cache::Alignment == 0 && offset <= size && count <= (size - offset) / elementSize;
+			};
+			if (!fits(header.meshOffset, header.meshCount, sizeof(cache::MeshEntry))
+				|| !fits(header.materialOffset, header.materialCount, sizeof(cache::MaterialEntry))
+				|| !fits(header.sourceOffset, header.sourceCount, sizeof(cache::String))
+				|| !fits(header.vertexOffset, header.vertexCount, sizeof(Vertex))
+				|| !fits(header.meshIndexOffset, header.indexCount, sizeof(unsigned int))
+				|| !fits(header.loadedIndexOffset, header.indexCount, sizeof(unsigned int))
+				|| !fits(header.stringOffset, header.stringSize, 1))
+				return false;
+
+			const char* strings = data + header.stringOffset;
+			bool stringsFit = true;
+			auto text = [&](const cache::String& string)
+			{
+				if ((uint64_t)string.offset + string.length > header.stringSize)
+				{
+					stringsFit = false;
+					return std::string_view();
+				}
+				return std::string_view(strings + string.offset, string.length);
+			};
+
+			const cache::String* sources = (const cache::String*)(data + header.sourceOffset);
+			std::vector<std::string> materialPaths;
+			for (uint32_t i = 0; i < header.sourceCount; i++)
+				materialPaths.push_back(std::string(text(sources[i])));
+			if (!stringsFit || sourceHash(objHash, materialPaths) != header.sourceHash)
+				return false;
+
+			const cache::MeshEntry* meshes = (const cache::MeshEntry*)(data + header.meshOffset);
+			for (uint32_t i = 0; i < header.meshCount; i++)
+			{
+				const cache::MeshEntry& mesh = meshes[i];
+				text(mesh.name);
+				if (mesh.vertexBegin > header.vertexCount || mesh.vertexCount > header.vertexCount - mesh.vertexBegin
+					|| mesh.indexBegin > header.indexCount || mesh.indexCount > header.indexCount - mesh.indexBegin
+					|| mesh.material < -1 || mesh.material >= (int32_t)header.materialCount)
+					return false;
+			}
+
+			const cache::MaterialEntry* materials = (const cache::MaterialEntry*)(data + header.materialOffset);
+			std::vector<Material> cachedMaterials(header.materialCount);
+			for (uint32_t i = 0; i < header.materialCount; i++)
+			{
+				const cache::MaterialEntry& entry = materials[i];
+				Material& material = cachedMaterials[i];
+				material.name = text(entry.name);
+				material.Ka = entry.Ka;
+				material.Kd = entry.Kd;
+				material.Ks = entry.Ks;
+				material.Ns = entry.Ns;
+				material.Ni = entry.Ni;
+				material.d = entry.d;
+				material.illum = entry.illum;
+				material.map_Ka = text(entry.map_Ka);
+				material.map_Kd = text(entry.map_Kd);
+				material.map_Ks = text(entry.map_Ks);
+				material.map_Ns = text(entry.map_Ns);
+				material.map_d = text(entry.map_d);
+				material.map_bump = text(entry.map_bump);
+			}
+			// An empty load fails, the same as it would from the text
+			if (!stringsFit || (header.meshCount == 0 && header.vertexCount == 0 && header.indexCount == 0))
+				return false;
+
+			// It all checks out, materials are added on like a text load would
+			int materialBase = (int)LoadedMaterials.size();
+			MaterialLibrary library;
+			library.Materials = std::move(cachedMaterials);
+			for (const Material& material : library.Materials)
+				library.Names.push_back(names::Intern(material.name));
+			addMaterials(library);
+
+			const Vertex* vertices = (const Vertex*)(data + header.vertexOffset);
+			const unsigned int* meshIndices = (const unsigned int*)(data + header.meshIndexOffset);
+			CachedMeshes.resize(header.meshCount);
+			for (uint32_t i = 0; i < header.meshCount; i++)
+			{
+				const cache::MeshEntry& mesh = meshes[i];
+				MeshView& view = CachedMeshes[i];
+				view.MeshName = text(mesh.name);
+				view.Vertices = vertices + mesh.vertexBegin;
+				view.VertexCount = (size_t)mesh.vertexCount;
+				view.Indices = meshIndices + mesh.indexBegin;
+				view.IndexCount = (size_t)mesh.indexCount;
+				view.MaterialIndex = mesh.material < 0 ? -1 : materialBase + mesh.material;
+			}
+
+			if (CopyCachedMeshes)
+			{
+				const unsigned int* loadedIndices = (const unsigned int*)(data + header.loadedIndexOffset);
+				LoadedVertices.assign(vertices, vertices + header.vertexCount);
+				LoadedIndices.assign(loadedIndices, loadedIndices + header.indexCount);
+				if (PoolMeshes)
+				{
+					LoadedMeshRanges.resize(header.meshCount);
+					for (uint32_t i = 0; i < header.meshCount; i++)
+					{
+						MeshRange& range = LoadedMeshRanges[i];
+						range.MeshName = CachedMeshes[i].MeshName;
+						range.VertexOffset = (size_t)meshes[i].vertexBegin;
+						range.VertexCount = (size_t)meshes[i].vertexCount;
+						range.IndexOffset = (size_t)meshes[i].indexBegin;
+						range.IndexCount = (size_t)meshes[i].indexCount;
+						range.MaterialIndex = CachedMeshes[i].MaterialIndex;
+					}
+				}
+				LoadedMeshes.resize(PoolMeshes ? 0 : header.meshCount);
+				for (size_t i = 0; i < LoadedMeshes.size(); i++)
+				{
+					const MeshView& view = CachedMeshes[i];
+					Mesh& mesh = LoadedMeshes[i];
+					mesh.MeshName = view.MeshName;
+					mesh.Vertices.assign(view.Vertices, view.Vertices + view.VertexCount);
+					mesh.Indices.assign(view.Indices, view.Indices + view.IndexCount);
+					mesh.MaterialIndex = view.MaterialIndex;
+					if (CopyMaterials && view.MaterialIndex >= 0)
+						mesh.MeshMaterial = LoadedMaterials[view.MaterialIndex];
+				}
+			}
+
+			cacheFile = file;
+			return true;
+		}
+
+		// Write what was just loaded to cachePath, through a temporary
+		//	file so a reader never sees half a cache. Gives up on loads
+		//	it can't describe, they just get parsed every time
+		bool writeCache(const std::string& cachePath, uint64_t hash, size_t materialBase)
+		{
+			std::string strings;
+			auto addString = [&](const std::string& text)
+			{
+				cache::String string = { (uint32_t)strings.size(), (uint32_t)text.size() };
+				strings += text;
+				return string;
+			};
+
+			std::vector<cache::MeshEntry> meshes(PoolMeshes ? LoadedMeshRanges.size() : LoadedMeshes.size());
+			uint64_t vertexBegin = 0, indexBegin = 0;
+			for (size_t i = 0; i < meshes.size(); i++)
+			{
+				cache::MeshEntry& entry = meshes[i];
+				int material;
+				if (PoolMeshes)
+				{
+					const MeshRange& range = LoadedMeshRanges[i];
+					material = range.MaterialIndex;
+					if (range.VertexOffset != vertexBegin || range.IndexOffset != indexBegin)
+						return false;
+					entry.name = addString(range.MeshName);
+					entry.vertexCount = range.VertexCount;
+					entry.indexCount = range.IndexCount;
+				}
+				else
+				{
+					const Mesh& mesh = LoadedMeshes[i];
+					material = mesh.MaterialIndex;
+					entry.name = addString(mesh.MeshName);
+					entry.vertexCount = mesh.Vertices.size();
+					entry.indexCount = mesh.Indices.size();
+				}
+				// Materials of an earlier load can't be in this cache
+				if (material >= 0 && material < (int)materialBase)
+					return false;
+
+				entry.material = material < 0 ? -1 : material - (int)materialBase;
+				entry.padding = 0;
+				entry.vertexBegin = vertexBegin;
+				entry.indexBegin = indexBegin;
+				vertexBegin += entry.vertexCount;
+				indexBegin += entry.indexCount;
+			}
+			// Meshes are back to back runs of the loaded vertices and indices
+			if (vertexBegin > LoadedVertices.size() || indexBegin != LoadedIndices.size())
+				return false;
+
+			std::vector<cache::MaterialEntry> materials(LoadedMaterials.size() - materialBase);
+			for (size_t i = 0; i < materials.size(); i++)
+			{
+				const Material& material = LoadedMaterials[materialBase + i];
+				cache::MaterialEntry& entry = materials[i];
+				entry.name = addString(material.name);
+				entry.Ka = material.Ka;
+				entry.Kd = material.Kd;
+				entry.Ks = material.Ks;
+				entry.Ns = material.Ns;
+				entry.Ni = material.Ni;
+				entry.d = material.d;
+				entry.illum = material.illum;
+				entry.map_Ka = addString(material.map_Ka);
+				entry.map_Kd = addString(material.map_Kd);
+				entry.map_Ks = addString(material.map_Ks);
+				entry.map_Ns = addString(material.map_Ns);
+				entry.map_d = addString(material.map_d);
+				entry.map_bump = addString(material.map_bump);
+			}
+
+			std::vector<cache::String> sources;
+			for (const std::string& path : materialFiles)
+				sources.push_back(addString(path));
+
+			cache::Header header = {};
+			memcpy(header.magic, "OBJB", 4);
+			header.version = cache::Version;
+			header.byteOrder = cache::ByteOrder;
+			header.vertexSize = sizeof(Vertex);
+			header.flags = WeldVertices ? cache::FlagWelded : 0;
+			header.meshCount = (uint32_t)meshes.size();
+			header.materialCount = (uint32_t)materials.size();
+			header.sourceCount = (uint32_t)sources.size();
+			header.sourceHash = hash;
+			header.vertexCount = LoadedVertices.size();
+			header.indexCount = LoadedIndices.size();
+
+			size_t offset = sizeof(cache::Header);
+			auto place = [&](uint64_t& sectionOffset, size_t bytes)
+			{
+				offset = cache::align(offset);
+				sectionOffset = offset;
+				offset += bytes;
+			};
+			place(header.meshOffset, meshes.size() * sizeof(cache::MeshEntry));
+			place(header.materialOffset, materials.size() * sizeof(cache::MaterialEntry));
+			place(header.sourceOffset, sources.size() * sizeof(cache::String));
+			place(header.vertexOffset, LoadedVertices.size() * sizeof(Vertex));
+			place(header.meshIndexOffset, LoadedIndices.size() * sizeof(unsigned int));
+			place(header.loadedIndexOffset, LoadedIndices.size() * sizeof(unsigned int));
+			place(header.stringOffset, strings.size());
+			header.stringSize = strings.size();
+			header.fileSize = offset;
+
+			std::string temporaryPath = cachePath + ".tmp";
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+
+			size_t written = 0;
+			auto write = [&](uint64_t sectionOffset, const void* bytes, size_t count)
+			{
+				static const char zeros[cache::Alignment] = {};
+				file.write(zeros, sectionOffset - written);
+				file.write((const char*)bytes, count);
+				written = sectionOffset + count;
+			};
+			write(0, &header, sizeof(header));
+			write(header.meshOffset, meshes.data(), meshes.size() * sizeof(cache::MeshEntry));
+			write(header.materialOffset, materials.data(), materials.size() * sizeof(cache::MaterialEntry));
+			write(header.sourceOffset, sources.data(), sources.size() * sizeof(cache::String));
+			write(header.vertexOffset, LoadedVertices.data(), LoadedVertices.size() * sizeof(Vertex));
+			write(header.meshIndexOffset, nullptr, 0);
+			if (PoolMeshes)
+			{
+				// Ranges only have the loaded indices, make them the mesh's own a block at a time
+				std::vector<unsigned int> block;
+				for (const cache::MeshEntry& entry : meshes)
+				{
+					for (uint64_t j = 0; j < entry.indexCount; j += 4096)
+					{
+						block.clear();
+						for (uint64_t k = j; k < entry.indexCount && k < j + 4096; k++)
+							block.push_back(LoadedIndices[entry.indexBegin + k] - (unsigned int)entry.vertexBegin);
+						file.write((const char*)block.data(), block.size() * sizeof(unsigned int));
+					}
+				}
+			}
+			else
+			{
+				for (const Mesh& mesh : LoadedMeshes)
+					file.write((const char*)mesh.Indices.data(), mesh.Indices.size() * sizeof(unsigned int));
+			}
+			written += LoadedIndices.size() * sizeof(unsigned int);
+			write(header.loadedIndexOffset, LoadedIndices.data(), LoadedIndices.size() * sizeof(unsigned int));
+			write(header.stringOffset, strings.data(), strings.size());
+			file.close();
+
+			std::error_code error;
+			if (file.fail())
+			{
+				std::filesystem::remove(temporaryPath, error);
+				return false;
+			}
+			std::filesystem::rename(temporaryPath, cachePath, error);
+			if (error)
+			{
+				std::filesystem::remove(temporaryPath, error);
+				return false;
+			}
+			return true;
+		}
+
+		// A face corner the way it is written, before it is resolved
+		struct ChunkCorner
+		{
+			// v, vt, vn as in the file, CornerMissing if the part isn't there and 0 if it doesn't parse
+			int index[3];
+		};
+
+		static const int CornerMissing = INT32_MIN;
+
+		struct ChunkFace
+		{
+			unsigned int cornerCount;
+			// How many positions, tcoords and normals the chunk had read when it got to the face
+			unsigned int positions;
+			unsigned int tcoords;
+			unsigned int normals;
+		};
+
+		enum class ChunkEventType
+		{
+			Group,
+			Material,
+			MaterialLibrary
+		};
+
+		// A line that changes the mesh being built, in front of chunk face number face
+		struct ChunkEvent
+		{
+			ChunkEventType type;
+			size_t face;
+			std::string text;
+			// Group lines with an o or g token, rather than just a leading g
+			bool named;
+			// Where the chunk's vertices and indices were at the event, set when the faces are resolved
+			size_t vertexOffset;
+			size_t indexOffset;
+		};
+
+		// A newline aligned piece of the file and everything parsed out of it
+		struct Chunk
+		{
+			const char* begin;
+			const char* end;
+
+			std::vector<Vector3> positions;
+			std::vector<Vector2> tcoords;
+			std::vector<Vector3> normals;
+			std::vector<ChunkCorner> corners;
+			std::vector<ChunkFace> faces;
+			std::vector<ChunkEvent> events;
+
+			// Elements every chunk before this one read
+			size_t positionBase;
+			size_t tcoordBase;
+			size_t normalBase;
+
+			// Resolved faces, indices relative to the chunk's first vertex
+			std::vector<Vertex> vertices;
+			std::vector<unsigned int> indices;
+			// What each vertex was made from, only when welding
+			std::vector<WeldKey> keys;
+			size_t vertexBase;
+			size_t indexBase;
+		};
+
+		// A mesh found while stitching the chunks, as ranges of the loaded vertices and indices
+		struct StitchedMesh
+		{
+			std::string name;
+			size_t vertexBegin;
+			size_t vertexEnd;
+			size_t indexBegin;
+			size_t indexEnd;
+		};
+
+		// Call function(i) for every i in [0, count) on up to threadCount threads
+		template <class Function>
+		static void ParallelFor(size_t count, unsigned int threadCount, const Function& function)
+		{
+			std::atomic<size_t> next(0);
+			auto worker = [&]()
+			{
+				for (size_t i = next++; i < count; i = next++)
+					function(i);
+			};
+
+			std::vector<std::thread> threads;
+			for (unsigned int t = 1; t < threadCount && t < count; t++)
+				threads.emplace_back(worker);
+			worker();
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+
+		// Load an .obj like LoadFileMapped with the parsing spread over
+		//	ThreadCount threads, the result is exactly the same
+		bool LoadFileParallel(const std::string& Path)
+		{
+			// If the file is not an .obj file return false
+			if (Path.size() < 4 || Path.compare(Path.size() - 4, 4, ".obj") != 0)
+				return false;
+
+			MappedFile file;
+			if (!file.Open(Path))
+				return false;
+
+			LoadedMeshes.clear();
+			LoadedVertices.clear();
+			LoadedIndices.clear();
+
+			unsigned int threadCount = ThreadCount;
+			if (threadCount == 0)
+				threadCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+			// A few chunks per thread so one slow chunk doesn't hold everyone up,
+			//	but not so many that small files are all overhead
+			const size_t minChunkSize = 256 * 1024;
+			size_t chunkCount = threadCount * 4;
+			if (chunkCount > file.Size() / minChunkSize + 1)
+				chunkCount = file.Size() / minChunkSize + 1;
+
+			std::vector<Chunk> chunks(chunkCount);
+			const char* data = file.Data();
+			const char* dataEnd = data + file.Size();
+			const char* chunkBegin = data;
+			for (size_t i = 0; i < chunkCount; i++)
+			{
+				const char* chunkEnd = dataEnd;
+				if (i + 1 < chunkCount)
 				{
-					std::vector<std::string> snor;
-					Vector3 vnor;
-					algorithm::split(algorithm::tail(curline), snor, " ");
+					chunkEnd = data + file.Size() * (i + 1) / chunkCount;
+					if (chunkEnd < chunkBegin)
+						chunkEnd = chunkBegin;
+					const char* newline = (const char*)memchr(chunkEnd, '\n', dataEnd - chunkEnd);
+					chunkEnd = newline ? newline + 1 : dataEnd;
+				}
+				chunks[i].begin = chunkBegin;
+				chunks[i].end = chunkEnd;
+				chunkBegin = chunkEnd;
+			}
 
-					vnor.X = std::stof(snor[0]);
-					vnor.Y = std::stof(snor[1]);
-					vnor.Z = std::stof(snor[2]);
+			// Read every record of every chunk
+			ParallelFor(chunkCount, threadCount, [&](size_t i) { ParseChunk(chunks[i]); });
 
-					Normals.push_back(vnor);
+			// Lay the attributes of all chunks out one after another
+			std::vector<Vector3> Positions;
+			std::vector<Vector2> TCoords;
+			std::vector<Vector3> Normals;
+			size_t positionCount = 0, tcoordCount = 0, normalCount = 0;
+			for (Chunk& chunk : chunks)
+			{
+				chunk.positionBase = positionCount;
+				chunk.tcoordBase = tcoordCount;
+				chunk.normalBase = normalCount;
+				positionCount += chunk.positions.size();
+				tcoordCount += chunk.tcoords.size();
+				normalCount += chunk.normals.size();
+			}
+			Positions.resize(positionCount);
+			TCoords.resize(tcoordCount);
+			Normals.resize(normalCount);
+
+			ParallelFor(chunkCount, threadCount, [&](size_t i)
+			{
+				Chunk& chunk = chunks[i];
+				std::copy(chunk.positions.begin(), chunk.positions.end(), Positions.begin() + chunk.positionBase);
+				std::copy(chunk.tcoords.begin(), chunk.tcoords.end(), TCoords.begin() + chunk.tcoordBase);
+				std::copy(chunk.normals.begin(), chunk.normals.end(), Normals.begin() + chunk.normalBase);
+				std::vector<Vector3>().swap(chunk.positions);
+				std::vector<Vector2>().swap(chunk.tcoords);
+				std::vector<Vector3>().swap(chunk.normals);
+			});
+
+			// Turn the faces into vertices and triangles now that every index can be resolved
+			ParallelFor(chunkCount, threadCount, [&](size_t i) { ResolveChunk(chunks[i], Positions, TCoords, Normals); });
+
+			size_t vertexCount = 0, indexCount = 0;
+			for (Chunk& chunk : chunks)
+			{
+				chunk.vertexBase = vertexCount;
+				chunk.indexBase = indexCount;
+				vertexCount += chunk.vertices.size();
+				indexCount += chunk.indices.size();
+			}
+			LoadedVertices.resize(vertexCount);
+			LoadedIndices.resize(indexCount);
+			std::vector<WeldKey> vertexKeys(WeldVertices ? vertexCount : 0);
+
+			ParallelFor(chunkCount, threadCount, [&](size_t i)
+			{
+				Chunk& chunk = chunks[i];
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), LoadedVertices.begin() + chunk.vertexBase);
+				if (WeldVertices)
+				{
+					std::copy(chunk.keys.begin(), chunk.keys.end(), vertexKeys.begin() + chunk.vertexBase);
+					std::vector<WeldKey>().swap(chunk.keys);
 				}
-				// Generate a Face (vertices & indices)
-				if (algorithm::firstToken(curline) == "f")
+				unsigned int base = (unsigned int)chunk.vertexBase;
+				for (size_t j = 0; j < chunk.indices.size(); j++)
+					LoadedIndices[chunk.indexBase + j] = base + chunk.indices[j];
+				std::vector<Vertex>().swap(chunk.vertices);
+				std::vector<unsigned int>().swap(chunk.indices);
+			});
+
+			// Walk the group, usemtl and mtllib lines in file order to find where meshes start and end
+			std::vector<StitchedMesh> meshRanges;
+			std::vector<uint32_t> MeshMatNames;
+			bool listening = false;
+			std::string meshname;
+			size_t meshVertexBegin = 0, meshIndexBegin = 0;
+
+			for (Chunk& chunk : chunks)
+			{
+				for (ChunkEvent& event : chunk.events)
 				{
-					// Generate the vertices
-					std::vector<Vertex> vVerts;
-					GenVerticesFromRawOBJ(vVerts, Positions, TCoords, Normals, curline);
+					size_t vertexOffset = chunk.vertexBase + event.vertexOffset;
+					size_t indexOffset = chunk.indexBase + event.indexOffset;
 
-					// Add Vertices
-					for (int i = 0; i < int(vVerts.size()); i++)
+					if (event.type == ChunkEventType::Group)
 					{
-						Vertices.push_back(vVerts[i]);
-
-						LoadedVertices.push_back(vVerts[i]);
-					}
+						bool named = event.named;
+						if (listening && indexOffset > meshIndexBegin)
+						{
+							meshRanges.push_back({ meshname, meshVertexBegin, vertexOffset, meshIndexBegin, indexOffset });
+							meshVertexBegin = vertexOffset;
+							meshIndexBegin = indexOffset;
 
-					std::vector<unsigned int> iIndices;
+							// LoadFile takes the tail here even for a line that only starts with g
+							named = true;
+						}
+						listening = true;
 
-					VertexTriangluation(iIndices, vVerts);
+						if (named)
+							meshname = event.text;
+						else
+							meshname = "unnamed";
+					}
+					else if (event.type == ChunkEventType::Material)
+					{
+						MeshMatNames.push_back(names::Intern(event.text));
 
-					// Add Indices
-					for (int i = 0; i < int(iIndices.size()); i++)
+						// Create new Mesh, if Material changes within a group
+						if (indexOffset > meshIndexBegin)
+						{
+							meshRanges.push_back({ meshname + "_2", meshVertexBegin, vertexOffset, meshIndexBegin, indexOffset });
+							meshVertexBegin = vertexOffset;
+							meshIndexBegin = indexOffset;
+						}
+					}
+					else
 					{
-						unsigned int indnum = (unsigned int)((Vertices.size()) - vVerts.size()) + iIndices[i];
-						Indices.push_back(indnum);
+						// The material file sits next to the .obj
+						size_t slash = Path.find_last_of('/');
+						std::string pathtomat = slash != std::string::npos ? Path.substr(0, slash + 1) : "";
+						pathtomat += event.text;
 
-						indnum = (unsigned int)((LoadedVertices.size()) - vVerts.size()) + iIndices[i];
-						LoadedIndices.push_back(indnum);
+						#ifdef OBJL_CONSOLE_OUTPUT
+						std::cout << std::endl << "- find materials in: " << pathtomat << std::endl;
+						#endif
 
+						LoadMaterialsMapped(pathtomat);
 					}
 				}
-				// Get Mesh Material Name
-				if (algorithm::firstToken(curline) == "usemtl")
+			}
+
+			// Deal with last mesh
+			if (indexCount > meshIndexBegin)
+				meshRanges.push_back({ meshname, meshVertexBegin, vertexCount, meshIndexBegin, indexCount });
+
+			if (WeldVertices)
+				WeldMeshRanges(meshRanges, vertexKeys, threadCount);
+
+			if (PoolMeshes)
+			{
+				LoadedMeshRanges.resize(meshRanges.size());
+				for (size_t i = 0; i < meshRanges.size(); i++)
 				{
-					MeshMatNames.push_back(algorithm::tail(curline));
+					const StitchedMesh& stitched = meshRanges[i];
+					MeshRange& range = LoadedMeshRanges[i];
+					range.MeshName = stitched.name;
+					range.VertexOffset = stitched.vertexBegin;
+					range.VertexCount = stitched.vertexEnd - stitched.vertexBegin;
+					range.IndexOffset = stitched.indexBegin;
+					range.IndexCount = stitched.indexEnd - stitched.indexBegin;
+				}
+				AssignMaterials(MeshMatNames);
+				return !(LoadedMeshRanges.empty() && LoadedVertices.empty() && LoadedIndices.empty());
+			}
 
-					// Create new Mesh, if Material changes within a group
-					if (!Indices.empty() && !Vertices.empty())
-					{
-						// Create Mesh
-						tempMesh = Mesh(Vertices, Indices);
-						tempMesh.MeshName = meshname;
-						int i = 2;
-						while(1) {
-							tempMesh.MeshName = meshname + "_" + std::to_string(i);
+			LoadedMeshes.resize(meshRanges.size());
+			ParallelFor(meshRanges.size(), threadCount, [&](size_t i)
+			{
+				const StitchedMesh& range = meshRanges[i];
+				Mesh& mesh = LoadedMeshes[i];
+				mesh.MeshName = range.name;
+				mesh.Vertices.assign(LoadedVertices.begin() + range.vertexBegin, LoadedVertices.begin() + range.vertexEnd);
+				mesh.Indices.resize(range.indexEnd - range.indexBegin);
+				unsigned int base = (unsigned int)range.vertexBegin;
+				for (size_t j = 0; j < mesh.Indices.size(); j++)
+					mesh.Indices[j] = LoadedIndices[range.indexBegin + j] - base;
+			});
+
+			AssignMaterials(MeshMatNames);
+
+			return !(LoadedMeshes.empty() && LoadedVertices.empty() && LoadedIndices.empty());
+		}
 
-							for (auto &m : LoadedMeshes)
-								if (m.MeshName == tempMesh.MeshName)
-									continue;
-							break;
-						}
+		// Weld the vertices of every mesh range on its own, the same as
+		//	LoadFileMapped does while it reads, and pack them back together
+		void WeldMeshRanges(std::vector<StitchedMesh>& meshRanges, const std::vector<WeldKey>& vertexKeys, unsigned int threadCount)
+		{
+			// Vertices after the last mesh belong to no mesh but are still loaded
+			std::vector<StitchedMesh> runs = meshRanges;
+			size_t lastEnd = runs.empty() ? 0 : runs.back().vertexEnd;
+			if (lastEnd < LoadedVertices.size())
+				runs.push_back({ std::string(), lastEnd, LoadedVertices.size(), LoadedIndices.size(), LoadedIndices.size() });
+
+			// Number each run's vertices by first use, the old vertex to its new number in the run
+			std::vector<unsigned int> remap(LoadedVertices.size());
+			std::vector<size_t> weldedCounts(runs.size());
+			ParallelFor(runs.size(), threadCount, [&](size_t i)
+			{
+				VertexWelder runWelder;
+				bool inserted;
+				for (size_t v = runs[i].vertexBegin; v < runs[i].vertexEnd; v++)
+					remap[v] = runWelder.Weld(vertexKeys[v], inserted);
+				weldedCounts[i] = runWelder.Size();
+			});
+
+			std::vector<size_t> weldedBases(runs.size());
+			size_t weldedCount = 0;
+			for (size_t i = 0; i < runs.size(); i++)
+			{
+				weldedBases[i] = weldedCount;
+				weldedCount += weldedCounts[i];
+			}
 
-						// Insert Mesh
-						LoadedMeshes.push_back(tempMesh);
+			std::vector<Vertex> welded(weldedCount);
+			ParallelFor(runs.size(), threadCount, [&](size_t i)
+			{
+				const StitchedMesh& run = runs[i];
+				unsigned int base = (unsigned int)weldedBases[i];
+				for (size_t v = run.vertexBegin; v < run.vertexEnd; v++)
+				{
+					remap[v] += base;
+					welded[remap[v]] = LoadedVertices[v];
+				}
+				for (size_t j = run.indexBegin; j < run.indexEnd; j++)
+					LoadedIndices[j] = remap[LoadedIndices[j]];
+			});
+			LoadedVertices.swap(welded);
 
-						// Cleanup
-						Vertices.clear();
-						Indices.clear();
+			for (size_t i = 0; i < meshRanges.size(); i++)
+			{
+				meshRanges[i].vertexBegin = weldedBases[i];
+				meshRanges[i].vertexEnd = weldedBases[i] + weldedCounts[i];
+			}
+		}
+
+		// Read the records of one chunk without resolving any indices
+		void ParseChunk(Chunk& chunk)
+		{
+			scan::ForEachLine(chunk.begin, chunk.end, [&](const scan::Line& curline)
+			{
+				std::string_view key = curline.Key();
+
+				if (key == "o" || key == "g" || (curline.Size() > 0 && curline.begin[0] == 'g'))
+				{
+					chunk.events.push_back({ ChunkEventType::Group, chunk.faces.size(), std::string(curline.Tail()), key == "o" || key == "g", 0, 0 });
+				}
+				else if (key == "v")
+				{
+					Vector3 vpos;
+					scan::parseFloats(curline, &vpos.X, 3);
+					chunk.positions.push_back(vpos);
+				}
+				else if (key == "vt")
+				{
+					Vector2 vtex;
+					scan::parseFloats(curline, &vtex.X, 2);
+					chunk.tcoords.push_back(vtex);
+				}
+				else if (key == "vn")
+				{
+					Vector3 vnor;
+					scan::parseFloats(curline, &vnor.X, 3);
+					chunk.normals.push_back(vnor);
+				}
+				else if (key == "f")
+				{
+					ChunkFace face;
+					face.cornerCount = 0;
+					face.positions = (unsigned int)chunk.positions.size();
+					face.tcoords = (unsigned int)chunk.tcoords.size();
+					face.normals = (unsigned int)chunk.normals.size();
+
+					for (size_t t = 1; t < curline.tokens.size(); t++)
+					{
+						std::string_view svert[3];
+						int parts = scan::splitCorner(curline.tokens[t], svert);
+
+						ChunkCorner chunkCorner;
+						for (int part = 0; part < 3; part++)
+						{
+							if (part >= parts || (part == 1 && svert[1].empty()))
+								chunkCorner.index[part] = CornerMissing;
+							else if (!algorithm::parseInt(svert[part], chunkCorner.index[part]))
+								chunkCorner.index[part] = 0;
+						}
+						chunk.corners.push_back(chunkCorner);
+						face.cornerCount++;
 					}
+					chunk.faces.push_back(face);
+				}
+				else if (key == "usemtl")
+				{
+					chunk.events.push_back({ ChunkEventType::Material, chunk.faces.size(), std::string(curline.Tail()), false, 0, 0 });
+				}
+				else if (key == "mtllib")
+				{
+					chunk.events.push_back({ ChunkEventType::MaterialLibrary, chunk.faces.size(), std::string(curline.Tail()), false, 0, 0 });
+				}
+			});
+		}
 
-					#ifdef OBJL_CONSOLE_OUTPUT
-					outputIndicator = 0;
-					#endif
+		// Resolve an index as written against the count of elements
+		//	read so far, nullptr if it is not a valid index
+		template <class T>
+		static const T * resolveIndex(const std::vector<T> &elements, size_t available, int index)
+		{
+			long long idx = index;
+			if (idx < 0)
+				idx = (long long)available + idx;
+			else
+				idx--;
+			if (idx < 0 || idx >= (long long)available)
+				return nullptr;
+			return &elements[(size_t)idx];
+		}
+
+		// Turn the faces of a parsed chunk into vertices and triangles
+		void ResolveChunk(Chunk& chunk,
+			const std::vector<Vector3>& iPositions,
+			const std::vector<Vector2>& iTCoords,
+			const std::vector<Vector3>& iNormals)
+		{
+			std::vector<Vertex> oVerts;
+			std::vector<unsigned int> oIndices;
+			std::vector<WeldKey> oKeys;
+			WeldKey key;
+			triangulate::Scratch scratch;
+			size_t corner = 0;
+			size_t nextEvent = 0;
+
+			for (size_t f = 0; f <= chunk.faces.size(); f++)
+			{
+				while (nextEvent < chunk.events.size() && chunk.events[nextEvent].face == f)
+				{
+					chunk.events[nextEvent].vertexOffset = chunk.vertices.size();
+					chunk.events[nextEvent].indexOffset = chunk.indices.size();
+					nextEvent++;
 				}
-				// Load Materials
-				if (algorithm::firstToken(curline) == "mtllib")
+				if (f == chunk.faces.size())
+					break;
+
+				const ChunkFace& face = chunk.faces[f];
+				size_t positions = chunk.positionBase + face.positions;
+				size_t tcoords = chunk.tcoordBase + face.tcoords;
+				size_t normals = chunk.normalBase + face.normals;
+
+				oVerts.clear();
+				oKeys.clear();
+				Vertex vVert;
+				bool noNormal = false;
+
+				for (unsigned int c = 0; c < face.cornerCount; c++)
 				{
-					// Generate LoadedMaterial
+					const ChunkCorner& chunkCorner = chunk.corners[corner + c];
 
-					// Generate a path to the material file
-					std::vector<std::string> temp;
-					algorithm::split(Path, temp, "/");
+					const Vector3* position = resolveIndex(iPositions, positions, chunkCorner.index[0]);
+					if (!position)
+						continue;
+					vVert.Position = *position;
+					key.Position = (int)(position - iPositions.data());
 
-					std::string pathtomat = "";
+					if (chunkCorner.index[1] != CornerMissing)
+					{
+						const Vector2* texture = resolveIndex(iTCoords, tcoords, chunkCorner.index[1]);
+						if (!texture)
+							continue;
+						vVert.TextureCoordinate = *texture;
+						key.TextureCoordinate = (int)(texture - iTCoords.data());
+					}
+					else
+					{
+						vVert.TextureCoordinate = Vector2(0, 0);
+						key.TextureCoordinate = -1;
+					}
 
-					if (temp.size() != 1)
+					if (chunkCorner.index[2] != CornerMissing)
 					{
-						for (int i = 0; i < temp.size() - 1; i++)
-						{
-							pathtomat += temp[i] + "/";
-						}
+						const Vector3* normal = resolveIndex(iNormals, normals, chunkCorner.index[2]);
+						if (!normal)
+							continue;
+						vVert.Normal = *normal;
+						key.Normal = (int)(normal - iNormals.data());
+					}
+					else
+					{
+						noNormal = true;
+						key.Normal = -1;
 					}
 
+					oVerts.push_back(vVert);
+					if (WeldVertices)
+						oKeys.push_back(key);
+				}
+				corner += face.cornerCount;
+
+				// take care of missing normals
+				if (noNormal && oVerts.size() >= 3)
+				{
+					Vector3 A = oVerts[0].Position - oVerts[1].Position;
+					Vector3 B = oVerts[2].Position - oVerts[1].Position;
 
-					pathtomat += algorithm::tail(curline);
+					Vector3 normal = math::CrossV3(A, B);
 
-					#ifdef OBJL_CONSOLE_OUTPUT
-					std::cout << std::endl << "- find materials in: " << pathtomat << std::endl;
-					#endif
+					for (Vertex& vert : oVerts)
+					{
+						vert.Normal = normal;
+					}
+				}
 
-					// Load Materials
-					LoadMaterials(pathtomat);
+				if (WeldVertices)
+				{
+					keyGeneratedNormals(oKeys, oVerts, noNormal);
+					chunk.keys.insert(chunk.keys.end(), oKeys.begin(), oKeys.end());
 				}
+
+				oIndices.clear();
+				triangulate::Polygon(oIndices, oVerts.data(), oVerts.size(), scratch);
+
+				unsigned int base = (unsigned int)chunk.vertices.size();
+				chunk.vertices.insert(chunk.vertices.end(), oVerts.begin(), oVerts.end());
+				for (unsigned int index : oIndices)
+					chunk.indices.push_back(base + index);
 			}
 
-			#ifdef OBJL_CONSOLE_OUTPUT
-			std::cout << std::endl;
-			#endif
+			std::vector<ChunkCorner>().swap(chunk.corners);
+			std::vector<ChunkFace>().swap(chunk.faces);
+		}
 
-			// Deal with last mesh
+		// Point each mesh at its named material, in order, and
+		//	copy the material in too if CopyMaterials is set
+		void AssignMaterials(const std::vector<uint32_t>& MeshMatNames)
+		{
+			syncMaterialNames();
+			std::unordered_map<uint32_t, int> materialOf;
+			for (size_t j = 0; j < materialNames.size(); j++)
+				materialOf.emplace(materialNames[j], (int)j);
 
-			if (!Indices.empty() && !Vertices.empty())
+			size_t meshCount = PoolMeshes ? LoadedMeshRanges.size() : LoadedMeshes.size();
+			for (size_t i = 0; i < MeshMatNames.size() && i < meshCount; i++)
 			{
-				// Create Mesh
-				tempMesh = Mesh(Vertices, Indices);
-				tempMesh.MeshName = meshname;
+				auto found = materialOf.find(MeshMatNames[i]);
+				if (found == materialOf.end())
+					continue;
 
-				// Insert Mesh
-				LoadedMeshes.push_back(tempMesh);
+				if (PoolMeshes)
+				{
+					LoadedMeshRanges[i].MaterialIndex = found->second;
+					continue;
+				}
+				LoadedMeshes[i].MaterialIndex = found->second;
+				if (CopyMaterials)
+					LoadedMeshes[i].MeshMaterial = LoadedMaterials[found->second];
 			}
+		}
 
-			file.close();
+		// The first loaded material with the interned name, -1 if there is none
+		int materialIndexOf(uint32_t name)
+		{
+			syncMaterialNames();
+			for (size_t j = 0; j < materialNames.size(); j++)
+			{
+				if (materialNames[j] == name)
+					return (int)j;
+			}
+			return -1;
+		}
 
-			// Set Materials for each Mesh
-			for (int i = 0; i < MeshMatNames.size(); i++)
+		// Intern the names of LoadedMaterials again if they were changed from outside
+		void syncMaterialNames()
+		{
+			if (materialNames.size() == LoadedMaterials.size())
+				return;
+			materialNames.clear();
+			for (const Material& material : LoadedMaterials)
+				materialNames.push_back(names::Intern(material.name));
+		}
+
+		// Add the materials of a library on to LoadedMaterials
+		void addMaterials(const MaterialLibrary& library)
+		{
+			syncMaterialNames();
+			LoadedMaterials.insert(LoadedMaterials.end(), library.Materials.begin(), library.Materials.end());
+			materialNames.insert(materialNames.end(), library.Names.begin(), library.Names.end());
+		}
+
+		// GenVerticesFromRawOBJ over the tokens of a face line
+		//	in place, corners that don't parse are skipped.
+		//	oKeys gets the WeldKey of each vertex if it is given
+		void GenVerticesFromFaceLine(std::vector<Vertex>& oVerts,
+			const std::vector<Vector3>& iPositions,
+			const std::vector<Vector2>& iTCoords,
+			const std::vector<Vector3>& iNormals,
+			const scan::Line& iface,
+			std::vector<WeldKey>* oKeys = nullptr)
+		{
+			oVerts.clear();
+			if (oKeys)
+				oKeys->clear();
+			WeldKey key;
+			Vertex vVert;
+			bool noNormal = false;
+
+			for (size_t t = 1; t < iface.tokens.size(); t++)
 			{
-				std::string matname = MeshMatNames[i];
+				// Split v/vt/vn, a missing part is empty
+				std::string_view svert[3];
+				int parts = scan::splitCorner(iface.tokens[t], svert);
+
+				const Vector3* position = algorithm::getElementView(iPositions, svert[0]);
+				if (!position)
+					continue;
+				vVert.Position = *position;
+				key.Position = (int)(position - iPositions.data());
+
+				// Position & Texture, or Position, Texture, and Normal
+				if (parts >= 2 && !svert[1].empty())
+				{
+					const Vector2* texture = algorithm::getElementView(iTCoords, svert[1]);
+					if (!texture)
+						continue;
+					vVert.TextureCoordinate = *texture;
+					key.TextureCoordinate = (int)(texture - iTCoords.data());
+				}
+				else
+				{
+					vVert.TextureCoordinate = Vector2(0, 0);
+					key.TextureCoordinate = -1;
+				}
 
-				// Find corresponding material name in loaded materials
-				// when found copy material variables into mesh material
-				for (int j = 0; j < LoadedMaterials.size(); j++)
+				if (parts == 3)
 				{
-					if (LoadedMaterials[j].name == matname)
-					{
-						LoadedMeshes[i].MeshMaterial = LoadedMaterials[j];
-						break;
-					}
+					const Vector3* normal = algorithm::getElementView(iNormals, svert[2]);
+					if (!normal)
+						continue;
+					vVert.Normal = *normal;
+					key.Normal = (int)(normal - iNormals.data());
+				}
+				else
+				{
+					noNormal = true;
+					key.Normal = -1;
 				}
+
+				oVerts.push_back(vVert);
+				if (oKeys)
+					oKeys->push_back(key);
 			}
 
-			if (LoadedMeshes.empty() && LoadedVertices.empty() && LoadedIndices.empty())
+			// take care of missing normals
+			if (noNormal && oVerts.size() >= 3)
 			{
-				return false;
+				Vector3 A = oVerts[0].Position - oVerts[1].Position;
+				Vector3 B = oVerts[2].Position - oVerts[1].Position;
+
+				Vector3 normal = math::CrossV3(A, B);
+
+				for (Vertex& vert : oVerts)
+				{
+					vert.Normal = normal;
+				}
 			}
-			else
+
+			if (oKeys)
+				keyGeneratedNormals(*oKeys, oVerts, noNormal);
+		}
+
+		// Key the normal of every vertex that didn't take its own by value
+		static void keyGeneratedNormals(std::vector<WeldKey>& keys, const std::vector<Vertex>& verts, bool noNormal)
+		{
+			for (size_t i = 0; i < keys.size(); i++)
 			{
-				return true;
+				if (keys[i].Normal == -1 || (noNormal && verts.size() >= 3))
+				{
+					keys[i].Normal = -1;
+					keys[i].GeneratedNormal = verts[i].Normal;
+				}
 			}
 		}
 
-		// Loaded Mesh Objects
-		std::vector<Mesh> LoadedMeshes;
-		// Loaded Vertex Objects
-		std::vector<Vertex> LoadedVertices;
-		// Loaded Index Positions
-		std::vector<unsigned int> LoadedIndices;
-		// Loaded Material Objects
-		std::vector<Material> LoadedMaterials;
-
-	private:
 		// Generate vertices from a list of positions, 
 		//	tcoords, normals and a face line
 		void GenVerticesFromRawOBJ(std::vector<Vertex>& oVerts,
@@ -739,8 +3822,13 @@ namespace objl
 			// For every given vertex do this
 			for (int i = 0; i < int(sface.size()); i++)
 			{
+				// Runs of spaces leave empty tokens, they aren't vertices
+				//	(the mapped tokenizer never makes them)
+				if (sface[i].empty())
+					continue;
+
 				// See What type the vertex is.
-				int vtype;
+				int vtype = 0;
 
 				algorithm::split(sface[i], svert, "/");
 
@@ -838,177 +3926,37 @@ namespace objl
 		void VertexTriangluation(std::vector<unsigned int>& oIndices,
 			const std::vector<Vertex>& iVerts)
 		{
-			// If there are 2 or less verts,
-			// no triangle can be created,
-			// so exit
-			if (iVerts.size() < 3)
-			{
-				return;
-			}
-			// If it is a triangle no need to calculate it
-			if (iVerts.size() == 3)
-			{
-				oIndices.push_back(0);
-				oIndices.push_back(1);
-				oIndices.push_back(2);
-				return;
-			}
-
-			// Create a list of vertices
-			std::vector<Vertex> tVerts = iVerts;
-
-			while (true)
-			{
-				// For every vertex
-				for (int i = 0; i < int(tVerts.size()); i++)
-				{
-					// pPrev = the previous vertex in the list
-					Vertex pPrev;
-					if (i == 0)
-					{
-						pPrev = tVerts[tVerts.size() - 1];
-					}
-					else
-					{
-						pPrev = tVerts[i - 1];
-					}
-
-					// pCur = the current vertex;
-					Vertex pCur = tVerts[i];
-
-					// pNext = the next vertex in the list
-					Vertex pNext;
-					if (i == tVerts.size() - 1)
-					{
-						pNext = tVerts[0];
-					}
-					else
-					{
-						pNext = tVerts[i + 1];
-					}
-
-					// Check to see if there are only 3 verts left
-					// if so this is the last triangle
-					if (tVerts.size() == 3)
-					{
-						// Create a triangle from pCur, pPrev, pNext
-						for (int j = 0; j < int(tVerts.size()); j++)
-						{
-							if (iVerts[j].Position == pCur.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == pPrev.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == pNext.Position)
-								oIndices.push_back(j);
-						}
-
-						tVerts.clear();
-						break;
-					}
-					if (tVerts.size() == 4)
-					{
-						// Create a triangle from pCur, pPrev, pNext
-						for (int j = 0; j < int(iVerts.size()); j++)
-						{
-							if (iVerts[j].Position == pCur.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == pPrev.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == pNext.Position)
-								oIndices.push_back(j);
-						}
-
-						Vector3 tempVec;
-						for (int j = 0; j < int(tVerts.size()); j++)
-						{
-							if (tVerts[j].Position != pCur.Position
-								&& tVerts[j].Position != pPrev.Position
-								&& tVerts[j].Position != pNext.Position)
-							{
-								tempVec = tVerts[j].Position;
-								break;
-							}
-						}
-
-						// Create a triangle from pCur, pPrev, pNext
-						for (int j = 0; j < int(iVerts.size()); j++)
-						{
-							if (iVerts[j].Position == pPrev.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == pNext.Position)
-								oIndices.push_back(j);
-							if (iVerts[j].Position == tempVec)
-								oIndices.push_back(j);
-						}
-
-						tVerts.clear();
-						break;
-					}
-
-					// If Vertex is not an interior vertex
-					float angle = math::AngleBetweenV3(pPrev.Position - pCur.Position, pNext.Position - pCur.Position) * (180 / 3.14159265359);
-					if (angle <= 0 && angle >= 180)
-						continue;
-
-					// If any vertices are within this triangle
-					bool inTri = false;
-					for (int j = 0; j < int(iVerts.size()); j++)
-					{
-						if (algorithm::inTriangle(iVerts[j].Position, pPrev.Position, pCur.Position, pNext.Position)
-							&& iVerts[j].Position != pPrev.Position
-							&& iVerts[j].Position != pCur.Position
-							&& iVerts[j].Position != pNext.Position)
-						{
-							inTri = true;
-							break;
-						}
-					}
-					if (inTri)
-						continue;
-
-					// Create a triangle from pCur, pPrev, pNext
-					for (int j = 0; j < int(iVerts.size()); j++)
-					{
-						if (iVerts[j].Position == pCur.Position)
-							oIndices.push_back(j);
-						if (iVerts[j].Position == pPrev.Position)
-							oIndices.push_back(j);
-						if (iVerts[j].Position == pNext.Position)
-							oIndices.push_back(j);
-					}
-
-					// Delete pCur from the list
-					for (int j = 0; j < int(tVerts.size()); j++)
-					{
-						if (tVerts[j].Position == pCur.Position)
-						{
-							tVerts.erase(tVerts.begin() + j);
-							break;
-						}
-					}
-
-					// reset i to the start
-					// -1 since loop will add 1 to it
-					i = -1;
-				}
-
-				// if no triangles were created
-				if (oIndices.size() == 0)
-					break;
-
-				// if no more vertices
-				if (tVerts.size() == 0)
-					break;
-			}
+			triangulate::Polygon(oIndices, iVerts.data(), iVerts.size(), triangulation);
 		}
 
-		// Load Materials from .mtl file
+		// Load Materials from .mtl file, parsed only if the
+		//	process hasn't already parsed the same file
 		bool LoadMaterials(std::string path)
 		{
 			// If the file is not a material file return false
 			if (path.substr(path.size() - 4, path.size()) != ".mtl")
 				return false;
 
+			std::shared_ptr<const MaterialLibrary> library = MaterialLibraries::Get().Load(path, [&](std::vector<Material>& materials)
+			{
+				return parseMaterials(path, materials);
+			});
+			if (!library)
+				return false;
+			addMaterials(*library);
+
+			// Test to see if anything was loaded
+			// If not return false
+			if (LoadedMaterials.empty())
+				return false;
+			// If so return true
+			else
+				return true;
+		}
+
+		// Parse the materials of an .mtl file
+		static bool parseMaterials(const std::string& path, std::vector<Material>& materials)
+		{
 			std::ifstream file(path);
 
 			// If the file is not found return false
@@ -1044,7 +3992,7 @@ namespace objl
 						// Generate the material
 
 						// Push Back loaded Material
-						LoadedMaterials.push_back(tempMaterial);
+						materials.push_back(tempMaterial);
 
 						// Clear Loaded Material
 						tempMaterial = Material();
@@ -1153,15 +4101,137 @@ namespace objl
 			// Deal with last material
 
 			// Push Back loaded Material
-			LoadedMaterials.push_back(tempMaterial);
+			materials.push_back(tempMaterial);
 
-			// Test to see if anything was loaded
-			// If not return false
-			if (LoadedMaterials.empty())
+			return true;
+		}
+
+		// Parse a color the way LoadMaterials does, only a tail that
+		//	splits into exactly three parts at its spaces is a color
+		static void parseColor(std::string_view tail, Vector3& color)
+		{
+			size_t first = tail.find(' ');
+			if (first == std::string_view::npos)
+				return;
+			size_t second = tail.find(' ', first + 1);
+			if (second == std::string_view::npos || tail.find(' ', second + 1) != std::string_view::npos)
+				return;
+
+			Vector3 parsed;
+			if (algorithm::parseFloat(tail.substr(0, first), parsed.X)
+				&& algorithm::parseFloat(tail.substr(first + 1, second - first - 1), parsed.Y)
+				&& algorithm::parseFloat(tail.substr(second + 1), parsed.Z))
+				color = parsed;
+		}
+
+		// Load Materials from a .mtl file like LoadMaterials,
+		//	parsed straight out of a memory mapped file
+		bool LoadMaterialsMapped(const std::string& path)
+		{
+			// If the file is not a material file return false
+			if (path.size() < 4 || path.compare(path.size() - 4, 4, ".mtl") != 0)
 				return false;
-			// If so return true
-			else
-				return true;
+
+			materialFiles.push_back(path);
+
+			std::shared_ptr<const MaterialLibrary> library = MaterialLibraries::Get().Load(path, [&](std::vector<Material>& materials)
+			{
+				return parseMaterialsMapped(path, materials);
+			});
+			if (!library)
+				return false;
+			addMaterials(*library);
+			return true;
+		}
+
+		// Parse the materials of an .mtl file in place
+		static bool parseMaterialsMapped(const std::string& path, std::vector<Material>& materials)
+		{
+			MappedFile file;
+			if (!file.Open(path))
+				return false;
+
+			Material tempMaterial;
+
+			bool listening = false;
+
+			scan::ForEachLine(file.Data(), file.Data() + file.Size(), [&](const scan::Line& curline)
+			{
+				std::string_view key = curline.Key();
+
+				// new material and material name
+				if (key == "newmtl")
+				{
+					if (listening)
+					{
+						materials.push_back(tempMaterial);
+						tempMaterial = Material();
+					}
+					listening = true;
+
+					if (curline.Size() > 7)
+						tempMaterial.name = curline.Tail();
+					else
+						tempMaterial.name = "none";
+				}
+				else if (key == "Ka")
+				{
+					parseColor(curline.Tail(), tempMaterial.Ka);
+				}
+				else if (key == "Kd")
+				{
+					parseColor(curline.Tail(), tempMaterial.Kd);
+				}
+				else if (key == "Ks")
+				{
+					parseColor(curline.Tail(), tempMaterial.Ks);
+				}
+				else if (key == "Ns")
+				{
+					algorithm::parseFloat(curline.Tail(), tempMaterial.Ns);
+				}
+				else if (key == "Ni")
+				{
+					algorithm::parseFloat(curline.Tail(), tempMaterial.Ni);
+				}
+				else if (key == "d")
+				{
+					algorithm::parseFloat(curline.Tail(), tempMaterial.d);
+				}
+				else if (key == "illum")
+				{
+					algorithm::parseInt(curline.Tail(), tempMaterial.illum);
+				}
+				else if (key == "map_Ka")
+				{
+					tempMaterial.map_Ka = curline.Tail();
+				}
+				else if (key == "map_Kd")
+				{
+					tempMaterial.map_Kd = curline.Tail();
+				}
+				else if (key == "map_Ks")
+				{
+					tempMaterial.map_Ks = curline.Tail();
+				}
+				else if (key == "map_Ns")
+				{
+					tempMaterial.map_Ns = curline.Tail();
+				}
+				else if (key == "map_d")
+				{
+					tempMaterial.map_d = curline.Tail();
+				}
+				else if (key == "map_Bump" || key == "map_bump" || key == "bump")
+				{
+					tempMaterial.map_bump = curline.Tail();
+				}
+			});
+
+			// Deal with last material
+			materials.push_back(tempMaterial);
+
+			return true;
 		}
 	};
 }
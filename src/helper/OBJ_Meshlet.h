@@ -0,0 +1,424 @@
+// OBJ_Meshlet.h - Meshlets, Cluster Bounds and Cluster Culling for OBJ_Loader Meshes
+
+#pragma once
+
+// OBJ_Optimize.h - Adjacency, and OptimizeVertexCache to order triangles before they are clustered
+#include "helper/OBJ_Optimize.h"
+
+// Cmath - STD sqrt and tan for the bounds and the frustum
+#include <cmath>
+
+// Namespace: OBJL
+//
+// Description: The namespace that holds eveyrthing that
+//	is needed and used for the OBJ Model Loader
+namespace objl
+{
+	// Namespace: Meshlet
+	//
+	// Description: Splits a mesh into small clusters of triangles
+	//	for mesh shaders, each with its own short vertex list and
+	//	triangles indexing into it, laid out like the D3D12 MeshletDX
+	//	sample expects. Every meshlet gets a bounding sphere and a cone
+	//	holding its triangles' normals so whole meshlets can be culled
+	//	against the frustum and for facing away before any of their
+	//	triangles are looked at. Cull is the CPU version of that test
+	namespace meshlet
+	{
+		// Structure: Meshlet
+		//
+		// Description: One cluster, as runs of MeshletMesh::Vertices and MeshletMesh::Primitives
+		struct Meshlet
+		{
+			uint32_t VertexOffset = 0;
+			uint32_t VertexCount = 0;
+			uint32_t PrimitiveOffset = 0;
+			uint32_t PrimitiveCount = 0;
+		};
+
+		// Structure: Bounds
+		//
+		// Description: Where a meshlet is and which way its triangles face.
+		//	The meshlet faces away from every camera at position p for which
+		//	dot(ConeApex - p, ConeAxis) >= ConeCutoff * |ConeApex - p|, a
+		//	ConeCutoff of 1 with no axis means its triangles spread too far
+		//	to ever all face away
+		struct Bounds
+		{
+			Vector3 Center;
+			float Radius = 0.0f;
+			Vector3 ConeApex;
+			Vector3 ConeAxis;
+			float ConeCutoff = 1.0f;
+		};
+
+		// Structure: MeshletMesh
+		//
+		// Description: Meshlets of a mesh and the buffers a mesh shader reads them from
+		struct MeshletMesh
+		{
+			std::vector<Meshlet> Meshlets;
+			std::vector<Bounds> MeshletBounds;
+			// Indices into the mesh's vertices, each meshlet's own run of them
+			std::vector<uint32_t> Vertices;
+			// Three 10 bit indices into the meshlet's run of Vertices per triangle, first in the low bits
+			std::vector<uint32_t> Primitives;
+		};
+
+		// Pack a triangle's corners like the D3D12 MeshletDX sample does
+		inline uint32_t PackPrimitive(uint32_t a, uint32_t b, uint32_t c)
+		{
+			return (a & 0x3FF) | (b & 0x3FF) << 10 | (c & 0x3FF) << 20;
+		}
+
+		inline void UnpackPrimitive(uint32_t primitive, uint32_t* corners)
+		{
+			corners[0] = primitive & 0x3FF;
+			corners[1] = primitive >> 10 & 0x3FF;
+			corners[2] = primitive >> 20 & 0x3FF;
+		}
+
+		// Structure: Options
+		//
+		// Description: How big meshlets get and how hard they try to face one way
+		struct Options
+		{
+			// 64 and 124 suit the mesh shader limits of 256 outputs and 128 byte aligned primitive blocks
+			unsigned int MaxVertices = 64;
+			unsigned int MaxTriangles = 124;
+			// What turning away from the meshlet's normals costs next to one new vertex,
+			//	higher makes tighter cones and less full meshlets
+			float ConeWeight = 0.25f;
+			// Order triangles for the vertex cache before clustering them
+			bool OptimizeOrder = true;
+		};
+
+		// Ritter's bounding sphere, a little bigger than the smallest but never missing a point
+		inline void boundingSphere(const Vertex* vertices, const uint32_t* points, size_t count, Vector3& center, float& radius)
+		{
+			center = Vector3();
+			radius = 0.0f;
+			if (count == 0)
+				return;
+
+			// The pair of points furthest apart along any axis starts the sphere
+			size_t lowest[3] = { 0, 0, 0 }, highest[3] = { 0, 0, 0 };
+			for (size_t i = 0; i < count; i++)
+			{
+				const float* p = &vertices[points[i]].Position.X;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (p[axis] < (&vertices[points[lowest[axis]]].Position.X)[axis])
+						lowest[axis] = i;
+					if (p[axis] > (&vertices[points[highest[axis]]].Position.X)[axis])
+						highest[axis] = i;
+				}
+			}
+			int widest = 0;
+			float widestSpan = -1.0f;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				Vector3 span = vertices[points[highest[axis]]].Position - vertices[points[lowest[axis]]].Position;
+				float length = math::DotV3(span, span);
+				if (length > widestSpan)
+				{
+					widestSpan = length;
+					widest = axis;
+				}
+			}
+			const Vector3& a = vertices[points[lowest[widest]]].Position;
+			const Vector3& b = vertices[points[highest[widest]]].Position;
+			center = (a + b) * 0.5f;
+			radius = math::MagnitudeV3(b - a) * 0.5f;
+
+			// Grow it just enough to take in every point outside it
+			for (size_t i = 0; i < count; i++)
+			{
+				const Vector3& p = vertices[points[i]].Position;
+				float distance = math::MagnitudeV3(p - center);
+				if (distance > radius)
+				{
+					float grown = (radius + distance) * 0.5f;
+					center = center + (p - center) * ((grown - radius) / distance);
+					radius = grown;
+				}
+			}
+			// Rounding can leave a point a hair outside
+			radius *= 1.0f + 1e-5f;
+		}
+
+		// Sphere and normal cone of the triangles of one meshlet
+		inline Bounds ComputeBounds(const MeshletMesh& mesh, const Meshlet& meshlet, const Vertex* vertices)
+		{
+			Bounds bounds;
+			const uint32_t* meshletVertices = mesh.Vertices.data() + meshlet.VertexOffset;
+			boundingSphere(vertices, meshletVertices, meshlet.VertexCount, bounds.Center, bounds.Radius);
+			bounds.ConeApex = bounds.Center;
+
+			std::vector<Vector3> normals, centroids;
+			Vector3 sum;
+			for (uint32_t t = 0; t < meshlet.PrimitiveCount; t++)
+			{
+				uint32_t corners[3];
+				UnpackPrimitive(mesh.Primitives[meshlet.PrimitiveOffset + t], corners);
+				const Vector3& a = vertices[meshletVertices[corners[0]]].Position;
+				const Vector3& b = vertices[meshletVertices[corners[1]]].Position;
+				const Vector3& c = vertices[meshletVertices[corners[2]]].Position;
+				Vector3 normal = math::CrossV3(b - a, c - a);
+				float length = math::MagnitudeV3(normal);
+				if (length == 0.0f)
+					continue;
+				normals.push_back(normal / length);
+				centroids.push_back((a + b + c) / 3.0f);
+				sum = sum + normals.back();
+			}
+
+			float sumLength = math::MagnitudeV3(sum);
+			if (normals.empty() || sumLength == 0.0f)
+				return bounds;
+			Vector3 axis = sum / sumLength;
+
+			// The widest normal decides the cone, past about 84 degrees it would hardly ever cull
+			float lowestDot = 1.0f;
+			for (const Vector3& normal : normals)
+				lowestDot = std::min(lowestDot, math::DotV3(axis, normal));
+			if (lowestDot <= 0.1f)
+				return bounds;
+
+			// Back the apex off along the axis until it is behind every triangle's plane
+			float backOff = -std::numeric_limits<float>::infinity();
+			for (size_t i = 0; i < normals.size(); i++)
+				backOff = std::max(backOff, -math::DotV3(centroids[i] - bounds.Center, normals[i]) / math::DotV3(axis, normals[i]));
+
+			bounds.ConeApex = bounds.Center - axis * backOff;
+			bounds.ConeAxis = axis;
+			bounds.ConeCutoff = std::sqrt(1.0f - lowestDot * lowestDot);
+			return bounds;
+		}
+
+		// Cluster the triangles of indices into meshlets of at most MaxVertices
+		//	vertices and MaxTriangles triangles. A meshlet grows by the triangle next
+		//	to it that needs the fewest new vertices and turns least from its normals,
+		//	and starts over once nothing next to it fits
+		inline void BuildMeshlets(MeshletMesh& result, const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+			const Options& options = Options())
+		{
+			PROFILE_ZONE("objl::meshlet::BuildMeshlets");
+
+			result = MeshletMesh();
+			size_t triangleCount = indexCount / 3;
+			indexCount = triangleCount * 3;
+			if (triangleCount == 0)
+				return;
+			unsigned int maxVertices = std::clamp(options.MaxVertices, 3u, 256u);
+			unsigned int maxTriangles = std::clamp(options.MaxTriangles, 1u, 512u);
+
+			std::vector<unsigned int> ordered;
+			if (options.OptimizeOrder)
+			{
+				ordered.resize(indexCount);
+				optimize::OptimizeVertexCache(ordered.data(), indices, indexCount, vertexCount);
+				indices = ordered.data();
+			}
+
+			optimize::Adjacency adjacency;
+			optimize::buildAdjacency(adjacency, indices, indexCount, vertexCount);
+			std::vector<unsigned int> live(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+				live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+			std::vector<Vector3> normals(triangleCount);
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				const Vector3& a = vertices[indices[t * 3]].Position;
+				Vector3 normal = math::CrossV3(vertices[indices[t * 3 + 1]].Position - a, vertices[indices[t * 3 + 2]].Position - a);
+				float length = math::MagnitudeV3(normal);
+				normals[t] = length > 0 ? normal / length : Vector3();
+			}
+
+			std::vector<char> emitted(triangleCount, 0);
+			// Where each vertex is in the meshlet being built, UINT32_MAX if it isn't
+			std::vector<uint32_t> local(vertexCount, UINT32_MAX);
+			std::vector<unsigned int> candidates;
+			Meshlet current;
+			Vector3 normalSum;
+			size_t scan = 0;
+
+			auto finish = [&]()
+			{
+				if (current.PrimitiveCount == 0)
+					return;
+				for (uint32_t i = 0; i < current.VertexCount; i++)
+					local[result.Vertices[current.VertexOffset + i]] = UINT32_MAX;
+				result.Meshlets.push_back(current);
+				current = Meshlet();
+				current.VertexOffset = (uint32_t)result.Vertices.size();
+				current.PrimitiveOffset = (uint32_t)result.Primitives.size();
+				candidates.clear();
+				normalSum = Vector3();
+			};
+
+			auto extraVertices = [&](unsigned int t)
+			{
+				unsigned int extra = 0;
+				for (int corner = 0; corner < 3; corner++)
+					extra += local[indices[t * 3 + corner]] == UINT32_MAX;
+				return extra;
+			};
+
+			auto add = [&](unsigned int t)
+			{
+				uint32_t corners[3];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					unsigned int vertex = indices[t * 3 + corner];
+					if (local[vertex] == UINT32_MAX)
+					{
+						local[vertex] = current.VertexCount++;
+						result.Vertices.push_back(vertex);
+						for (unsigned int k = adjacency.offsets[vertex]; k < adjacency.offsets[vertex + 1]; k++)
+						{
+							if (!emitted[adjacency.triangles[k]])
+								candidates.push_back(adjacency.triangles[k]);
+						}
+					}
+					corners[corner] = local[vertex];
+					live[vertex]--;
+				}
+				result.Primitives.push_back(PackPrimitive(corners[0], corners[1], corners[2]));
+				current.PrimitiveCount++;
+				emitted[t] = 1;
+				normalSum = normalSum + normals[t];
+			};
+
+			size_t emittedCount = 0;
+			while (emittedCount < triangleCount)
+			{
+				// The best triangle next to the meshlet that still fits, dropping the ones already taken
+				Vector3 axis = normalSum;
+				float axisLength = math::MagnitudeV3(axis);
+				if (axisLength > 0)
+					axis = axis / axisLength;
+				long long best = -1;
+				float bestScore = 0.0f;
+				size_t kept = 0;
+				for (size_t i = 0; i < candidates.size(); i++)
+				{
+					unsigned int t = candidates[i];
+					if (emitted[t])
+						continue;
+					candidates[kept++] = t;
+
+					unsigned int extra = extraVertices(t);
+					if (current.VertexCount + extra > maxVertices)
+						continue;
+					// Finishing off a vertex's last triangles keeps it from being needed by another meshlet
+					float score = (float)extra + options.ConeWeight * (1.0f - math::DotV3(axis, normals[t]));
+					for (int corner = 0; corner < 3; corner++)
+						score -= live[indices[t * 3 + corner]] == 1 ? 0.1f : 0.0f;
+					if (best < 0 || score < bestScore)
+					{
+						best = t;
+						bestScore = score;
+					}
+				}
+				candidates.resize(kept);
+
+				if (best < 0)
+				{
+					// Nothing next to it fits, or nothing is next to it at all. Carry on with
+					//	the next triangle in order, in this meshlet if there is room
+					bool full = !candidates.empty();
+					while (emitted[scan])
+						scan++;
+					if (full || current.VertexCount + extraVertices((unsigned int)scan) > maxVertices)
+					{
+						finish();
+						continue;
+					}
+					best = (long long)scan;
+				}
+
+				add((unsigned int)best);
+				emittedCount++;
+				if (current.PrimitiveCount == maxTriangles)
+					finish();
+			}
+			finish();
+
+			result.MeshletBounds.reserve(result.Meshlets.size());
+			for (const Meshlet& meshlet : result.Meshlets)
+				result.MeshletBounds.push_back(ComputeBounds(result, meshlet, vertices));
+		}
+
+		// Build the meshlets of a mesh loaded by objl::Loader
+		inline MeshletMesh BuildMeshlets(const Mesh& mesh, const Options& options = Options())
+		{
+			MeshletMesh result;
+			BuildMeshlets(result, mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices.data(), mesh.Vertices.size(), options);
+			return result;
+		}
+
+		// Structure: Frustum
+		//
+		// Description: A camera's position and its six planes, normals pointing inside
+		struct Frustum
+		{
+			Vector3 Position;
+			Vector3 Normals[6];
+			float Distances[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		};
+
+		// A perspective camera at position looking at target, fovY in radians
+		inline Frustum MakeFrustum(const Vector3& position, const Vector3& target, const Vector3& up, float fovY, float aspect, float nearPlane, float farPlane)
+		{
+			Frustum frustum;
+			frustum.Position = position;
+			Vector3 forward = target - position;
+			forward = forward / math::MagnitudeV3(forward);
+			Vector3 right = math::CrossV3(forward, up);
+			right = right / math::MagnitudeV3(right);
+			Vector3 trueUp = math::CrossV3(right, forward);
+
+			float tanY = std::tan(fovY * 0.5f), tanX = tanY * aspect;
+			Vector3 normals[6] = { forward, forward * -1.0f, right + forward * tanX, forward * tanX - right,
+				trueUp + forward * tanY, forward * tanY - trueUp };
+			for (int plane = 0; plane < 6; plane++)
+			{
+				Vector3 normal = normals[plane] / math::MagnitudeV3(normals[plane]);
+				frustum.Normals[plane] = normal;
+				frustum.Distances[plane] = -math::DotV3(normal, position);
+			}
+			frustum.Distances[0] = -math::DotV3(forward, position + forward * nearPlane);
+			frustum.Distances[1] = math::DotV3(forward, position + forward * farPlane);
+			return frustum;
+		}
+
+		// Enum: CullResult
+		//
+		// Description: What Cull decided about a meshlet
+		enum class CullResult
+		{
+			Visible,
+			// Its sphere is outside a plane of the frustum
+			OutsideFrustum,
+			// Every one of its triangles faces away from the camera
+			FacingAway
+		};
+
+		// The test a mesh or amplification shader makes for each meshlet
+		inline CullResult Cull(const Bounds& bounds, const Frustum& frustum)
+		{
+			for (int plane = 0; plane < 6; plane++)
+			{
+				if (math::DotV3(frustum.Normals[plane], bounds.Center) + frustum.Distances[plane] < -bounds.Radius)
+					return CullResult::OutsideFrustum;
+			}
+
+			Vector3 view = bounds.ConeApex - frustum.Position;
+			if (math::DotV3(view, bounds.ConeAxis) >= bounds.ConeCutoff * math::MagnitudeV3(view))
+				return CullResult::FacingAway;
+			return CullResult::Visible;
+		}
+	}
+}
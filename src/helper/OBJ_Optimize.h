@@ -0,0 +1,693 @@
+// OBJ_Optimize.h - Vertex Cache, Overdraw and Vertex Fetch Optimization for OBJ_Loader Meshes
+
+#pragma once
+
+// OBJ_Loader.h - Vertex, Vector3 and Mesh
+#include "helper/OBJ_Loader.h"
+
+// Cmath - STD pow and sqrt for the cache scores
+#include <cmath>
+
+// Limits - STD infinity for the depth buffer
+#include <limits>
+
+// Namespace: OBJL
+//
+// Description: The namespace that holds eveyrthing that
+//	is needed and used for the OBJ Model Loader
+namespace objl
+{
+	// Namespace: Optimize
+	//
+	// Description: Reorders the triangles and vertices of a mesh
+	//	so the GPU transforms and fetches fewer vertices and shades
+	//	fewer hidden pixels, without changing what it looks like.
+	//	Triangles keep their corners in order, winding is untouched.
+	//	Every function takes indices into vertexCount vertices and
+	//	writes its output somewhere other than its input
+	namespace optimize
+	{
+		// Enum: CacheKind
+		//
+		// Description: How the simulated post transform cache replaces vertices
+		enum class CacheKind
+		{
+			// Oldest in goes first, what most hardware does
+			FIFO,
+			// Least recently used goes first
+			LRU
+		};
+
+		// Enum: VertexCacheAlgorithm
+		//
+		// Description: How OptimizeVertexCache orders triangles
+		enum class VertexCacheAlgorithm
+		{
+			// Sander et al., fans around vertices that are still in the cache,
+			//	linear time and tuned for the cache size it is given
+			Tipsify,
+			// Forsyth, greedily takes the best scored triangle next,
+			//	slower but doesn't need to know the cache size
+			Forsyth
+		};
+
+		// Structure: CacheStats
+		//
+		// Description: What a simulated post transform cache did with an index list
+		struct CacheStats
+		{
+			// Vertices that had to be transformed
+			size_t Transforms = 0;
+			// Average cache miss ratio, transforms per triangle, 3 at worst and about 0.5 at best
+			float ACMR = 0.0f;
+			// Average transform to vertex ratio, transforms per vertex used, 1 at best
+			float ATVR = 0.0f;
+		};
+
+		// Structure: FetchStats
+		//
+		// Description: What a simulated vertex fetch cache read for an index list
+		struct FetchStats
+		{
+			// Bytes read from memory, whole cache lines at a time
+			size_t BytesFetched = 0;
+			// Bytes read over the bytes of the vertices used, 1 at best
+			float Overfetch = 0.0f;
+		};
+
+		// Structure: OverdrawStats
+		//
+		// Description: What rasterizing a mesh from all six axis directions shaded
+		struct OverdrawStats
+		{
+			// Pixels the mesh covers
+			size_t Covered = 0;
+			// Pixels that passed the depth test, hidden ones included
+			size_t Shaded = 0;
+			// Shaded over covered, 1 at best
+			float Overdraw = 0.0f;
+		};
+
+		// Run an index list through a post transform cache of cacheSize vertices
+		inline CacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+			unsigned int cacheSize = 16, CacheKind kind = CacheKind::FIFO)
+		{
+			CacheStats stats;
+			std::vector<char> used(vertexCount, 0);
+			size_t usedCount = 0;
+
+			// FIFO, a vertex is still in the cache if fewer than cacheSize misses came after its own
+			std::vector<size_t> missedAt(vertexCount, 0);
+			size_t misses = 0;
+			// LRU, most recent first
+			std::vector<unsigned int> recent;
+
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				unsigned int vertex = indices[i];
+				if (!used[vertex])
+				{
+					used[vertex] = 1;
+					usedCount++;
+				}
+
+				if (kind == CacheKind::FIFO)
+				{
+					if (missedAt[vertex] == 0 || misses - missedAt[vertex] >= cacheSize)
+					{
+						missedAt[vertex] = ++misses;
+						stats.Transforms++;
+					}
+				}
+				else
+				{
+					auto found = std::find(recent.begin(), recent.end(), vertex);
+					if (found == recent.end())
+					{
+						stats.Transforms++;
+						recent.insert(recent.begin(), vertex);
+						if (recent.size() > cacheSize)
+							recent.pop_back();
+					}
+					else
+					{
+						std::rotate(recent.begin(), found, found + 1);
+					}
+				}
+			}
+
+			if (indexCount >= 3)
+				stats.ACMR = (float)stats.Transforms / (float)(indexCount / 3);
+			if (usedCount > 0)
+				stats.ATVR = (float)stats.Transforms / (float)usedCount;
+			return stats;
+		}
+
+		// Run the vertex reads of an index list through a direct mapped
+		//	cache of 64 byte lines, like the one in front of vertex fetch
+		inline FetchStats AnalyzeVertexFetch(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+			size_t vertexSize = sizeof(Vertex), size_t cacheBytes = 8 * 1024)
+		{
+			const size_t lineSize = 64;
+			size_t lineCount = cacheBytes / lineSize > 0 ? cacheBytes / lineSize : 1;
+			std::vector<size_t> lines(lineCount, SIZE_MAX);
+			std::vector<char> used(vertexCount, 0);
+			size_t usedCount = 0;
+
+			FetchStats stats;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				unsigned int vertex = indices[i];
+				if (!used[vertex])
+				{
+					used[vertex] = 1;
+					usedCount++;
+				}
+
+				size_t first = vertex * vertexSize / lineSize;
+				size_t last = (vertex * vertexSize + vertexSize - 1) / lineSize;
+				for (size_t line = first; line <= last; line++)
+				{
+					size_t& slot = lines[line % lineCount];
+					if (slot != line)
+					{
+						slot = line;
+						stats.BytesFetched += lineSize;
+					}
+				}
+			}
+
+			if (usedCount > 0)
+				stats.Overfetch = (float)stats.BytesFetched / (float)(usedCount * vertexSize);
+			return stats;
+		}
+
+		// Rasterize a mesh in order into a resolution square depth buffer from
+		//	each axis direction and count the pixels that get shaded against the
+		//	pixels that end up covered. Back faces are culled, fronts wind
+		//	counter clockwise like they do in an .obj. Triangles with an
+		//	index past vertexCount are left out
+		inline OverdrawStats AnalyzeOverdraw(const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+			unsigned int resolution = 256)
+		{
+			OverdrawStats stats;
+			if (indexCount < 3 || resolution == 0)
+				return stats;
+
+			const float infinity = std::numeric_limits<float>::infinity();
+			Vector3 low(infinity, infinity, infinity), high(-infinity, -infinity, -infinity);
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				if (indices[i] >= vertexCount)
+					continue;
+				const Vector3& p = vertices[indices[i]].Position;
+				low = Vector3(std::min(low.X, p.X), std::min(low.Y, p.Y), std::min(low.Z, p.Z));
+				high = Vector3(std::max(high.X, p.X), std::max(high.Y, p.Y), std::max(high.Z, p.Z));
+			}
+			if (low.X > high.X)
+				return stats;
+			float extent = std::max(high.X - low.X, std::max(high.Y - low.Y, high.Z - low.Z));
+			float scale = extent > 0 ? 1.0f / extent : 0.0f;
+
+			std::vector<float> depths(resolution * resolution);
+			for (int view = 0; view < 6; view++)
+			{
+				int axis = view / 2;
+				float sign = view % 2 == 0 ? 1.0f : -1.0f;
+				std::fill(depths.begin(), depths.end(), std::numeric_limits<float>::infinity());
+
+				// Screen x, y and depth of a position, all in [0, 1] before x and y are scaled up
+				auto project = [&](const Vector3& p, float* out)
+				{
+					const float* position = &p.X;
+					const float* origin = &low.X;
+					out[0] = (position[(axis + 1) % 3] - origin[(axis + 1) % 3]) * scale * resolution;
+					out[1] = (position[(axis + 2) % 3] - origin[(axis + 2) % 3]) * scale * resolution;
+					float depth = (position[axis] - origin[axis]) * scale;
+					out[2] = sign > 0 ? depth : 1.0f - depth;
+				};
+
+				for (size_t i = 0; i + 2 < indexCount; i += 3)
+				{
+					if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+						continue;
+					const Vector3& pa = vertices[indices[i]].Position;
+					const Vector3& pb = vertices[indices[i + 1]].Position;
+					const Vector3& pc = vertices[indices[i + 2]].Position;
+					Vector3 normal = math::CrossV3(pb - pa, pc - pa);
+					if ((&normal.X)[axis] * sign >= 0)
+						continue;
+
+					float a[3], b[3], c[3];
+					project(pa, a);
+					project(pb, b);
+					project(pc, c);
+
+					float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+					if (area == 0)
+						continue;
+					float facing = area > 0 ? 1.0f : -1.0f;
+
+					int minX = std::max(0, (int)std::floor(std::min(a[0], std::min(b[0], c[0]))));
+					int maxX = std::min((int)resolution - 1, (int)std::ceil(std::max(a[0], std::max(b[0], c[0]))));
+					int minY = std::max(0, (int)std::floor(std::min(a[1], std::min(b[1], c[1]))));
+					int maxY = std::min((int)resolution - 1, (int)std::ceil(std::max(a[1], std::max(b[1], c[1]))));
+
+					for (int y = minY; y <= maxY; y++)
+					{
+						float py = y + 0.5f;
+						for (int x = minX; x <= maxX; x++)
+						{
+							float px = x + 0.5f;
+							float wa = ((b[0] - px) * (c[1] - py) - (b[1] - py) * (c[0] - px)) * facing;
+							float wb = ((c[0] - px) * (a[1] - py) - (c[1] - py) * (a[0] - px)) * facing;
+							float wc = ((a[0] - px) * (b[1] - py) - (a[1] - py) * (b[0] - px)) * facing;
+							if (wa < 0 || wb < 0 || wc < 0)
+								continue;
+
+							float depth = (wa * a[2] + wb * b[2] + wc * c[2]) / (area * facing);
+							float& stored = depths[y * resolution + x];
+							if (depth < stored)
+							{
+								if (stored == std::numeric_limits<float>::infinity())
+									stats.Covered++;
+								stored = depth;
+								stats.Shaded++;
+							}
+						}
+					}
+				}
+			}
+
+			if (stats.Covered > 0)
+				stats.Overdraw = (float)stats.Shaded / (float)stats.Covered;
+			return stats;
+		}
+
+		// The triangles around each vertex, as offsets into one list
+		struct Adjacency
+		{
+			std::vector<unsigned int> offsets;
+			std::vector<unsigned int> triangles;
+		};
+
+		inline void buildAdjacency(Adjacency& adjacency, const unsigned int* indices, size_t indexCount, size_t vertexCount)
+		{
+			adjacency.offsets.assign(vertexCount + 1, 0);
+			for (size_t i = 0; i < indexCount; i++)
+				adjacency.offsets[indices[i] + 1]++;
+			for (size_t v = 0; v < vertexCount; v++)
+				adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+			adjacency.triangles.resize(indexCount);
+			std::vector<unsigned int> filled(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+			for (size_t i = 0; i < indexCount; i++)
+				adjacency.triangles[filled[indices[i]]++] = (unsigned int)(i / 3);
+		}
+
+		// Tipsify from "Fast Triangle Reordering for Vertex Locality
+		//	and Reduced Overdraw", Sander, Nehab and Barczak 2007
+		inline void tipsify(unsigned int* out, const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+		{
+			Adjacency adjacency;
+			buildAdjacency(adjacency, indices, indexCount, vertexCount);
+
+			// Triangles each vertex still has to go
+			std::vector<unsigned int> live(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+				live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+			std::vector<size_t> cachedAt(vertexCount, 0);
+			std::vector<char> emitted(indexCount / 3, 0);
+			std::vector<unsigned int> deadEnds;
+			std::vector<unsigned int> candidates;
+			size_t stamp = cacheSize + 1;
+			size_t cursor = 0;
+			size_t written = 0;
+
+			// Somewhere to start again once the fan runs out, the most recent
+			//	vertex with triangles left, or else the next one in order
+			auto skipDeadEnd = [&]() -> long long
+			{
+				while (!deadEnds.empty())
+				{
+					unsigned int vertex = deadEnds.back();
+					deadEnds.pop_back();
+					if (live[vertex] > 0)
+						return vertex;
+				}
+				while (cursor < vertexCount)
+				{
+					if (live[cursor] > 0)
+						return (long long)cursor++;
+					cursor++;
+				}
+				return -1;
+			};
+
+			long long fanning = skipDeadEnd();
+			while (fanning >= 0)
+			{
+				candidates.clear();
+				for (unsigned int a = adjacency.offsets[fanning]; a < adjacency.offsets[fanning + 1]; a++)
+				{
+					unsigned int triangle = adjacency.triangles[a];
+					if (emitted[triangle])
+						continue;
+					emitted[triangle] = 1;
+
+					for (int corner = 0; corner < 3; corner++)
+					{
+						unsigned int vertex = indices[triangle * 3 + corner];
+						out[written++] = vertex;
+						deadEnds.push_back(vertex);
+						candidates.push_back(vertex);
+						live[vertex]--;
+						if (stamp - cachedAt[vertex] > cacheSize)
+							cachedAt[vertex] = stamp++;
+					}
+				}
+
+				// Fan around the candidate that will still be in the cache
+				//	when its triangles are done, the oldest one of those
+				long long next = -1;
+				long long best = -1;
+				for (unsigned int vertex : candidates)
+				{
+					if (live[vertex] == 0)
+						continue;
+					long long priority = 0;
+					if (stamp - cachedAt[vertex] + 2 * live[vertex] <= cacheSize)
+						priority = (long long)(stamp - cachedAt[vertex]);
+					if (priority > best)
+					{
+						best = priority;
+						next = vertex;
+					}
+				}
+				fanning = next >= 0 ? next : skipDeadEnd();
+			}
+		}
+
+		// Score of a vertex at cachePosition (-1 if it isn't cached) with
+		//	remaining triangles to go, from Forsyth's "Linear-Speed Vertex
+		//	Cache Optimisation"
+		inline float forsythScore(int cachePosition, unsigned int remaining)
+		{
+			const int cacheSize = 32;
+			if (remaining == 0)
+				return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				// The last triangle's vertices score the same so it isn't just repeated in reverse
+				if (cachePosition < 3)
+					score = 0.75f;
+				else
+					score = std::pow(1.0f - (float)(cachePosition - 3) / (cacheSize - 3), 1.5f);
+			}
+			// Finish off vertices with few triangles left
+			return score + 2.0f / std::sqrt((float)remaining);
+		}
+
+		inline void forsyth(unsigned int* out, const unsigned int* indices, size_t indexCount, size_t vertexCount)
+		{
+			const int cacheSize = 32;
+			size_t triangleCount = indexCount / 3;
+
+			// A vertex's triangles still to go are the first remaining[v] of its adjacency
+			Adjacency adjacency;
+			buildAdjacency(adjacency, indices, indexCount, vertexCount);
+			std::vector<unsigned int> remaining(vertexCount);
+			std::vector<int> cachePosition(vertexCount, -1);
+			std::vector<float> vertexScores(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				remaining[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+				vertexScores[v] = forsythScore(-1, remaining[v]);
+			}
+
+			std::vector<float> triangleScores(triangleCount);
+			std::vector<char> emitted(triangleCount, 0);
+			long long best = -1;
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				if (best < 0 || triangleScores[t] > triangleScores[best])
+					best = (long long)t;
+			}
+
+			std::vector<unsigned int> cache, nextCache;
+			size_t cursor = 0;
+			size_t written = 0;
+			while (best >= 0)
+			{
+				const unsigned int* triangle = indices + best * 3;
+				emitted[best] = 1;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					unsigned int vertex = triangle[corner];
+					out[written++] = vertex;
+
+					// Swap it out of the triangles the vertex still has to go
+					unsigned int* begin = &adjacency.triangles[adjacency.offsets[vertex]];
+					unsigned int* end = begin + remaining[vertex];
+					unsigned int* found = std::find(begin, end, (unsigned int)best);
+					if (found != end)
+					{
+						std::swap(*found, *(end - 1));
+						remaining[vertex]--;
+					}
+				}
+
+				// The triangle goes to the front of the cache, pushing the rest back
+				nextCache.assign(triangle, triangle + 3);
+				for (unsigned int vertex : cache)
+				{
+					if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+						nextCache.push_back(vertex);
+				}
+
+				// Rescore everything in or just pushed out of the cache and their triangles
+				for (size_t i = 0; i < nextCache.size(); i++)
+				{
+					unsigned int vertex = nextCache[i];
+					int position = i < (size_t)cacheSize ? (int)i : -1;
+					cachePosition[vertex] = position;
+					float score = forsythScore(position, remaining[vertex]);
+					float change = score - vertexScores[vertex];
+					vertexScores[vertex] = score;
+					for (unsigned int a = 0; a < remaining[vertex]; a++)
+						triangleScores[adjacency.triangles[adjacency.offsets[vertex] + a]] += change;
+				}
+				if (nextCache.size() > (size_t)cacheSize)
+					nextCache.resize(cacheSize);
+				cache.swap(nextCache);
+
+				// The best triangle touching the cache, or else the next one not yet out
+				best = -1;
+				for (unsigned int vertex : cache)
+				{
+					for (unsigned int a = 0; a < remaining[vertex]; a++)
+					{
+						unsigned int t = adjacency.triangles[adjacency.offsets[vertex] + a];
+						if (best < 0 || triangleScores[t] > triangleScores[best])
+							best = t;
+					}
+				}
+				if (best < 0)
+				{
+					while (cursor < triangleCount && emitted[cursor])
+						cursor++;
+					if (cursor < triangleCount)
+						best = (long long)cursor;
+				}
+			}
+		}
+
+		// Reorder the triangles of an index list so their vertices are
+		//	transformed as few times as possible. out holds indexCount indices
+		inline void OptimizeVertexCache(unsigned int* out, const unsigned int* indices, size_t indexCount, size_t vertexCount,
+			VertexCacheAlgorithm algorithm = VertexCacheAlgorithm::Tipsify, unsigned int cacheSize = 16)
+		{
+			PROFILE_ZONE("objl::optimize::OptimizeVertexCache");
+
+			indexCount -= indexCount % 3;
+			if (algorithm == VertexCacheAlgorithm::Forsyth)
+				forsyth(out, indices, indexCount, vertexCount);
+			else
+				tipsify(out, indices, indexCount, vertexCount, cacheSize > 0 ? cacheSize : 1);
+		}
+
+		// Cut an index list that was ordered for the vertex cache into clusters
+		//	wherever the order jumps and the cluster so far, starting from an empty
+		//	cache, misses no more than threshold times it did in the list. Then draw
+		//	the clusters facing out from the middle of the mesh first so they hide
+		//	the ones behind them. out holds indexCount indices
+		inline void OptimizeOverdraw(unsigned int* out, const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+			unsigned int cacheSize = 16, float threshold = 1.05f)
+		{
+			PROFILE_ZONE("objl::optimize::OptimizeOverdraw");
+
+			size_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+				return;
+
+			// Misses of each triangle in a FIFO cache, the order jumps where a triangle misses twice or more
+			std::vector<unsigned char> misses(triangleCount, 0);
+			std::vector<size_t> missedAt(vertexCount, 0);
+			size_t missCount = 0;
+			for (size_t i = 0; i < triangleCount * 3; i++)
+			{
+				unsigned int vertex = indices[i];
+				if (missedAt[vertex] == 0 || missCount - missedAt[vertex] >= cacheSize)
+				{
+					missedAt[vertex] = ++missCount;
+					misses[i / 3]++;
+				}
+			}
+
+			struct Cluster
+			{
+				size_t begin;
+				size_t end;
+				float sortKey;
+			};
+			std::vector<Cluster> clusters;
+
+			// Run the cache again, emptied at the start of every cluster since the
+			//	clusters get drawn in a different order
+			std::fill(missedAt.begin(), missedAt.end(), 0);
+			size_t clusterBegin = 0, clusterMisses = 0, listMisses = 0, clusterStart = 0;
+			missCount = 0;
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				if (t > clusterBegin && misses[t] >= 2 && (float)clusterMisses <= threshold * (float)listMisses)
+				{
+					clusters.push_back({ clusterBegin, t, 0.0f });
+					clusterBegin = t;
+					clusterMisses = 0;
+					listMisses = 0;
+					clusterStart = missCount;
+				}
+				listMisses += misses[t];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					unsigned int vertex = indices[t * 3 + corner];
+					if (missedAt[vertex] <= clusterStart || missCount - missedAt[vertex] >= cacheSize)
+					{
+						missedAt[vertex] = ++missCount;
+						clusterMisses++;
+					}
+				}
+			}
+			clusters.push_back({ clusterBegin, triangleCount, 0.0f });
+
+			// Area weighted centroids and normals of the mesh and each cluster
+			Vector3 meshCentroid;
+			float meshArea = 0.0f;
+			std::vector<Vector3> centroids(clusters.size()), normals(clusters.size());
+			for (size_t c = 0; c < clusters.size(); c++)
+			{
+				float clusterArea = 0.0f;
+				for (size_t t = clusters[c].begin; t < clusters[c].end; t++)
+				{
+					const Vector3& a = vertices[indices[t * 3]].Position;
+					const Vector3& b = vertices[indices[t * 3 + 1]].Position;
+					const Vector3& d = vertices[indices[t * 3 + 2]].Position;
+					Vector3 normal = math::CrossV3(b - a, d - a);
+					float area = math::MagnitudeV3(normal);
+					Vector3 centroid = (a + b + d) / 3.0f;
+					centroids[c] = centroids[c] + centroid * area;
+					normals[c] = normals[c] + normal;
+					clusterArea += area;
+				}
+				meshCentroid = meshCentroid + centroids[c];
+				meshArea += clusterArea;
+				centroids[c] = clusterArea > 0 ? centroids[c] / clusterArea : vertices[indices[clusters[c].begin * 3]].Position;
+			}
+			if (meshArea > 0)
+				meshCentroid = meshCentroid / meshArea;
+
+			for (size_t c = 0; c < clusters.size(); c++)
+			{
+				float length = math::MagnitudeV3(normals[c]);
+				clusters[c].sortKey = length > 0 ? math::DotV3(centroids[c] - meshCentroid, normals[c]) / length : 0.0f;
+			}
+			std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+			size_t written = 0;
+			for (const Cluster& cluster : clusters)
+			{
+				std::copy(indices + cluster.begin * 3, indices + cluster.end * 3, out + written);
+				written += (cluster.end - cluster.begin) * 3;
+			}
+		}
+
+		// Renumber the vertices in the order the index list first uses them,
+		//	rewriting the indices in place. Unused vertices are dropped, out holds
+		//	up to vertexCount vertices. Returns how many vertices are left
+		inline size_t OptimizeVertexFetch(Vertex* out, unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount)
+		{
+			PROFILE_ZONE("objl::optimize::OptimizeVertexFetch");
+
+			std::vector<unsigned int> remap(vertexCount, UINT32_MAX);
+			unsigned int next = 0;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				unsigned int& vertex = remap[indices[i]];
+				if (vertex == UINT32_MAX)
+				{
+					vertex = next++;
+					out[vertex] = vertices[indices[i]];
+				}
+				indices[i] = vertex;
+			}
+			return next;
+		}
+
+		// Structure: Options
+		//
+		// Description: Which passes OptimizeMesh runs
+		struct Options
+		{
+			VertexCacheAlgorithm Algorithm = VertexCacheAlgorithm::Tipsify;
+			// Vertices in the post transform cache Tipsify and the overdraw pass plan for
+			unsigned int CacheSize = 16;
+			// Order clusters of triangles for overdraw after the vertex cache
+			bool Overdraw = true;
+			// How much worse than the whole mesh a cluster may miss the cache
+			float OverdrawThreshold = 1.05f;
+			// Renumber the vertices in the order they are drawn
+			bool VertexFetch = true;
+		};
+
+		// Run every pass in Options on a mesh loaded by objl::Loader
+		inline void OptimizeMesh(Mesh& mesh, const Options& options = Options())
+		{
+			if (mesh.Indices.size() < 3)
+				return;
+
+			std::vector<unsigned int> ordered(mesh.Indices.size() - mesh.Indices.size() % 3);
+			OptimizeVertexCache(ordered.data(), mesh.Indices.data(), ordered.size(), mesh.Vertices.size(), options.Algorithm, options.CacheSize);
+			if (options.Overdraw)
+			{
+				OptimizeOverdraw(mesh.Indices.data(), ordered.data(), ordered.size(), mesh.Vertices.data(), mesh.Vertices.size(),
+					options.CacheSize, options.OverdrawThreshold);
+				mesh.Indices.resize(ordered.size());
+			}
+			else
+			{
+				mesh.Indices.swap(ordered);
+			}
+
+			if (options.VertexFetch)
+			{
+				std::vector<Vertex> fetched(mesh.Vertices.size());
+				fetched.resize(OptimizeVertexFetch(fetched.data(), mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices.data(), mesh.Vertices.size()));
+				mesh.Vertices.swap(fetched);
+			}
+		}
+	}
+}
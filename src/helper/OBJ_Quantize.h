@@ -0,0 +1,567 @@
+// OBJ_Quantize.h - Packed Vertex Encoding for OBJ_Loader Meshes
+
+#pragma once
+
+// OBJ_Loader.h - Vertex, Mesh, scan::Level and the SIMD intrinsics
+#include "helper/OBJ_Loader.h"
+
+// Cmath - STD lrint, copysign and acos for the encoders and the error measurement
+#include <cmath>
+
+// The AVX2 encoder also converts halves with F16C
+#if defined(OBJL_X86) && !defined(_MSC_VER)
+#define OBJL_TARGET_F16C __attribute__((target("avx2,f16c")))
+#else
+#define OBJL_TARGET_F16C
+#endif
+
+// Namespace: OBJL
+//
+// Description: The namespace that holds eveyrthing that
+//	is needed and used for the OBJ Model Loader
+namespace objl
+{
+	// Namespace: Quantize
+	//
+	// Description: Packs the 32 byte float vertices of a mesh into
+	//	12 bytes each for upload. Positions become unorms inside the
+	//	mesh's bounding box, normals octahedral snorms and texture
+	//	coordinates half floats. Every encoder level writes exactly
+	//	the same bytes, the scalar one is the reference. Decode gives
+	//	back what a shader reading the packed vertices would see
+	namespace quantize
+	{
+		// Enum: Format
+		//
+		// Description: How the 8 bytes of position and normal are split
+		enum class Format
+		{
+			// 16 bit positions and 8 bit normals, for meshes that are big or seen up close
+			Position16,
+			// 10 bit positions and 16 bit normals, for small props and smooth shading
+			Position10
+		};
+
+		// Structure: PackedVertex
+		//
+		// Description: A vertex as the GPU reads it, little endian.
+		//	Position16 holds x and y as 16 bit unorms in PositionNormal[0],
+		//	z as a 16 bit unorm then the normal as two 8 bit snorms in
+		//	PositionNormal[1]. The input layout is R16G16B16A16_UNORM at 0
+		//	(w is the normal, ignore it) and R8G8_SNORM at 6.
+		//	Position10 holds x, y and z as 10:10:10:2 unorms in
+		//	PositionNormal[0] and the normal as two 16 bit snorms in
+		//	PositionNormal[1], R10G10B10A2_UNORM at 0 and R16G16_SNORM at 4.
+		//	Both have the texture coordinate as R16G16_FLOAT at 8
+		struct PackedVertex
+		{
+			uint32_t PositionNormal[2];
+			uint16_t TextureCoordinate[2];
+		};
+		static_assert(sizeof(PackedVertex) == 12, "PackedVertex is read by the GPU as 12 bytes");
+
+		// Structure: PackedMesh
+		//
+		// Description: A mesh with packed vertices. A position
+		//	decodes to Offset + unorm * Scale per axis
+		struct PackedMesh
+		{
+			// Mesh Name
+			std::string MeshName;
+			Format VertexFormat = Format::Position16;
+			// Minimum corner and size of the bounding box
+			Vector3 Offset;
+			Vector3 Scale;
+			// Packed Vertex List
+			std::vector<PackedVertex> Vertices;
+			// Index List, untouched
+			std::vector<unsigned int> Indices;
+			// Material, an index into Loader::LoadedMaterials or -1 for none
+			int MaterialIndex = -1;
+		};
+
+		// Largest unorm of a position axis
+		inline float positionMax(Format format)
+		{
+			return format == Format::Position16 ? 65535.0f : 1023.0f;
+		}
+
+		// Largest snorm of a normal component
+		inline float normalMax(Format format)
+		{
+			return format == Format::Position16 ? 127.0f : 32767.0f;
+		}
+
+		// Float to half, rounding to nearest even, overflowing to infinity
+		//	and keeping subnormals, like F16C does
+		inline uint16_t FloatToHalf(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, 4);
+			uint32_t sign = bits & 0x80000000u;
+			bits ^= sign;
+
+			uint32_t half;
+			if (bits >= (127u + 16u) << 23)
+			{
+				// Too big for a half, or infinity or NaN already
+				half = bits > 255u << 23 ? 0x7E00u : 0x7C00u;
+			}
+			else if (bits < 113u << 23)
+			{
+				// Subnormal or zero, let the float adder do the rounding
+				const uint32_t magicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+				float magic, shifted;
+				std::memcpy(&magic, &magicBits, 4);
+				std::memcpy(&shifted, &bits, 4);
+				shifted += magic;
+				std::memcpy(&half, &shifted, 4);
+				half -= magicBits;
+			}
+			else
+			{
+				// Rebias the exponent and round the 13 dropped mantissa bits
+				uint32_t odd = (bits >> 13) & 1;
+				half = (bits + ((uint32_t)(15 - 127) << 23) + 0xFFFu + odd) >> 13;
+			}
+			return (uint16_t)(half | sign >> 16);
+		}
+
+		inline float HalfToFloat(uint16_t half)
+		{
+			uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+			uint32_t exponent = (half >> 10) & 0x1F;
+			uint32_t mantissa = half & 0x3FF;
+			uint32_t bits;
+			if (exponent == 0x1F)
+				bits = sign | 0x7F800000u | mantissa << 13;
+			else if (exponent != 0)
+				bits = sign | (exponent + 112) << 23 | mantissa << 13;
+			else
+			{
+				float value = (float)mantissa * (1.0f / 16777216.0f);
+				return sign ? -value : value;
+			}
+			float value;
+			std::memcpy(&value, &bits, 4);
+			return value;
+		}
+
+		// Project a direction onto the octahedron and unfold it into [-1, 1]^2,
+		//	it doesn't need to be unit length. A zero normal goes to the middle
+		inline Vector2 EncodeOctahedral(const Vector3& normal)
+		{
+			float length = std::abs(normal.X) + std::abs(normal.Y) + std::abs(normal.Z);
+			if (length == 0.0f)
+				return Vector2();
+			float x = normal.X / length, y = normal.Y / length;
+			if (normal.Z < 0.0f)
+			{
+				float foldedX = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+				float foldedY = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+				x = foldedX;
+				y = foldedY;
+			}
+			return Vector2(x, y);
+		}
+
+		inline Vector3 DecodeOctahedral(float x, float y)
+		{
+			Vector3 normal(x, y, 1.0f - std::abs(x) - std::abs(y));
+			if (normal.Z < 0.0f)
+			{
+				normal.X = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+				normal.Y = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+			}
+			return normal / math::MagnitudeV3(normal);
+		}
+
+		// Bounding box of the positions as an offset and size
+		inline void ComputeBounds(const Vertex* vertices, size_t vertexCount, Vector3& offset, Vector3& scale)
+		{
+			offset = Vector3();
+			scale = Vector3();
+			if (vertexCount == 0)
+				return;
+			Vector3 lowest = vertices[0].Position, highest = vertices[0].Position;
+			for (size_t i = 1; i < vertexCount; i++)
+			{
+				const Vector3& p = vertices[i].Position;
+				lowest = Vector3(std::min(lowest.X, p.X), std::min(lowest.Y, p.Y), std::min(lowest.Z, p.Z));
+				highest = Vector3(std::max(highest.X, p.X), std::max(highest.Y, p.Y), std::max(highest.Z, p.Z));
+			}
+			offset = lowest;
+			scale = highest - lowest;
+		}
+
+		// What encoding multiplies a position by after taking the offset off, per axis
+		inline void positionFactors(Format format, const Vector3& scale, float* factors)
+		{
+			const float* size = &scale.X;
+			for (int axis = 0; axis < 3; axis++)
+				factors[axis] = size[axis] > 0.0f ? positionMax(format) / size[axis] : 0.0f;
+		}
+
+		// Pack the quantized parts of a vertex into its words
+		inline PackedVertex packVertex(Format format, const uint32_t* position, const int32_t* normal, const uint16_t* textureCoordinate)
+		{
+			PackedVertex packed;
+			if (format == Format::Position16)
+			{
+				packed.PositionNormal[0] = position[0] | position[1] << 16;
+				packed.PositionNormal[1] = position[2] | ((uint32_t)normal[0] & 0xFF) << 16 | ((uint32_t)normal[1] & 0xFF) << 24;
+			}
+			else
+			{
+				packed.PositionNormal[0] = position[0] | position[1] << 10 | position[2] << 20;
+				packed.PositionNormal[1] = ((uint32_t)normal[0] & 0xFFFF) | (uint32_t)normal[1] << 16;
+			}
+			packed.TextureCoordinate[0] = textureCoordinate[0];
+			packed.TextureCoordinate[1] = textureCoordinate[1];
+			return packed;
+		}
+
+		inline void encodeScalar(Format format, const Vertex* vertices, size_t vertexCount, const Vector3& offset,
+			const float* factors, PackedVertex* out)
+		{
+			const float maxPosition = positionMax(format), maxNormal = normalMax(format);
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				const Vertex& vertex = vertices[i];
+				const float* p = &vertex.Position.X;
+				const float* o = &offset.X;
+				uint32_t position[3];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					float scaled = (p[axis] - o[axis]) * factors[axis];
+					scaled = scaled < 0.0f ? 0.0f : scaled;
+					scaled = scaled > maxPosition ? maxPosition : scaled;
+					position[axis] = (uint32_t)std::lrint(scaled);
+				}
+
+				Vector2 octahedral = EncodeOctahedral(vertex.Normal);
+				int32_t normal[2] = { (int32_t)std::lrint(octahedral.X * maxNormal), (int32_t)std::lrint(octahedral.Y * maxNormal) };
+
+				uint16_t textureCoordinate[2] = { FloatToHalf(vertex.TextureCoordinate.X), FloatToHalf(vertex.TextureCoordinate.Y) };
+				out[i] = packVertex(format, position, normal, textureCoordinate);
+			}
+		}
+
+#ifdef OBJL_X86
+		// FloatToHalf four at a time
+		OBJL_TARGET_SSE2 inline __m128i floatToHalfSSE2(__m128 value)
+		{
+			const __m128i tooBig = _mm_set1_epi32((127 + 16) << 23);
+			const __m128i smallestNormal = _mm_set1_epi32(113 << 23);
+			const __m128i magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+			const __m128i rebias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+			__m128 sign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u)));
+			__m128 absolute = _mm_xor_ps(value, sign);
+			__m128i bits = _mm_castps_si128(absolute);
+
+			__m128i isNaN = _mm_cmpgt_epi32(bits, _mm_set1_epi32(255 << 23));
+			__m128i isRegular = _mm_cmpgt_epi32(tooBig, bits);
+			__m128i isSubnormal = _mm_cmpgt_epi32(smallestNormal, bits);
+			__m128i special = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+			__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(magic))), magic);
+			// Odd mantissas round up on a tie, the shift fills the lane with their low bit
+			__m128i odd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+			__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, rebias), odd), 13);
+
+			__m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+			__m128i half = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+			return _mm_or_si128(half, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+		}
+
+		// Four vertices at a time, read as four rows of eight floats and transposed to columns
+		OBJL_TARGET_SSE2 inline void encodeSSE2(Format format, const Vertex* vertices, size_t vertexCount, const Vector3& offset,
+			const float* factors, PackedVertex* out)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u));
+			const __m128 maxPosition = _mm_set1_ps(positionMax(format));
+			const __m128 maxNormal = _mm_set1_ps(normalMax(format));
+			const __m128 offsets[3] = { _mm_set1_ps(offset.X), _mm_set1_ps(offset.Y), _mm_set1_ps(offset.Z) };
+			const __m128 scales[3] = { _mm_set1_ps(factors[0]), _mm_set1_ps(factors[1]), _mm_set1_ps(factors[2]) };
+
+			size_t i = 0;
+			for (; i + 4 <= vertexCount; i += 4)
+			{
+				const float* row = &vertices[i].Position.X;
+				__m128 low0 = _mm_loadu_ps(row), high0 = _mm_loadu_ps(row + 4);
+				__m128 low1 = _mm_loadu_ps(row + 8), high1 = _mm_loadu_ps(row + 12);
+				__m128 low2 = _mm_loadu_ps(row + 16), high2 = _mm_loadu_ps(row + 20);
+				__m128 low3 = _mm_loadu_ps(row + 24), high3 = _mm_loadu_ps(row + 28);
+				_MM_TRANSPOSE4_PS(low0, low1, low2, low3);
+				_MM_TRANSPOSE4_PS(high0, high1, high2, high3);
+				// low0..3 are px, py, pz, nx and high0..3 ny, nz, u, v
+				__m128 columns[3] = { low0, low1, low2 };
+
+				__m128i position[3];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					__m128 scaled = _mm_mul_ps(_mm_sub_ps(columns[axis], offsets[axis]), scales[axis]);
+					scaled = _mm_min_ps(_mm_max_ps(scaled, zero), maxPosition);
+					position[axis] = _mm_cvtps_epi32(scaled);
+				}
+
+				__m128 nx = low3, ny = high0, nz = high1;
+				__m128 length = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, nx), _mm_andnot_ps(signMask, ny)), _mm_andnot_ps(signMask, nz));
+				__m128 nonZero = _mm_cmpneq_ps(length, zero);
+				__m128 x = _mm_and_ps(_mm_div_ps(nx, length), nonZero);
+				__m128 y = _mm_and_ps(_mm_div_ps(ny, length), nonZero);
+				__m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, y)), _mm_or_ps(_mm_and_ps(x, signMask), one));
+				__m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_or_ps(_mm_and_ps(y, signMask), one));
+				__m128 lower = _mm_and_ps(_mm_cmplt_ps(nz, zero), nonZero);
+				x = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, x));
+				y = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, y));
+				__m128i normalX = _mm_cvtps_epi32(_mm_mul_ps(x, maxNormal));
+				__m128i normalY = _mm_cvtps_epi32(_mm_mul_ps(y, maxNormal));
+
+				__m128i u = floatToHalfSSE2(high2), v = floatToHalfSSE2(high3);
+
+				alignas(16) uint32_t px[4], py[4], pz[4], hu[4], hv[4];
+				alignas(16) int32_t onx[4], ony[4];
+				_mm_store_si128((__m128i*)px, position[0]);
+				_mm_store_si128((__m128i*)py, position[1]);
+				_mm_store_si128((__m128i*)pz, position[2]);
+				_mm_store_si128((__m128i*)onx, normalX);
+				_mm_store_si128((__m128i*)ony, normalY);
+				_mm_store_si128((__m128i*)hu, u);
+				_mm_store_si128((__m128i*)hv, v);
+				for (int lane = 0; lane < 4; lane++)
+				{
+					uint32_t p[3] = { px[lane], py[lane], pz[lane] };
+					int32_t n[2] = { onx[lane], ony[lane] };
+					uint16_t t[2] = { (uint16_t)hu[lane], (uint16_t)hv[lane] };
+					out[i + lane] = packVertex(format, p, n, t);
+				}
+			}
+			encodeScalar(format, vertices + i, vertexCount - i, offset, factors, out + i);
+		}
+
+
+		// Eight vertices at a time with an 8x8 transpose, F16C converts the
+		//	halves, every CPU with AVX2 has it
+		OBJL_TARGET_F16C inline void encodeAVX2(Format format, const Vertex* vertices, size_t vertexCount, const Vector3& offset,
+			const float* factors, PackedVertex* out)
+		{
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000u));
+			const __m256 maxPosition = _mm256_set1_ps(positionMax(format));
+			const __m256 maxNormal = _mm256_set1_ps(normalMax(format));
+			const __m256 offsets[3] = { _mm256_set1_ps(offset.X), _mm256_set1_ps(offset.Y), _mm256_set1_ps(offset.Z) };
+			const __m256 scales[3] = { _mm256_set1_ps(factors[0]), _mm256_set1_ps(factors[1]), _mm256_set1_ps(factors[2]) };
+
+			size_t i = 0;
+			for (; i + 8 <= vertexCount; i += 8)
+			{
+				const float* row = &vertices[i].Position.X;
+				__m256 rows[8];
+				for (int r = 0; r < 8; r++)
+					rows[r] = _mm256_loadu_ps(row + r * 8);
+
+				__m256 pairs[8], quads[8], columns[8];
+				for (int r = 0; r < 8; r += 2)
+				{
+					pairs[r] = _mm256_unpacklo_ps(rows[r], rows[r + 1]);
+					pairs[r + 1] = _mm256_unpackhi_ps(rows[r], rows[r + 1]);
+				}
+				for (int r = 0; r < 8; r += 4)
+				{
+					quads[r] = _mm256_shuffle_ps(pairs[r], pairs[r + 2], _MM_SHUFFLE(1, 0, 1, 0));
+					quads[r + 1] = _mm256_shuffle_ps(pairs[r], pairs[r + 2], _MM_SHUFFLE(3, 2, 3, 2));
+					quads[r + 2] = _mm256_shuffle_ps(pairs[r + 1], pairs[r + 3], _MM_SHUFFLE(1, 0, 1, 0));
+					quads[r + 3] = _mm256_shuffle_ps(pairs[r + 1], pairs[r + 3], _MM_SHUFFLE(3, 2, 3, 2));
+				}
+				for (int c = 0; c < 4; c++)
+				{
+					columns[c] = _mm256_permute2f128_ps(quads[c], quads[c + 4], 0x20);
+					columns[c + 4] = _mm256_permute2f128_ps(quads[c], quads[c + 4], 0x31);
+				}
+				// columns are px, py, pz, nx, ny, nz, u and v
+
+				__m256i position[3];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					__m256 scaled = _mm256_mul_ps(_mm256_sub_ps(columns[axis], offsets[axis]), scales[axis]);
+					scaled = _mm256_min_ps(_mm256_max_ps(scaled, zero), maxPosition);
+					position[axis] = _mm256_cvtps_epi32(scaled);
+				}
+
+				__m256 nx = columns[3], ny = columns[4], nz = columns[5];
+				__m256 length = _mm256_add_ps(_mm256_add_ps(_mm256_andnot_ps(signMask, nx), _mm256_andnot_ps(signMask, ny)),
+					_mm256_andnot_ps(signMask, nz));
+				__m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_NEQ_UQ);
+				__m256 x = _mm256_and_ps(_mm256_div_ps(nx, length), nonZero);
+				__m256 y = _mm256_and_ps(_mm256_div_ps(ny, length), nonZero);
+				__m256 foldedX = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, y)), _mm256_or_ps(_mm256_and_ps(x, signMask), one));
+				__m256 foldedY = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, x)), _mm256_or_ps(_mm256_and_ps(y, signMask), one));
+				__m256 lower = _mm256_and_ps(_mm256_cmp_ps(nz, zero, _CMP_LT_OQ), nonZero);
+				x = _mm256_blendv_ps(x, foldedX, lower);
+				y = _mm256_blendv_ps(y, foldedY, lower);
+				__m256i normalX = _mm256_cvtps_epi32(_mm256_mul_ps(x, maxNormal));
+				__m256i normalY = _mm256_cvtps_epi32(_mm256_mul_ps(y, maxNormal));
+
+				__m128i u = _mm256_cvtps_ph(columns[6], _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+				__m128i v = _mm256_cvtps_ph(columns[7], _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+				// Both words of every vertex are built here, the lanes only get stored out
+				__m256i word0, word1;
+				if (format == Format::Position16)
+				{
+					word0 = _mm256_or_si256(position[0], _mm256_slli_epi32(position[1], 16));
+					word1 = _mm256_or_si256(_mm256_or_si256(position[2], _mm256_slli_epi32(_mm256_and_si256(normalX, _mm256_set1_epi32(0xFF)), 16)),
+						_mm256_slli_epi32(normalY, 24));
+				}
+				else
+				{
+					word0 = _mm256_or_si256(_mm256_or_si256(position[0], _mm256_slli_epi32(position[1], 10)), _mm256_slli_epi32(position[2], 20));
+					word1 = _mm256_or_si256(_mm256_and_si256(normalX, _mm256_set1_epi32(0xFFFF)), _mm256_slli_epi32(normalY, 16));
+				}
+				__m256i word2 = _mm256_or_si256(_mm256_cvtepu16_epi32(u), _mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
+
+				alignas(32) uint32_t words[3][8];
+				_mm256_store_si256((__m256i*)words[0], word0);
+				_mm256_store_si256((__m256i*)words[1], word1);
+				_mm256_store_si256((__m256i*)words[2], word2);
+				uint32_t* packed = (uint32_t*)(out + i);
+				for (int lane = 0; lane < 8; lane++)
+				{
+					packed[lane * 3] = words[0][lane];
+					packed[lane * 3 + 1] = words[1][lane];
+					packed[lane * 3 + 2] = words[2][lane];
+				}
+			}
+			encodeScalar(format, vertices + i, vertexCount - i, offset, factors, out + i);
+		}
+#endif
+
+		// Pack vertexCount vertices into out with the given encoder level,
+		//	positions relative to the box offset and scale
+		inline void Encode(scan::Level level, Format format, const Vertex* vertices, size_t vertexCount, const Vector3& offset,
+			const Vector3& scale, PackedVertex* out)
+		{
+			float factors[3];
+			positionFactors(format, scale, factors);
+#ifdef OBJL_X86
+			if (level == scan::Level::AVX2)
+				return encodeAVX2(format, vertices, vertexCount, offset, factors, out);
+			if (level == scan::Level::SSE2)
+				return encodeSSE2(format, vertices, vertexCount, offset, factors, out);
+#endif
+			encodeScalar(format, vertices, vertexCount, offset, factors, out);
+		}
+
+		// Pack a mesh loaded by objl::Loader in its own bounding box,
+		//	with the best encoder the CPU has
+		inline PackedMesh EncodeMesh(const Mesh& mesh, Format format = Format::Position16)
+		{
+			PackedMesh packed;
+			packed.MeshName = mesh.MeshName;
+			packed.VertexFormat = format;
+			packed.Indices = mesh.Indices;
+			packed.MaterialIndex = mesh.MaterialIndex;
+			ComputeBounds(mesh.Vertices.data(), mesh.Vertices.size(), packed.Offset, packed.Scale);
+			packed.Vertices.resize(mesh.Vertices.size());
+			Encode(scan::GetLevel(), format, mesh.Vertices.data(), mesh.Vertices.size(), packed.Offset, packed.Scale, packed.Vertices.data());
+			return packed;
+		}
+
+		// What the GPU reads from a packed vertex, normals come out unit length
+		inline Vertex Decode(const PackedMesh& mesh, const PackedVertex& packed)
+		{
+			uint32_t position[3];
+			int32_t normal[2];
+			if (mesh.VertexFormat == Format::Position16)
+			{
+				position[0] = packed.PositionNormal[0] & 0xFFFF;
+				position[1] = packed.PositionNormal[0] >> 16;
+				position[2] = packed.PositionNormal[1] & 0xFFFF;
+				normal[0] = (int8_t)(packed.PositionNormal[1] >> 16);
+				normal[1] = (int8_t)(packed.PositionNormal[1] >> 24);
+			}
+			else
+			{
+				position[0] = packed.PositionNormal[0] & 0x3FF;
+				position[1] = packed.PositionNormal[0] >> 10 & 0x3FF;
+				position[2] = packed.PositionNormal[0] >> 20 & 0x3FF;
+				normal[0] = (int16_t)packed.PositionNormal[1];
+				normal[1] = (int16_t)(packed.PositionNormal[1] >> 16);
+			}
+
+			Vertex vertex;
+			const float maxPosition = positionMax(mesh.VertexFormat), maxNormal = normalMax(mesh.VertexFormat);
+			const float* offset = &mesh.Offset.X;
+			const float* scale = &mesh.Scale.X;
+			float* p = &vertex.Position.X;
+			for (int axis = 0; axis < 3; axis++)
+				p[axis] = offset[axis] + position[axis] / maxPosition * scale[axis];
+			// Snorms read the most negative value as -1 too
+			vertex.Normal = DecodeOctahedral(std::max(normal[0] / maxNormal, -1.0f), std::max(normal[1] / maxNormal, -1.0f));
+			vertex.TextureCoordinate = Vector2(HalfToFloat(packed.TextureCoordinate[0]), HalfToFloat(packed.TextureCoordinate[1]));
+			return vertex;
+		}
+
+		// Unpack a whole mesh back into an objl::Mesh
+		inline Mesh DecodeMesh(const PackedMesh& packed)
+		{
+			Mesh mesh;
+			mesh.MeshName = packed.MeshName;
+			mesh.Indices = packed.Indices;
+			mesh.MaterialIndex = packed.MaterialIndex;
+			mesh.Vertices.reserve(packed.Vertices.size());
+			for (const PackedVertex& vertex : packed.Vertices)
+				mesh.Vertices.push_back(Decode(packed, vertex));
+			return mesh;
+		}
+
+		// Structure: Error
+		//
+		// Description: The most any vertex moved going through a packed mesh
+		struct Error
+		{
+			// Furthest any position axis moved, and half a step of the longest axis,
+			//	what rounding to the step alone can move it before float error
+			float Position = 0.0f;
+			float PositionBound = 0.0f;
+			// Largest angle between a normal and its decoded normal, in degrees.
+			//	Zero length normals aren't counted
+			float NormalDegrees = 0.0f;
+			// Furthest any texture coordinate moved
+			float TextureCoordinate = 0.0f;
+		};
+
+		// Decode every vertex of packed and compare it against the mesh it was packed from
+		inline Error MeasureError(const Mesh& mesh, const PackedMesh& packed)
+		{
+			Error error;
+			float longest = std::max(packed.Scale.X, std::max(packed.Scale.Y, packed.Scale.Z));
+			error.PositionBound = longest / positionMax(packed.VertexFormat) * 0.5f;
+
+			double worstCosine = 1.0;
+			size_t count = std::min(mesh.Vertices.size(), packed.Vertices.size());
+			for (size_t i = 0; i < count; i++)
+			{
+				const Vertex& original = mesh.Vertices[i];
+				Vertex decoded = Decode(packed, packed.Vertices[i]);
+
+				Vector3 moved = decoded.Position - original.Position;
+				error.Position = std::max(error.Position, std::max(std::abs(moved.X), std::max(std::abs(moved.Y), std::abs(moved.Z))));
+
+				float length = math::MagnitudeV3(original.Normal);
+				if (length > 0.0f)
+					worstCosine = std::min(worstCosine, (double)math::DotV3(original.Normal, decoded.Normal) / length);
+
+				Vector2 shifted = decoded.TextureCoordinate - original.TextureCoordinate;
+				error.TextureCoordinate = std::max(error.TextureCoordinate, std::max(std::abs(shifted.X), std::abs(shifted.Y)));
+			}
+			error.NormalDegrees = (float)(std::acos(std::max(-1.0, std::min(1.0, worstCosine))) * 180.0 / 3.14159265358979323846);
+			return error;
+		}
+	}
+}
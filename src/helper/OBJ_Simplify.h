@@ -0,0 +1,714 @@
+// OBJ_Simplify.h - Quadric Error Simplification and LOD Chains for OBJ_Loader Meshes
+
+#pragma once
+
+// OBJ_Optimize.h - Adjacency, and OptimizeVertexFetch to compact what a level keeps
+#include "helper/OBJ_Optimize.h"
+
+// Cmath - STD sqrt and fabs for the errors
+#include <cmath>
+
+// Cstddef - STD offsetof for the position in a Vertex
+#include <cstddef>
+
+// Cstring - STD memcpy for hashing positions
+#include <cstring>
+
+// Namespace: OBJL
+//
+// Description: The namespace that holds eveyrthing that
+//	is needed and used for the OBJ Model Loader
+namespace objl
+{
+	// Namespace: Simplify
+	//
+	// Description: Takes triangles out of a mesh by collapsing edges,
+	//	cheapest first by quadric error metrics that count how far the
+	//	surface moves and how far normals and texture coordinates do.
+	//	A collapse moves a vertex onto one of its neighbours, no new
+	//	vertices are ever made. Open borders only collapse along
+	//	themselves and normal or texture seams only along the seam,
+	//	both sides at once, so neither tears. Errors are distances
+	//	relative to the largest side of the mesh's bounds, 0.01 is 1%
+	namespace simplify
+	{
+		// Enum: VertexKind
+		//
+		// Description: Where a vertex sits, which decides where it may collapse to
+		enum class VertexKind : unsigned char
+		{
+			// Inside a surface, collapses onto any neighbour
+			Manifold,
+			// On an open edge, collapses along it
+			Border,
+			// One of the two vertices at a position split by a seam, collapses along the seam
+			Seam,
+			// Never moves, where borders and seams turn or meet and anything non manifold
+			Locked
+		};
+
+		// Structure: Quadric
+		//
+		// Description: Sum of weighted squared distances to planes, or to
+		//	attribute gradients, as a symmetric 4x4 matrix and its weight.
+		//	Doubles, the terms are far bigger than what is left once they cancel
+		struct Quadric
+		{
+			double A00 = 0.0, A11 = 0.0, A22 = 0.0;
+			double A10 = 0.0, A20 = 0.0, A21 = 0.0;
+			double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+			double C = 0.0;
+			double W = 0.0;
+		};
+
+		// Normal X, Y, Z and texture U, V
+		const int AttributeCount = 5;
+
+		// Squared distance to the plane a x + b y + c z + d = 0, times w, without the weight
+		inline void addPlane(Quadric& q, double a, double b, double c, double d, double w)
+		{
+			q.A00 += w * a * a;
+			q.A11 += w * b * b;
+			q.A22 += w * c * c;
+			q.A10 += w * a * b;
+			q.A20 += w * a * c;
+			q.A21 += w * b * c;
+			q.B0 += w * a * d;
+			q.B1 += w * b * d;
+			q.B2 += w * c * d;
+			q.C += w * d * d;
+		}
+
+		inline void addQuadric(Quadric& q, const Quadric& other)
+		{
+			q.A00 += other.A00;
+			q.A11 += other.A11;
+			q.A22 += other.A22;
+			q.A10 += other.A10;
+			q.A20 += other.A20;
+			q.A21 += other.A21;
+			q.B0 += other.B0;
+			q.B1 += other.B1;
+			q.B2 += other.B2;
+			q.C += other.C;
+			q.W += other.W;
+		}
+
+		inline double evaluate(const Quadric& q, const Vector3& p)
+		{
+			double rx = q.A00 * p.X + q.A10 * p.Y + q.A20 * p.Z + q.B0;
+			double ry = q.A10 * p.X + q.A11 * p.Y + q.A21 * p.Z + q.B1;
+			double rz = q.A20 * p.X + q.A21 * p.Y + q.A22 * p.Z + q.B2;
+			return rx * p.X + ry * p.Y + rz * p.Z + q.B0 * p.X + q.B1 * p.Y + q.B2 * p.Z + q.C;
+		}
+
+		// Point each vertex at the first one whose count floats from offset on
+		//	are equal, compared as floats so -0 and 0 are the same
+		inline void firstEqual(unsigned int* remap, const Vertex* vertices, size_t vertexCount, size_t offset, size_t count)
+		{
+			size_t tableSize = 1;
+			while (tableSize < vertexCount + vertexCount / 2)
+				tableSize *= 2;
+			std::vector<unsigned int> table(tableSize, UINT32_MAX);
+
+			auto floatsOf = [&](size_t v)
+			{
+				return reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(&vertices[v]) + offset);
+			};
+
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				const float* floats = floatsOf(v);
+				uint32_t h = 2166136261u;
+				for (size_t i = 0; i < count; i++)
+				{
+					uint32_t word = 0;
+					if (floats[i] != 0.0f)
+						std::memcpy(&word, &floats[i], 4);
+					h = (h ^ word) * 16777619u;
+					h ^= h >> 15;
+				}
+
+				for (size_t slot = h & (tableSize - 1); ; slot = (slot + 1) & (tableSize - 1))
+				{
+					unsigned int& entry = table[slot];
+					if (entry == UINT32_MAX)
+					{
+						entry = (unsigned int)v;
+						remap[v] = (unsigned int)v;
+						break;
+					}
+					if (std::equal(floats, floats + count, floatsOf(entry)))
+					{
+						remap[v] = entry;
+						break;
+					}
+				}
+			}
+		}
+
+		// Whether a triangle around a has the edge a to b, in that direction
+		inline bool hasEdge(const optimize::Adjacency& adjacency, const unsigned int* indices, unsigned int a, unsigned int b)
+		{
+			for (unsigned int k = adjacency.offsets[a]; k < adjacency.offsets[a + 1]; k++)
+			{
+				const unsigned int* corners = indices + adjacency.triangles[k] * 3;
+				if ((corners[0] == a && corners[1] == b) || (corners[1] == a && corners[2] == b) || (corners[2] == a && corners[0] == b))
+					return true;
+			}
+			return false;
+		}
+
+		// Order keys from smallest to largest, three passes of a radix sort over
+		//	the bits of non negative floats, which sort the same as the floats do
+		inline void sortByError(std::vector<unsigned int>& order, const std::vector<float>& errors, std::vector<unsigned int>& scratch)
+		{
+			order.resize(errors.size());
+			scratch.resize(errors.size());
+			for (unsigned int i = 0; i < order.size(); i++)
+				order[i] = i;
+
+			const int bits = 11;
+			std::vector<unsigned int> counts(1 << bits);
+			for (int shift = 0; shift < 32; shift += bits)
+			{
+				std::fill(counts.begin(), counts.end(), 0);
+				auto digit = [&](unsigned int i)
+				{
+					uint32_t key;
+					std::memcpy(&key, &errors[i], 4);
+					return (key >> shift) & ((1u << bits) - 1);
+				};
+				for (unsigned int i : order)
+					counts[digit(i)]++;
+				unsigned int sum = 0;
+				for (unsigned int& count : counts)
+				{
+					unsigned int start = sum;
+					sum += count;
+					count = start;
+				}
+				for (unsigned int i : order)
+					scratch[counts[digit(i)]++] = i;
+				order.swap(scratch);
+			}
+		}
+
+		// Structure: Options
+		//
+		// Description: How far Simplify goes and what it counts as error
+		struct Options
+		{
+			// Stop once the mesh is down to this many triangles, 0 to go as far as TargetError lets it
+			size_t TargetTriangles = 0;
+			// Never make a collapse that moves the surface further than this
+			float TargetError = 0.01f;
+			// How much moving normals and texture coordinates costs next to moving the surface
+			float NormalWeight = 0.5f;
+			float TextureWeight = 0.5f;
+			// Keep every vertex on an open edge where it is
+			bool LockBorders = false;
+		};
+
+		// Simplify the triangles of indices, writing what is left to out as
+		//	indices into the same vertices, equal vertices count as one.
+		//	out holds indexCount indices, the error the collapses made
+		//	goes to resultError. Returns how many indices are left
+		inline size_t Simplify(unsigned int* out, const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+			const Options& options = Options(), float* resultError = nullptr)
+		{
+			PROFILE_ZONE("objl::simplify::Simplify");
+
+			indexCount -= indexCount % 3;
+			if (resultError)
+				*resultError = 0.0f;
+			if (indexCount == 0)
+				return 0;
+
+			// One vertex for every set of equal ones, and a ring of the vertices at each position
+			std::vector<unsigned int> vertexRemap(vertexCount), positionRemap(vertexCount), wedge(vertexCount);
+			firstEqual(vertexRemap.data(), vertices, vertexCount, 0, sizeof(Vertex) / sizeof(float));
+			firstEqual(positionRemap.data(), vertices, vertexCount, offsetof(Vertex, Position), 3);
+			for (unsigned int v = 0; v < vertexCount; v++)
+			{
+				wedge[v] = v;
+				unsigned int first = positionRemap[v];
+				if (vertexRemap[v] == v && first != v)
+				{
+					wedge[v] = wedge[first];
+					wedge[first] = v;
+				}
+			}
+
+			for (size_t i = 0; i < indexCount; i++)
+				out[i] = vertexRemap[indices[i]];
+
+			optimize::Adjacency adjacency;
+			optimize::buildAdjacency(adjacency, out, indexCount, vertexCount);
+
+			auto hasPositionEdge = [&](unsigned int a, unsigned int b)
+			{
+				unsigned int x = a;
+				do
+				{
+					unsigned int y = b;
+					do
+					{
+						if (hasEdge(adjacency, out, x, y))
+							return true;
+						y = wedge[y];
+					} while (y != b);
+					x = wedge[x];
+				} while (x != a);
+				return false;
+			};
+
+			// Where every vertex sits, redone every pass since collapses take wedges
+			//	away. The open edges leaving and reaching every vertex, UINT32_MAX for
+			//	none and UINT32_MAX - 1 for more than one, whether they are open at
+			//	their positions too or a seam runs along them, and across which seam
+			const unsigned int none = UINT32_MAX, many = UINT32_MAX - 1;
+			std::vector<unsigned int> openOut(vertexCount), openIn(vertexCount), seamPair(vertexCount);
+			std::vector<char> seamEdges(vertexCount), borderEdges(vertexCount);
+			std::vector<VertexKind> kinds(vertexCount);
+			auto used = [&](unsigned int v)
+			{
+				return adjacency.offsets[v + 1] > adjacency.offsets[v];
+			};
+			auto classify = [&](size_t count)
+			{
+				std::fill(openOut.begin(), openOut.end(), none);
+				std::fill(openIn.begin(), openIn.end(), none);
+				std::fill(seamPair.begin(), seamPair.end(), none);
+				std::fill(seamEdges.begin(), seamEdges.end(), 0);
+				std::fill(borderEdges.begin(), borderEdges.end(), 0);
+				std::fill(kinds.begin(), kinds.end(), VertexKind::Locked);
+
+				for (size_t i = 0; i < count; i++)
+				{
+					unsigned int a = out[i], b = out[i % 3 == 2 ? i - 2 : i + 1];
+					if (hasEdge(adjacency, out, b, a))
+						continue;
+					openOut[a] = openOut[a] == none ? b : many;
+					openIn[b] = openIn[b] == none ? a : many;
+					std::vector<char>& edges = hasPositionEdge(b, a) ? seamEdges : borderEdges;
+					edges[a] = 1;
+					edges[b] = 1;
+				}
+
+				for (unsigned int v = 0; v < vertexCount; v++)
+				{
+					if (!used(v))
+						continue;
+					unsigned int other = none;
+					int wedges = 1;
+					for (unsigned int u = wedge[v]; u != v; u = wedge[u])
+					{
+						if (used(u))
+						{
+							other = u;
+							wedges++;
+						}
+					}
+
+					bool single = openOut[v] < many && openIn[v] < many;
+					if (wedges == 1)
+					{
+						// Seams that only end here don't hold it back, the triangles across them fold away
+						if (!borderEdges[v])
+							kinds[v] = VertexKind::Manifold;
+						else if (single && !seamEdges[v])
+							kinds[v] = options.LockBorders ? VertexKind::Locked : VertexKind::Border;
+					}
+					else if (wedges == 2 && single && openOut[other] < many && openIn[other] < many && !borderEdges[v] && !borderEdges[other])
+					{
+						// Both sides of the seam run the same way through the position
+						if (positionRemap[openOut[v]] == positionRemap[openIn[other]] && positionRemap[openOut[other]] == positionRemap[openIn[v]] &&
+							openOut[v] != openIn[other] && openOut[other] != openIn[v])
+						{
+							kinds[v] = VertexKind::Seam;
+							seamPair[v] = other;
+						}
+					}
+				}
+			};
+
+			// Positions scaled into the unit cube, so errors are relative to the mesh's size
+			Vector3 low = vertices[out[0]].Position, high = low;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				const Vector3& p = vertices[out[i]].Position;
+				low = Vector3(std::min(low.X, p.X), std::min(low.Y, p.Y), std::min(low.Z, p.Z));
+				high = Vector3(std::max(high.X, p.X), std::max(high.Y, p.Y), std::max(high.Z, p.Z));
+			}
+			float extent = std::max(high.X - low.X, std::max(high.Y - low.Y, high.Z - low.Z));
+			float scale = extent > 0 ? 1.0f / extent : 0.0f;
+
+			std::vector<Vector3> positions(vertexCount);
+			std::vector<float> attributes(vertexCount * AttributeCount);
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				const Vertex& vertex = vertices[v];
+				positions[v] = (vertex.Position - low) * scale;
+				float* attribute = &attributes[v * AttributeCount];
+				attribute[0] = vertex.Normal.X * options.NormalWeight;
+				attribute[1] = vertex.Normal.Y * options.NormalWeight;
+				attribute[2] = vertex.Normal.Z * options.NormalWeight;
+				attribute[3] = vertex.TextureCoordinate.X * options.TextureWeight;
+				attribute[4] = vertex.TextureCoordinate.Y * options.TextureWeight;
+			}
+			bool useAttributes = options.NormalWeight > 0 || options.TextureWeight > 0;
+
+			// Planes of the triangles around each position, and for each vertex
+			//	how far its attributes are from the gradients across its triangles
+			std::vector<Quadric> positionQuadrics(vertexCount), attributeQuadrics(vertexCount);
+			std::vector<double> gradients(vertexCount * AttributeCount * 4, 0.0);
+			for (size_t i = 0; i < indexCount; i += 3)
+			{
+				unsigned int corners[3] = { out[i], out[i + 1], out[i + 2] };
+				const Vector3& p0 = positions[corners[0]];
+				Vector3 p10 = positions[corners[1]] - p0, p20 = positions[corners[2]] - p0;
+				Vector3 normal = math::CrossV3(p10, p20);
+				float area = math::MagnitudeV3(normal);
+				if (area == 0.0f)
+					continue;
+				normal = normal / area;
+				float distance = -math::DotV3(normal, p0);
+				for (unsigned int corner : corners)
+				{
+					Quadric& q = positionQuadrics[positionRemap[corner]];
+					addPlane(q, normal.X, normal.Y, normal.Z, distance, area);
+					q.W += area;
+				}
+
+				// Edges that are open at this triangle keep a plane standing on them, borders ten times stronger than seams
+				for (int e = 0; e < 3; e++)
+				{
+					unsigned int a = corners[e], b = corners[(e + 1) % 3];
+					if (hasEdge(adjacency, out, b, a))
+						continue;
+					Vector3 edge = positions[b] - positions[a];
+					float length = math::MagnitudeV3(edge);
+					Vector3 side = math::CrossV3(edge, normal);
+					float sideLength = math::MagnitudeV3(side);
+					if (sideLength == 0.0f)
+						continue;
+					side = side / sideLength;
+					float weight = length * length * (hasPositionEdge(b, a) ? 1.0f : 10.0f);
+					float sideDistance = -math::DotV3(side, positions[a]);
+					for (unsigned int end : { a, b })
+					{
+						Quadric& q = positionQuadrics[positionRemap[end]];
+						addPlane(q, side.X, side.Y, side.Z, sideDistance, weight);
+						q.W += weight;
+					}
+				}
+
+				if (!useAttributes)
+					continue;
+
+				// Each attribute as g . p + d across the triangle
+				float d00 = math::DotV3(p10, p10), d01 = math::DotV3(p10, p20), d11 = math::DotV3(p20, p20);
+				float denominator = d00 * d11 - d01 * d01;
+				if (denominator == 0.0f)
+					continue;
+				Vector3 basis1 = (p10 * d11 - p20 * d01) / denominator;
+				Vector3 basis2 = (p20 * d00 - p10 * d01) / denominator;
+
+				Quadric triangle;
+				double triangleGradients[AttributeCount][4];
+				for (int k = 0; k < AttributeCount; k++)
+				{
+					float a0 = attributes[corners[0] * AttributeCount + k];
+					float a10 = attributes[corners[1] * AttributeCount + k] - a0;
+					float a20 = attributes[corners[2] * AttributeCount + k] - a0;
+					Vector3 g = basis1 * a10 + basis2 * a20;
+					float d = a0 - math::DotV3(g, p0);
+					addPlane(triangle, g.X, g.Y, g.Z, d, area);
+					triangleGradients[k][0] = (double)g.X * area;
+					triangleGradients[k][1] = (double)g.Y * area;
+					triangleGradients[k][2] = (double)g.Z * area;
+					triangleGradients[k][3] = (double)d * area;
+				}
+				triangle.W = area;
+
+				for (unsigned int corner : corners)
+				{
+					addQuadric(attributeQuadrics[corner], triangle);
+					double* gradient = &gradients[corner * AttributeCount * 4];
+					for (int k = 0; k < AttributeCount * 4; k++)
+						gradient[k] += triangleGradients[k / 4][k % 4];
+				}
+			}
+
+			// Error of giving vertex v the position and attributes of vertex t
+			auto attributeError = [&](unsigned int v, unsigned int t)
+			{
+				const Quadric& q = attributeQuadrics[v];
+				if (!useAttributes || q.W == 0.0)
+					return 0.0f;
+				const Vector3& p = positions[t];
+				double r = evaluate(q, p);
+				const double* gradient = &gradients[v * AttributeCount * 4];
+				for (int k = 0; k < AttributeCount; k++)
+				{
+					double a = attributes[t * AttributeCount + k];
+					const double* g = gradient + k * 4;
+					r += q.W * a * a - 2.0 * a * (g[0] * p.X + g[1] * p.Y + g[2] * p.Z + g[3]);
+				}
+				return (float)(std::fabs(r) / q.W);
+			};
+
+			auto openBetween = [&](unsigned int a, unsigned int b)
+			{
+				return hasEdge(adjacency, out, a, b) != hasEdge(adjacency, out, b, a);
+			};
+
+			// Error of collapsing v onto t, infinite if it may not, and the other side of a seam's target
+			auto collapseError = [&](unsigned int v, unsigned int t, unsigned int& sibling)
+			{
+				const float never = std::numeric_limits<float>::infinity();
+				sibling = none;
+				VertexKind kind = kinds[v], targetKind = kinds[t];
+				if (positionRemap[v] == positionRemap[t] || kind == VertexKind::Locked)
+					return never;
+				if (kind == VertexKind::Border && (targetKind == VertexKind::Manifold || !openBetween(v, t)))
+					return never;
+				if (kind == VertexKind::Seam)
+				{
+					if ((targetKind != VertexKind::Seam && targetKind != VertexKind::Locked) || !openBetween(v, t))
+						return never;
+					unsigned int u = t;
+					do
+					{
+						if (openBetween(seamPair[v], u))
+							sibling = u;
+						u = wedge[u];
+					} while (u != t);
+					if (sibling == none)
+						return never;
+				}
+
+				const Quadric& q = positionQuadrics[positionRemap[v]];
+				float error = q.W > 0 ? (float)(std::fabs(evaluate(q, positions[t])) / q.W) : 0.0f;
+				error += attributeError(v, t);
+				if (sibling != none)
+					error += attributeError(seamPair[v], sibling);
+				return error;
+			};
+
+			// Whether moving v onto t turns any of v's other triangles over, or nearly
+			auto flips = [&](unsigned int v, unsigned int t)
+			{
+				const Vector3& target = positions[t];
+				for (unsigned int k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++)
+				{
+					const unsigned int* corners = out + adjacency.triangles[k] * 3;
+					int at = corners[0] == v ? 0 : corners[1] == v ? 1 : 2;
+					unsigned int b = corners[(at + 1) % 3], c = corners[(at + 2) % 3];
+					if (positionRemap[b] == positionRemap[t] || positionRemap[c] == positionRemap[t])
+						continue;
+					Vector3 before = math::CrossV3(positions[b] - positions[v], positions[c] - positions[v]);
+					Vector3 after = math::CrossV3(positions[b] - target, positions[c] - target);
+					if (math::DotV3(before, after) < 0.25f * math::MagnitudeV3(before) * math::MagnitudeV3(after))
+						return true;
+				}
+				return false;
+			};
+
+			struct Collapse
+			{
+				unsigned int v;
+				unsigned int t;
+				unsigned int sibling;
+			};
+			std::vector<Collapse> collapses;
+			std::vector<float> errors;
+			std::vector<unsigned int> order, sortScratch;
+			std::vector<unsigned int> collapseRemap(vertexCount);
+			std::vector<char> collapseLocked(vertexCount);
+
+			size_t targetIndexCount = options.TargetTriangles * 3;
+			float errorLimit = options.TargetError * options.TargetError;
+			float worstError = 0.0f;
+			size_t resultCount = indexCount;
+			bool builtAdjacency = true;
+
+			// Every pass collapses the cheapest edges that don't touch each other, then starts again on what is left
+			while (resultCount > targetIndexCount)
+			{
+				if (!builtAdjacency)
+					optimize::buildAdjacency(adjacency, out, resultCount, vertexCount);
+				builtAdjacency = false;
+				classify(resultCount);
+
+				collapses.clear();
+				errors.clear();
+				for (size_t i = 0; i < resultCount; i++)
+				{
+					unsigned int a = out[i], b = out[i % 3 == 2 ? i - 2 : i + 1];
+					// Edges inside the surface come up twice, take them from one side
+					if (a > b && hasEdge(adjacency, out, b, a))
+						continue;
+
+					unsigned int siblingAB, siblingBA;
+					float errorAB = collapseError(a, b, siblingAB);
+					float errorBA = collapseError(b, a, siblingBA);
+					if (errorAB <= errorBA && errorAB <= errorLimit)
+					{
+						collapses.push_back({ a, b, siblingAB });
+						errors.push_back(errorAB);
+					}
+					else if (errorBA < errorAB && errorBA <= errorLimit)
+					{
+						collapses.push_back({ b, a, siblingBA });
+						errors.push_back(errorBA);
+					}
+				}
+				if (collapses.empty())
+					break;
+				sortByError(order, errors, sortScratch);
+
+				// Most collapses take two triangles with them, hold the pass to about what
+				//	the goal needs and not far past the error of the last one that gets there
+				size_t triangleGoal = (resultCount - targetIndexCount) / 3;
+				size_t edgeGoal = triangleGoal / 2;
+				float passLimit = errorLimit;
+				if (edgeGoal < collapses.size())
+					passLimit = std::min(errorLimit, errors[order[edgeGoal]] * 1.5f);
+
+				for (unsigned int v = 0; v < vertexCount; v++)
+					collapseRemap[v] = v;
+				std::fill(collapseLocked.begin(), collapseLocked.end(), 0);
+
+				size_t removed = 0, performed = 0;
+				for (unsigned int next : order)
+				{
+					const Collapse& collapse = collapses[next];
+					if (errors[next] > passLimit || removed >= triangleGoal)
+						break;
+					unsigned int from = positionRemap[collapse.v], to = positionRemap[collapse.t];
+					if (collapseLocked[from] || collapseLocked[to])
+						continue;
+					if (flips(collapse.v, collapse.t) || (collapse.sibling != none && flips(seamPair[collapse.v], collapse.sibling)))
+						continue;
+
+					collapseRemap[collapse.v] = collapse.t;
+					addQuadric(positionQuadrics[to], positionQuadrics[from]);
+					addQuadric(attributeQuadrics[collapse.t], attributeQuadrics[collapse.v]);
+					for (int k = 0; k < AttributeCount * 4; k++)
+						gradients[collapse.t * AttributeCount * 4 + k] += gradients[collapse.v * AttributeCount * 4 + k];
+					if (collapse.sibling != none)
+					{
+						unsigned int other = seamPair[collapse.v];
+						collapseRemap[other] = collapse.sibling;
+						addQuadric(attributeQuadrics[collapse.sibling], attributeQuadrics[other]);
+						for (int k = 0; k < AttributeCount * 4; k++)
+							gradients[collapse.sibling * AttributeCount * 4 + k] += gradients[other * AttributeCount * 4 + k];
+					}
+
+					collapseLocked[from] = 1;
+					collapseLocked[to] = 1;
+					removed += kinds[collapse.v] == VertexKind::Border ? 1 : 2;
+					worstError = std::max(worstError, errors[next]);
+					performed++;
+				}
+				if (performed == 0)
+					break;
+
+				// Move the collapsed corners and drop the triangles that folded flat
+				size_t written = 0;
+				for (size_t i = 0; i < resultCount; i += 3)
+				{
+					unsigned int a = collapseRemap[out[i]], b = collapseRemap[out[i + 1]], c = collapseRemap[out[i + 2]];
+					unsigned int pa = positionRemap[a], pb = positionRemap[b], pc = positionRemap[c];
+					if (pa == pb || pb == pc || pc == pa)
+						continue;
+					out[written++] = a;
+					out[written++] = b;
+					out[written++] = c;
+				}
+				resultCount = written;
+			}
+
+			if (resultError)
+				*resultError = std::sqrt(worstError);
+			return resultCount;
+		}
+
+		// Simplify a mesh loaded by objl::Loader into a new one holding only the vertices it still uses
+		inline Mesh SimplifyMesh(const Mesh& mesh, const Options& options = Options(), float* resultError = nullptr)
+		{
+			Mesh simplified;
+			simplified.MeshName = mesh.MeshName;
+			simplified.MeshMaterial = mesh.MeshMaterial;
+			simplified.MaterialIndex = mesh.MaterialIndex;
+
+			simplified.Indices.resize(mesh.Indices.size());
+			simplified.Indices.resize(Simplify(simplified.Indices.data(), mesh.Indices.data(), mesh.Indices.size(),
+				mesh.Vertices.data(), mesh.Vertices.size(), options, resultError));
+
+			simplified.Vertices.resize(mesh.Vertices.size());
+			simplified.Vertices.resize(optimize::OptimizeVertexFetch(simplified.Vertices.data(), simplified.Indices.data(),
+				simplified.Indices.size(), mesh.Vertices.data(), mesh.Vertices.size()));
+			return simplified;
+		}
+
+		// Structure: LodOptions
+		//
+		// Description: The levels GenerateLods makes
+		struct LodOptions
+		{
+			// Levels after the mesh itself
+			unsigned int Levels = 4;
+			// Triangles each level keeps of the one before it
+			float Ratio = 0.5f;
+			// Error no level goes past, counted from the mesh itself
+			float MaxError = 0.05f;
+			// Attribute weights and border locking for every level, the targets are set per level
+			Options Simplify;
+		};
+
+		// Structure: Lod
+		//
+		// Description: One level of detail and how far it may be from the original mesh
+		struct Lod
+		{
+			Mesh LodMesh;
+			// Sum of the errors of the levels up to this one
+			float Error = 0.0f;
+		};
+
+		// Simplify a mesh into a chain of levels, each from the one before so the
+		//	whole chain costs about as much as the first level. The chain stops early
+		//	once a level can't lose a tenth of its triangles within the error left
+		inline std::vector<Lod> GenerateLods(const Mesh& mesh, const LodOptions& options = LodOptions())
+		{
+			PROFILE_ZONE("objl::simplify::GenerateLods");
+
+			std::vector<Lod> lods;
+			const Mesh* previous = &mesh;
+			float error = 0.0f;
+			for (unsigned int level = 0; level < options.Levels; level++)
+			{
+				size_t triangles = previous->Indices.size() / 3;
+				Options levelOptions = options.Simplify;
+				levelOptions.TargetTriangles = (size_t)(triangles * options.Ratio);
+				levelOptions.TargetError = options.MaxError - error;
+				if (levelOptions.TargetError <= 0 || triangles == 0)
+					break;
+
+				Lod lod;
+				float levelError = 0.0f;
+				lod.LodMesh = SimplifyMesh(*previous, levelOptions, &levelError);
+				if (lod.LodMesh.Indices.size() / 3 > triangles - triangles / 10)
+					break;
+				error += levelError;
+				lod.Error = error;
+				lods.push_back(std::move(lod));
+				previous = &lods.back().LodMesh;
+			}
+			return lods;
+		}
+	}
+}
@@ -1,16 +1,293 @@
 #include "PrecompiledHeader.h"
-#include "core\GameEngine.h"
-#include "windows\WindowsSystem.h"
-#include "graphics\GraphcisSystem.h"
+#include "core/CompressBenchmark.h"
+#include "core/DispatchBenchmark.h"
+#include "core/FixedTimestepCheck.h"
+#include "core/FramePipeline.h"
+#include "core/GameEngine.h"
+#include "core/IndexWidthBenchmark.h"
+#include "core/JobSystemBenchmark.h"
+#include "core/MeshletBenchmark.h"
+#include "core/ObjLoaderBenchmark.h"
+#include "core/QuantizeBenchmark.h"
+#include "core/SimplifyBenchmark.h"
+#include "core/TriangulationBenchmark.h"
+#include "core/VertexCacheBenchmark.h"
 
+#ifdef _WIN32
+#include "windows/WindowsSystem.h"
+#include "graphics/GraphcisSystem.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Benchmarks make up a synthetic mesh of about bytes at path when there is nothing there
+static bool ensureBenchFile(const std::string& path, size_t bytes)
+{
+  return std::ifstream(path).is_open() || Core::WriteSyntheticObj(path, bytes);
+}
+
+// Every .obj in path in name order if it is a directory, else just path
+static std::vector<std::string> collectObjPaths(const std::string& path)
+{
+  std::vector<std::string> paths;
+  if (!std::filesystem::is_directory(path))
+  {
+    paths.push_back(path);
+    return paths;
+  }
+  for (const auto& entry : std::filesystem::directory_iterator(path))
+  {
+    if (entry.path().extension() == ".obj")
+      paths.push_back(entry.path().generic_string());
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+// Headless runs skip the window and graphics systems entirely.
+//   --frames N        frames to run (default 1000)
+//   --dt S            feed the loop a fixed simulated dt instead of the real clock
+//   --workers N       job system workers, 0 = one per spare hardware thread
+//   --synthetic N     add N CPU heavy stand in systems to simulate
+//   --pipeline MODE   publish frames to a stand in renderer, sync, double or triple
+//   --render-ms MS    CPU time the stand in renderer spends per frame (default 4)
+//   --pace FPS        hold frames to FPS with the frame pacer and print its statistics, flat out otherwise
+//   --pacing MODE     how the pacer waits, spin, sleep, hybrid (default) or timer
+//   --bench-jobs N    run the job system scaling benchmark up to N workers and exit
+//   --bench-dispatch  compare virtual and compile time system dispatch and exit
+//   --test-fixed-timestep  check the fixed step catch up against scripted clocks, exit code 1 on failure
+//   --bench-obj PATH  time every OBJ load mode (parallel on 1 to 32 threads, with and without welding)
+//                     on PATH and exit, every .obj in it if PATH is a directory,
+//                     writes a synthetic mesh there if it is missing and leaves its .objb cache
+//   --bench-obj-memory PATH  peak memory of loading PATH whole, pooled and streamed a mesh at a time and exit,
+//                     writes a 256 MB synthetic mesh there if it is missing
+//   --bench-obj-materials DIR  load every .obj in DIR parsing their .mtl each time and through the
+//                     material library cache and exit, writes 200 files sharing one .mtl there if it has none
+//   --bench-triangulate PATH  time the old and new face triangulation on the faces of PATH and exit,
+//                     writes synthetic n-gons there if it is missing
+//   --bench-vertex-cache PATH  reorder every mesh of PATH for the vertex cache and overdraw, simulate
+//                     the caches and overdraw before and after and exit, writes a synthetic mesh there if it is missing
+//   --bench-simplify PATH  build the LOD chain of every mesh of PATH and simplify each from scratch to every level,
+//                     report throughput and error and exit, writes a synthetic mesh there if it is missing
+//   --bench-meshlets PATH  split every mesh of PATH into meshlets, cull them from views around and near it
+//                     against culling each triangle and exit, writes a synthetic mesh there if it is missing
+//   --bench-quantize PATH  pack every mesh of PATH into 12 byte vertices in both formats with every encoder level,
+//                     report throughput and error and exit, writes a synthetic mesh there if it is missing
+//   --bench-compress PATH  encode the index and vertex buffers of every mesh of PATH, round trip them and compare
+//                     ratio and speed against a generic LZ77 coder and exit, writes a synthetic mesh there if it is missing
+//   --bench-index-width PATH  load PATH with 16 bit indices, splitting meshes too big for them, and compare the
+//                     index memory against 32 bit indices and exit, every .obj in it if PATH is a directory,
+//                     writes a synthetic mesh there if it is missing
+static int runHeadless(const std::vector<std::string>& args)
+{
+  Core::Engine* engine = Core::Engine::GetInstance();
+  Core::HeadlessOptions options;
+  unsigned int syntheticSystems = 0;
+  std::string pipeline;
+  double renderMilliseconds = 4.0;
+
+  for (size_t i = 0; i < args.size(); ++i)
+  {
+    bool hasValue = i + 1 < args.size();
+    if (args[i] == "--frames" && hasValue)
+      options.frameCount = (unsigned int)std::stoul(args[++i]);
+    else if (args[i] == "--dt" && hasValue)
+      options.simulatedDt = std::stod(args[++i]);
+    else if (args[i] == "--workers" && hasValue)
+      engine->SetWorkerCount((unsigned int)std::stoul(args[++i]));
+    else if (args[i] == "--synthetic" && hasValue)
+      syntheticSystems = (unsigned int)std::stoul(args[++i]);
+    else if (args[i] == "--pipeline" && hasValue)
+      pipeline = args[++i];
+    else if (args[i] == "--render-ms" && hasValue)
+      renderMilliseconds = std::stod(args[++i]);
+    else if (args[i] == "--pace" && hasValue)
+      options.pacedFps = std::stod(args[++i]);
+    else if (args[i] == "--pacing" && hasValue)
+    {
+      std::string strategy = args[++i];
+      if (strategy == "spin")
+        options.pacing = Core::PacingStrategy::Spin;
+      else if (strategy == "sleep")
+        options.pacing = Core::PacingStrategy::Sleep;
+      else if (strategy == "timer")
+        options.pacing = Core::PacingStrategy::Timer;
+      else
+        options.pacing = Core::PacingStrategy::Hybrid;
+    }
+    else if (args[i] == "--bench-dispatch")
+    {
+      Core::RunDispatchBenchmark(100000, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--test-fixed-timestep")
+    {
+      return Core::RunFixedTimestepChecks(&std::cout) == 0 ? 0 : 1;
+    }
+    else if (args[i] == "--bench-obj" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!std::filesystem::is_directory(path) && !ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      for (const std::string& file : collectObjPaths(path))
+        Core::RunObjLoadBenchmark(file, 3, 32, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-obj-memory" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 256 * 1024 * 1024))
+        return 1;
+      Core::RunObjMemoryBenchmark(path, 65536, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-obj-materials" && hasValue)
+    {
+      std::string directory = args[++i];
+      std::filesystem::create_directories(directory);
+      bool hasObj = false;
+      for (const auto& entry : std::filesystem::directory_iterator(directory))
+        hasObj = hasObj || entry.path().extension() == ".obj";
+      if (!hasObj && !Core::WriteSharedMaterialObjs(directory, 200, 256))
+        return 1;
+      Core::RunObjMaterialBenchmark(directory, 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-triangulate" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!std::ifstream(path).is_open() && !Core::WriteSyntheticNgonObj(path))
+        return 1;
+      Core::RunTriangulationBenchmark(path, 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-vertex-cache" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunVertexCacheBenchmark(path, 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-simplify" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunSimplifyBenchmark(path, 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-meshlets" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunMeshletBenchmark(path, 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-quantize" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunQuantizeBenchmark(path, 5, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-compress" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunCompressBenchmark(path, 10, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-index-width" && hasValue)
+    {
+      std::string path = args[++i];
+      if (!std::filesystem::is_directory(path) && !ensureBenchFile(path, 32 * 1024 * 1024))
+        return 1;
+      Core::RunIndexWidthBenchmark(collectObjPaths(path), 3, &std::cout);
+      return 0;
+    }
+    else if (args[i] == "--bench-jobs" && hasValue)
+    {
+      Core::RunJobScalingBenchmark((unsigned int)std::stoul(args[++i]), 100, &std::cout);
+      return 0;
+    }
+  }
+
+  std::vector<std::unique_ptr<Systems::SyntheticLoad>> loads;
+  for (unsigned int i = 0; i < syntheticSystems; ++i)
+  {
+    loads.push_back(std::make_unique<Systems::SyntheticLoad>(engine->GetJobSystem(), 1024, 64));
+    engine->AddSystem(loads.back().get());
+  }
+
+  Core::StandInRenderer renderer(renderMilliseconds / 1000.0);
+  if (!pipeline.empty())
+  {
+    Core::PipelineMode mode = Core::PipelineMode::DoubleBuffered;
+    if (pipeline == "sync")
+      mode = Core::PipelineMode::Synchronous;
+    else if (pipeline == "triple")
+      mode = Core::PipelineMode::TripleBuffered;
+    engine->SetRenderConsumer(&renderer, mode);
+  }
+
+  Core::HeadlessReport report = engine->RunHeadless(options);
+  report.Print(std::cout);
+  if (options.pacedFps > 0.0)
+    engine->GetFramePacer()->DumpStatistics(std::cout);
+  if (!pipeline.empty())
+    engine->GetPipeline()->GetStats().Print(std::cout);
+  return 0;
+}
+
+#ifdef _WIN32
 int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nCmdShow)
 {
+  std::vector<std::string> args;
+  for (int i = 1; i < __argc; ++i)
+  {
+    args.push_back(__argv[i]);
+  }
+
+  if (!args.empty() && args[0] == "--headless")
+  {
+    // We are a windows subsystem app, borrow the console we were started from for the report
+    if (AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+      FILE* stream;
+      freopen_s(&stream, "CONOUT$", "w", stdout);
+      freopen_s(&stream, "CONOUT$", "w", stderr);
+    }
+    return runHeadless(args);
+  }
+
   Core::Engine* engine = Core::Engine::GetInstance();
   Systems::Windows* windowsSystem = Systems::Windows::GetInstance();
   engine->AddSystem(windowsSystem);
   engine->AddSystem(Systems::Graphics::GetInstance());
+#ifdef PIPELINED_RENDERING
+  engine->SetRenderConsumer(Systems::Graphics::GetInstance(), Core::PipelineMode::TripleBuffered);
+#endif
 
   windowsSystem->SetMainParameters(hInstance, nCmdShow);
 
   engine->Start();
-}
\ No newline at end of file
+}
+#else
+// Without windows there is nothing to render to, always run headless
+int main(int argc, char** argv)
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+  return runHeadless(args);
+}
+#endif
@@ -97,7 +97,11 @@ LRESULT CALLBACK WndProc(_In_ HWND hWnd, _In_ UINT message, _In_ WPARAM wParam,
   switch (message)
   {
   case WM_PAINT:
+#ifdef PIPELINED_RENDERING
+    ValidateRect(hWnd, NULL);
+#else
     Systems::Graphics::GetInstance()->Render();
+#endif
     break;
   case WM_DESTROY:
     PostQuitMessage(0);
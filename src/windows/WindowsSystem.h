@@ -24,6 +24,7 @@ namespace Systems
     virtual void Update(float dt);
     virtual void FixedUpdate(float dt) {}
     virtual void Cleanup() {}
+    virtual const char* GetName() { return "Windows"; }
 
     void SetMainParameters(HINSTANCE hInstance, int nCmdShow);
     HINSTANCE GetInstanceHandle() { return instanceHandle; }